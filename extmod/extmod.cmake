@@ -17,6 +17,7 @@ set(MICROPY_SOURCE_EXTMOD
     ${MICROPY_EXTMOD_DIR}/modonewire.c
     ${MICROPY_EXTMOD_DIR}/moduasyncio.c
     ${MICROPY_EXTMOD_DIR}/modubinascii.c
+    ${MICROPY_EXTMOD_DIR}/modubuf.c
     ${MICROPY_EXTMOD_DIR}/moducryptolib.c
     ${MICROPY_EXTMOD_DIR}/moductypes.c
     ${MICROPY_EXTMOD_DIR}/moduhashlib.c
@@ -509,7 +509,7 @@ STATIC int read_mem(mp_obj_t self_in, uint16_t addr, uint32_t memaddr, uint8_t a
     size_t memaddr_len = fill_memaddr_buf(&memaddr_buf[0], memaddr, addrsize);
 
     int ret = mp_machine_i2c_writeto(self, addr, memaddr_buf, memaddr_len, false);
-    if (ret != memaddr_len) {
+    if (ret != (int)memaddr_len) {
         // must generate STOP
         mp_machine_i2c_writeto(self, addr, NULL, 0, true);
         return ret;
@@ -584,6 +584,73 @@ STATIC mp_obj_t machine_i2c_readfrom_mem_into(size_t n_args, const mp_obj_t *pos
 }
 MP_DEFINE_CONST_FUN_OBJ_KW(machine_i2c_readfrom_mem_into_obj, 1, machine_i2c_readfrom_mem_into);
 
+#if MICROPY_PY_MACHINE_I2C_MEM_BATCH
+// Run a batch of memory reads, each one a (addr, memaddr, nbytes) triple, and
+// store the results back to back in buf.  The ops can be given either as a
+// sequence of 3-tuples or as a buffer of 16-bit words, eg array('H').
+STATIC mp_obj_t machine_i2c_readfrom_mem_batch(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    enum { ARG_ops, ARG_buf, ARG_addrsize };
+    static const mp_arg_t allowed_args[] = {
+        { MP_QSTR_ops,      MP_ARG_REQUIRED | MP_ARG_OBJ, {.u_obj = MP_OBJ_NULL} },
+        { MP_QSTR_buf,      MP_ARG_REQUIRED | MP_ARG_OBJ, {.u_obj = MP_OBJ_NULL} },
+        { MP_QSTR_addrsize, MP_ARG_KW_ONLY | MP_ARG_INT, {.u_int = 8} },
+    };
+    mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
+    mp_arg_parse_all(n_args - 1, pos_args + 1, kw_args, MP_ARRAY_SIZE(allowed_args), allowed_args, args);
+
+    // get the buffer to store data into
+    mp_buffer_info_t bufinfo;
+    mp_get_buffer_raise(args[ARG_buf].u_obj, &bufinfo, MP_BUFFER_WRITE);
+    uint8_t *dest = bufinfo.buf;
+    uint8_t *dest_top = dest + bufinfo.len;
+
+    // get the operations, either as a descriptor buffer or a sequence
+    mp_buffer_info_t opsinfo;
+    size_t n_ops;
+    mp_obj_t *ops_items = NULL;
+    const uint8_t *ops_desc = NULL;
+    if (mp_get_buffer(args[ARG_ops].u_obj, &opsinfo, MP_BUFFER_READ)) {
+        ops_desc = opsinfo.buf;
+        n_ops = opsinfo.len / (3 * sizeof(uint16_t));
+    } else {
+        mp_obj_get_array(args[ARG_ops].u_obj, &n_ops, &ops_items);
+    }
+
+    for (size_t i = 0; i < n_ops; ++i) {
+        uint16_t addr;
+        uint32_t memaddr;
+        size_t len;
+        if (ops_desc != NULL) {
+            // the buffer may not be aligned
+            uint16_t op[3];
+            memcpy(op, ops_desc + i * sizeof(op), sizeof(op));
+            addr = op[0];
+            memaddr = op[1];
+            len = op[2];
+        } else {
+            mp_obj_t *op;
+            mp_obj_get_array_fixed_n(ops_items[i], 3, &op);
+            addr = mp_obj_get_int(op[0]);
+            memaddr = mp_obj_get_int(op[1]);
+            len = mp_obj_get_int(op[2]);
+        }
+        if (len > (size_t)(dest_top - dest)) {
+            mp_raise_ValueError(MP_ERROR_TEXT("buffer too small"));
+        }
+
+        // do the transfer
+        int ret = read_mem(pos_args[0], addr, memaddr, args[ARG_addrsize].u_int, dest, len);
+        if (ret < 0) {
+            mp_raise_OSError(-ret);
+        }
+        dest += len;
+    }
+
+    return MP_OBJ_NEW_SMALL_INT(dest - (uint8_t *)bufinfo.buf);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_KW(machine_i2c_readfrom_mem_batch_obj, 1, machine_i2c_readfrom_mem_batch);
+#endif
+
 STATIC mp_obj_t machine_i2c_writeto_mem(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
     enum { ARG_addr, ARG_memaddr, ARG_buf, ARG_addrsize };
     mp_arg_val_t args[MP_ARRAY_SIZE(machine_i2c_mem_allowed_args)];
@@ -624,6 +691,9 @@ STATIC const mp_rom_map_elem_t machine_i2c_locals_dict_table[] = {
     // memory operations
     { MP_ROM_QSTR(MP_QSTR_readfrom_mem), MP_ROM_PTR(&machine_i2c_readfrom_mem_obj) },
     { MP_ROM_QSTR(MP_QSTR_readfrom_mem_into), MP_ROM_PTR(&machine_i2c_readfrom_mem_into_obj) },
+    #if MICROPY_PY_MACHINE_I2C_MEM_BATCH
+    { MP_ROM_QSTR(MP_QSTR_readfrom_mem_batch), MP_ROM_PTR(&machine_i2c_readfrom_mem_batch_obj) },
+    #endif
     { MP_ROM_QSTR(MP_QSTR_writeto_mem), MP_ROM_PTR(&machine_i2c_writeto_mem_obj) },
 };
 MP_DEFINE_CONST_DICT(mp_machine_i2c_locals_dict, machine_i2c_locals_dict_table);
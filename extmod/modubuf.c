@@ -0,0 +1,348 @@
+/*
+ * This file is part of the MicroPython project, http://micropython.org/
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 agent
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <string.h>
+
+#include "py/runtime.h"
+#include "py/binary.h"
+
+#if MICROPY_PY_UBUF
+
+// Bulk operations on buffers.  The loops work a machine word at a time where
+// the buffers allow it, and otherwise fall back to a byte at a time.
+
+#define WORD_MASK (sizeof(mp_uint_t) - 1)
+
+STATIC void ubuf_get_dest_src(mp_obj_t dest_in, mp_obj_t src_in, mp_buffer_info_t *dest, mp_buffer_info_t *src) {
+    mp_get_buffer_raise(dest_in, dest, MP_BUFFER_WRITE);
+    mp_get_buffer_raise(src_in, src, MP_BUFFER_READ);
+    if (dest->len < src->len) {
+        mp_raise_ValueError(MP_ERROR_TEXT("destination too small"));
+    }
+}
+
+STATIC mp_obj_t ubuf_copy(mp_obj_t dest_in, mp_obj_t src_in) {
+    mp_buffer_info_t dest, src;
+    ubuf_get_dest_src(dest_in, src_in, &dest, &src);
+    // the C library's memmove is already tuned for the target and handles overlap
+    memmove(dest.buf, src.buf, src.len);
+    return mp_const_none;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_2(ubuf_copy_obj, ubuf_copy);
+
+STATIC mp_obj_t ubuf_fill(mp_obj_t buf_in, mp_obj_t value_in) {
+    mp_buffer_info_t bufinfo;
+    mp_get_buffer_raise(buf_in, &bufinfo, MP_BUFFER_WRITE);
+    memset(bufinfo.buf, mp_obj_get_int(value_in), bufinfo.len);
+    return mp_const_none;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_2(ubuf_fill_obj, ubuf_fill);
+
+// Defines a function that applies dest[i] op= src[i] to n bytes
+#define UBUF_DEFINE_BITOP(name, op) \
+    STATIC void name(byte *d, const byte *s, size_t n) { \
+        if ((((uintptr_t)d ^ (uintptr_t)s) & WORD_MASK) == 0) { \
+            for (; n > 0 && ((uintptr_t)d & WORD_MASK) != 0; --n) { \
+                *d++ op *s++; \
+            } \
+            for (; n >= sizeof(mp_uint_t); n -= sizeof(mp_uint_t)) { \
+                *(mp_uint_t *)d op *(const mp_uint_t *)s; \
+                d += sizeof(mp_uint_t); \
+                s += sizeof(mp_uint_t); \
+            } \
+        } \
+        for (; n > 0; --n) { \
+            *d++ op *s++; \
+        } \
+    }
+
+UBUF_DEFINE_BITOP(ubuf_xor_bytes, ^=)
+UBUF_DEFINE_BITOP(ubuf_and_bytes, &=)
+UBUF_DEFINE_BITOP(ubuf_or_bytes, |=)
+
+STATIC mp_obj_t ubuf_bitop(mp_obj_t dest_in, mp_obj_t src_in, void (*f)(byte *, const byte *, size_t)) {
+    mp_buffer_info_t dest, src;
+    ubuf_get_dest_src(dest_in, src_in, &dest, &src);
+    f(dest.buf, src.buf, src.len);
+    return mp_const_none;
+}
+
+STATIC mp_obj_t ubuf_xor(mp_obj_t dest_in, mp_obj_t src_in) {
+    return ubuf_bitop(dest_in, src_in, ubuf_xor_bytes);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_2(ubuf_xor_obj, ubuf_xor);
+
+STATIC mp_obj_t ubuf_and(mp_obj_t dest_in, mp_obj_t src_in) {
+    return ubuf_bitop(dest_in, src_in, ubuf_and_bytes);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_2(ubuf_and_obj, ubuf_and);
+
+STATIC mp_obj_t ubuf_or(mp_obj_t dest_in, mp_obj_t src_in) {
+    return ubuf_bitop(dest_in, src_in, ubuf_or_bytes);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_2(ubuf_or_obj, ubuf_or);
+
+STATIC mp_obj_t ubuf_bswap(mp_obj_t buf_in, size_t size) {
+    mp_buffer_info_t bufinfo;
+    mp_get_buffer_raise(buf_in, &bufinfo, MP_BUFFER_WRITE);
+    if (bufinfo.len & (size - 1)) {
+        mp_raise_ValueError(MP_ERROR_TEXT("length must be a multiple of item size"));
+    }
+    byte *p = bufinfo.buf;
+    byte *top = p + bufinfo.len;
+    if (size == 2) {
+        for (; p < top; p += 2) {
+            byte b = p[0];
+            p[0] = p[1];
+            p[1] = b;
+        }
+    } else {
+        for (; p < top; p += 4) {
+            // going via a word lets the compiler use a byte-reverse instruction
+            uint32_t w;
+            memcpy(&w, p, 4);
+            w = (w >> 24) | ((w >> 8) & 0xff00) | ((w & 0xff00) << 8) | (w << 24);
+            memcpy(p, &w, 4);
+        }
+    }
+    return mp_const_none;
+}
+
+STATIC mp_obj_t ubuf_bswap16(mp_obj_t buf_in) {
+    return ubuf_bswap(buf_in, 2);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(ubuf_bswap16_obj, ubuf_bswap16);
+
+STATIC mp_obj_t ubuf_bswap32(mp_obj_t buf_in) {
+    return ubuf_bswap(buf_in, 4);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(ubuf_bswap32_obj, ubuf_bswap32);
+
+STATIC mp_uint_t ubuf_popcount_word(mp_uint_t w) {
+    // count bits in parallel within each byte, then add up the bytes
+    const mp_uint_t m1 = (mp_uint_t)-1 / 3;
+    const mp_uint_t m2 = (mp_uint_t)-1 / 5;
+    const mp_uint_t m4 = (mp_uint_t)-1 / 17;
+    w -= (w >> 1) & m1;
+    w = (w & m2) + ((w >> 2) & m2);
+    w = (w + (w >> 4)) & m4;
+    return (w * ((mp_uint_t)-1 / 255)) >> ((sizeof(mp_uint_t) - 1) * 8);
+}
+
+STATIC mp_obj_t ubuf_popcount(mp_obj_t buf_in) {
+    mp_buffer_info_t bufinfo;
+    mp_get_buffer_raise(buf_in, &bufinfo, MP_BUFFER_READ);
+    const byte *p = bufinfo.buf;
+    size_t n = bufinfo.len;
+    mp_uint_t count = 0;
+    for (; n > 0 && ((uintptr_t)p & WORD_MASK) != 0; --n) {
+        count += ubuf_popcount_word(*p++);
+    }
+    for (; n >= sizeof(mp_uint_t); n -= sizeof(mp_uint_t)) {
+        count += ubuf_popcount_word(*(const mp_uint_t *)p);
+        p += sizeof(mp_uint_t);
+    }
+    for (; n > 0; --n) {
+        count += ubuf_popcount_word(*p++);
+    }
+    return mp_obj_new_int_from_uint(count);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(ubuf_popcount_obj, ubuf_popcount);
+
+enum {
+    UBUF_REDUCE_SUM,
+    UBUF_REDUCE_MIN,
+    UBUF_REDUCE_MAX,
+};
+
+// Reduces the n items of type T at p into acc, which has type A
+#define UBUF_REDUCE(T, A, p, n, op, acc) do { \
+        const T *items = (const T *)(p); \
+        size_t i = 0; \
+        if (op == UBUF_REDUCE_SUM) { \
+            for (; i < n; ++i) { \
+                acc += (A)items[i]; \
+            } \
+        } else { \
+            if (n == 0) { \
+                mp_raise_ValueError(MP_ERROR_TEXT("empty buffer")); \
+            } \
+            acc = (A)items[i++]; \
+            if (op == UBUF_REDUCE_MIN) { \
+                for (; i < n; ++i) { \
+                    if ((A)items[i] < acc) { \
+                        acc = (A)items[i]; \
+                    } \
+                } \
+            } else { \
+                for (; i < n; ++i) { \
+                    if ((A)items[i] > acc) { \
+                        acc = (A)items[i]; \
+                    } \
+                } \
+            } \
+        } \
+} while (0)
+
+STATIC mp_obj_t ubuf_reduce(mp_obj_t buf_in, int op) {
+    mp_buffer_info_t bufinfo;
+    mp_get_buffer_raise(buf_in, &bufinfo, MP_BUFFER_READ);
+    char typecode = bufinfo.typecode == BYTEARRAY_TYPECODE ? 'B' : bufinfo.typecode;
+    size_t n = bufinfo.len / mp_binary_get_size('@', typecode, NULL);
+    long long sacc = 0;
+    unsigned long long uacc = 0;
+    switch (typecode) {
+        case 'b':
+            UBUF_REDUCE(int8_t, long long, bufinfo.buf, n, op, sacc);
+            return mp_obj_new_int_from_ll(sacc);
+        case 'B':
+            UBUF_REDUCE(uint8_t, unsigned long long, bufinfo.buf, n, op, uacc);
+            return mp_obj_new_int_from_ull(uacc);
+        case 'h':
+            UBUF_REDUCE(int16_t, long long, bufinfo.buf, n, op, sacc);
+            return mp_obj_new_int_from_ll(sacc);
+        case 'H':
+            UBUF_REDUCE(uint16_t, unsigned long long, bufinfo.buf, n, op, uacc);
+            return mp_obj_new_int_from_ull(uacc);
+        case 'i':
+            UBUF_REDUCE(int, long long, bufinfo.buf, n, op, sacc);
+            return mp_obj_new_int_from_ll(sacc);
+        case 'I':
+            UBUF_REDUCE(unsigned int, unsigned long long, bufinfo.buf, n, op, uacc);
+            return mp_obj_new_int_from_ull(uacc);
+        case 'l':
+            UBUF_REDUCE(long, long long, bufinfo.buf, n, op, sacc);
+            return mp_obj_new_int_from_ll(sacc);
+        case 'L':
+            UBUF_REDUCE(unsigned long, unsigned long long, bufinfo.buf, n, op, uacc);
+            return mp_obj_new_int_from_ull(uacc);
+        case 'q':
+            UBUF_REDUCE(long long, long long, bufinfo.buf, n, op, sacc);
+            return mp_obj_new_int_from_ll(sacc);
+        case 'Q':
+            UBUF_REDUCE(unsigned long long, unsigned long long, bufinfo.buf, n, op, uacc);
+            return mp_obj_new_int_from_ull(uacc);
+        #if MICROPY_PY_BUILTINS_FLOAT
+        case 'f': {
+            mp_float_t facc = 0;
+            UBUF_REDUCE(float, mp_float_t, bufinfo.buf, n, op, facc);
+            return mp_obj_new_float(facc);
+        }
+        case 'd': {
+            mp_float_t facc = 0;
+            UBUF_REDUCE(double, mp_float_t, bufinfo.buf, n, op, facc);
+            return mp_obj_new_float(facc);
+        }
+        #endif
+        default:
+            mp_raise_TypeError(MP_ERROR_TEXT("unsupported buffer type"));
+    }
+}
+
+STATIC mp_obj_t ubuf_sum(mp_obj_t buf_in) {
+    return ubuf_reduce(buf_in, UBUF_REDUCE_SUM);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(ubuf_sum_obj, ubuf_sum);
+
+STATIC mp_obj_t ubuf_min(mp_obj_t buf_in) {
+    return ubuf_reduce(buf_in, UBUF_REDUCE_MIN);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(ubuf_min_obj, ubuf_min);
+
+STATIC mp_obj_t ubuf_max(mp_obj_t buf_in) {
+    return ubuf_reduce(buf_in, UBUF_REDUCE_MAX);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(ubuf_max_obj, ubuf_max);
+
+// The CRCs use 16-entry tables and process a nibble at a time, which keeps
+// the tables small while still being several times faster than bit-by-bit.
+
+STATIC mp_obj_t ubuf_crc16(size_t n_args, const mp_obj_t *args) {
+    // CRC-16 with the CCITT polynomial 0x1021, most significant bit first
+    static const uint16_t table[16] = {
+        0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50a5, 0x60c6, 0x70e7,
+        0x8108, 0x9129, 0xa14a, 0xb16b, 0xc18c, 0xd1ad, 0xe1ce, 0xf1ef,
+    };
+    mp_buffer_info_t bufinfo;
+    mp_get_buffer_raise(args[0], &bufinfo, MP_BUFFER_READ);
+    uint16_t crc = n_args > 1 ? mp_obj_get_int_truncated(args[1]) : 0;
+    const byte *p = bufinfo.buf;
+    for (size_t n = bufinfo.len; n > 0; --n) {
+        byte b = *p++;
+        crc = (crc << 4) ^ table[(crc >> 12) ^ (b >> 4)];
+        crc = (crc << 4) ^ table[(crc >> 12) ^ (b & 0xf)];
+    }
+    return MP_OBJ_NEW_SMALL_INT(crc);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(ubuf_crc16_obj, 1, 2, ubuf_crc16);
+
+STATIC mp_obj_t ubuf_crc32(size_t n_args, const mp_obj_t *args) {
+    // CRC-32 as used by zlib: reflected polynomial 0xedb88320
+    static const uint32_t table[16] = {
+        0x00000000, 0x1db71064, 0x3b6e20c8, 0x26d930ac,
+        0x76dc4190, 0x6b6b51f4, 0x4db26158, 0x5005713c,
+        0xedb88320, 0xf00f9344, 0xd6d6a3e8, 0xcb61b38c,
+        0x9b64c2b0, 0x86d3d2d4, 0xa00ae278, 0xbdbdf21c,
+    };
+    mp_buffer_info_t bufinfo;
+    mp_get_buffer_raise(args[0], &bufinfo, MP_BUFFER_READ);
+    uint32_t crc = n_args > 1 ? mp_obj_get_int_truncated(args[1]) : 0;
+    crc = ~crc;
+    const byte *p = bufinfo.buf;
+    for (size_t n = bufinfo.len; n > 0; --n) {
+        crc ^= *p++;
+        crc = (crc >> 4) ^ table[crc & 0xf];
+        crc = (crc >> 4) ^ table[crc & 0xf];
+    }
+    return mp_obj_new_int_from_uint(~crc);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(ubuf_crc32_obj, 1, 2, ubuf_crc32);
+
+STATIC const mp_rom_map_elem_t mp_module_ubuf_globals_table[] = {
+    { MP_ROM_QSTR(MP_QSTR___name__), MP_ROM_QSTR(MP_QSTR_ubuf) },
+    { MP_ROM_QSTR(MP_QSTR_copy), MP_ROM_PTR(&ubuf_copy_obj) },
+    { MP_ROM_QSTR(MP_QSTR_fill), MP_ROM_PTR(&ubuf_fill_obj) },
+    { MP_ROM_QSTR(MP_QSTR_xor), MP_ROM_PTR(&ubuf_xor_obj) },
+    { MP_ROM_QSTR(MP_QSTR_and_), MP_ROM_PTR(&ubuf_and_obj) },
+    { MP_ROM_QSTR(MP_QSTR_or_), MP_ROM_PTR(&ubuf_or_obj) },
+    { MP_ROM_QSTR(MP_QSTR_bswap16), MP_ROM_PTR(&ubuf_bswap16_obj) },
+    { MP_ROM_QSTR(MP_QSTR_bswap32), MP_ROM_PTR(&ubuf_bswap32_obj) },
+    { MP_ROM_QSTR(MP_QSTR_popcount), MP_ROM_PTR(&ubuf_popcount_obj) },
+    { MP_ROM_QSTR(MP_QSTR_sum), MP_ROM_PTR(&ubuf_sum_obj) },
+    { MP_ROM_QSTR(MP_QSTR_min), MP_ROM_PTR(&ubuf_min_obj) },
+    { MP_ROM_QSTR(MP_QSTR_max), MP_ROM_PTR(&ubuf_max_obj) },
+    { MP_ROM_QSTR(MP_QSTR_crc16), MP_ROM_PTR(&ubuf_crc16_obj) },
+    { MP_ROM_QSTR(MP_QSTR_crc32), MP_ROM_PTR(&ubuf_crc32_obj) },
+};
+
+STATIC MP_DEFINE_CONST_DICT(mp_module_ubuf_globals, mp_module_ubuf_globals_table);
+
+const mp_obj_module_t mp_module_ubuf = {
+    .base = { &mp_type_module },
+    .globals = (mp_obj_dict_t *)&mp_module_ubuf_globals,
+};
+
+#endif // MICROPY_PY_UBUF
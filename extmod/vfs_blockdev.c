@@ -28,6 +28,7 @@
 #include "py/binary.h"
 #include "py/objarray.h"
 #include "py/mperrno.h"
+#include "py/stream.h"
 #include "extmod/vfs.h"
 
 #if MICROPY_VFS
@@ -140,4 +141,49 @@ mp_obj_t mp_vfs_blockdev_ioctl(mp_vfs_blockdev_t *self, uintptr_t cmd, uintptr_t
     }
 }
 
+// Returns the address at which the given block is memory mapped, or NULL if the
+// device does not support direct access.  A device that returns an address must
+// map consecutive blocks to consecutive addresses.  The address is dereferenced
+// without any checks, so it is only trusted if the ioctl method is implemented
+// in C; an address returned by a block device written in Python is ignored.
+const uint8_t *mp_vfs_blockdev_addr(mp_vfs_blockdev_t *self, size_t block_num) {
+    if (!(self->flags & MP_BLOCKDEV_FLAG_HAVE_IOCTL)) {
+        return NULL;
+    }
+    if (!mp_obj_is_type(self->u.ioctl[0], &mp_type_fun_builtin_3)
+        && !mp_obj_is_type(self->u.ioctl[0], &mp_type_fun_builtin_var)) {
+        return NULL;
+    }
+    mp_obj_t ret = mp_vfs_blockdev_ioctl(self, MP_BLOCKDEV_IOCTL_BLOCK_ADDR, block_num);
+    if (!mp_obj_is_int(ret)) {
+        return NULL;
+    }
+    return (const uint8_t *)(uintptr_t)mp_obj_int_get_truncated(ret);
+}
+
+#if MICROPY_VFS_READVIEW
+// Common tail of the readview() method of filesystem file objects.  If addr is
+// non-NULL then the filesystem has already advanced the file position past len
+// bytes of contiguous memory-mapped data at addr, and a read-only memoryview of
+// that data is returned.  Otherwise the data is fragmented and, if copy is true,
+// it is read from the (unchanged) file position into a new bytes object.
+mp_obj_t mp_vfs_blockdev_readview(mp_obj_t file, const uint8_t *addr, size_t len, bool copy) {
+    if (addr != NULL || len == 0) {
+        return mp_obj_new_memoryview(BYTEARRAY_TYPECODE, len, (void *)addr);
+    }
+    if (!copy) {
+        mp_raise_OSError(MP_EOPNOTSUPP);
+    }
+    vstr_t vstr;
+    vstr_init_len(&vstr, len);
+    int errcode;
+    vstr.len = mp_stream_read_exactly(file, vstr.buf, len, &errcode);
+    if (errcode != 0) {
+        vstr_clear(&vstr);
+        mp_raise_OSError(errcode);
+    }
+    return mp_obj_new_str_from_vstr(&mp_type_bytes, &vstr);
+}
+#endif
+
 #endif // MICROPY_VFS
@@ -151,6 +151,85 @@ STATIC mp_uint_t file_obj_ioctl(mp_obj_t o_in, mp_uint_t request, uintptr_t arg,
     }
 }
 
+#if MICROPY_VFS_READVIEW
+
+#if FF_MAX_SS == FF_MIN_SS
+#define SECSIZE(fs) (FF_MIN_SS)
+#else
+#define SECSIZE(fs) ((fs)->ssize)
+#endif
+
+// Returns the memory-mapped address of the next len bytes of the file, or NULL if
+// they are not in a run of consecutive clusters on a memory-mapped block device.
+// The file position is left unchanged.
+STATIC const uint8_t *file_obj_map(FIL *fp, FSIZE_t len) {
+    FATFS *fs = fp->obj.fs;
+    FSIZE_t pos = f_tell(fp);
+    DWORD bcs = (DWORD)fs->csize * SECSIZE(fs);
+    const uint8_t *addr = NULL;
+
+    // Seeking to just past a byte leaves fp->clust at the cluster holding that byte.
+    if (f_lseek(fp, pos + 1) == FR_OK) {
+        DWORD clst = fp->clust;
+        DWORD sect = fs->database + (clst - 2) * fs->csize + (pos % bcs) / SECSIZE(fs);
+        FSIZE_t next = pos - pos % bcs + bcs;
+        for (; next < pos + len; next += bcs) {
+            if (f_lseek(fp, next + 1) != FR_OK || fp->clust != ++clst) {
+                break;
+            }
+        }
+        if (next >= pos + len) {
+            addr = mp_vfs_blockdev_addr(&((fs_user_mount_t *)fs->drv)->blockdev, sect);
+            if (addr != NULL) {
+                addr += pos % SECSIZE(fs);
+            }
+        }
+    }
+
+    f_lseek(fp, pos);
+    return addr;
+}
+
+STATIC mp_obj_t file_obj_readview(size_t n_args, const mp_obj_t *args) {
+    pyb_file_obj_t *self = MP_OBJ_TO_PTR(args[0]);
+    FIL *fp = &self->fp;
+    if (fp->obj.fs == NULL) {
+        mp_raise_ValueError(NULL);
+    }
+    if (!(fp->flag & FA_READ)) {
+        mp_raise_OSError(MP_EACCES);
+    }
+    if (fp->flag & FA_WRITE) {
+        // Make sure any buffered writes are on the device before accessing it directly
+        FRESULT res = f_sync(fp);
+        if (res != FR_OK) {
+            mp_raise_OSError(fresult_to_errno_table[res]);
+        }
+    }
+
+    FSIZE_t len = f_tell(fp) < f_size(fp) ? f_size(fp) - f_tell(fp) : 0;
+    if (n_args > 1 && args[1] != mp_const_none) {
+        mp_int_t sz = mp_obj_get_int(args[1]);
+        if (sz >= 0 && (FSIZE_t)sz < len) {
+            len = sz;
+        }
+    }
+    bool copy = n_args > 2 && mp_obj_is_true(args[2]);
+
+    const uint8_t *addr = NULL;
+    if (len > 0) {
+        addr = file_obj_map(fp, len);
+        if (addr != NULL) {
+            f_lseek(fp, f_tell(fp) + len);
+        }
+    }
+
+    return mp_vfs_blockdev_readview(args[0], addr, len, copy);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(file_obj_readview_obj, 1, 3, file_obj_readview);
+
+#endif
+
 // Note: encoding is ignored for now; it's also not a valid kwarg for CPython's FileIO,
 // but by adding it here we can use one single mp_arg_t array for open() and FileIO's constructor
 STATIC const mp_arg_t file_open_args[] = {
@@ -224,6 +303,9 @@ STATIC const mp_rom_map_elem_t vfs_fat_rawfile_locals_dict_table[] = {
     { MP_ROM_QSTR(MP_QSTR_readinto), MP_ROM_PTR(&mp_stream_readinto_obj) },
     { MP_ROM_QSTR(MP_QSTR_readline), MP_ROM_PTR(&mp_stream_unbuffered_readline_obj) },
     { MP_ROM_QSTR(MP_QSTR_readlines), MP_ROM_PTR(&mp_stream_unbuffered_readlines_obj) },
+    #if MICROPY_VFS_READVIEW
+    { MP_ROM_QSTR(MP_QSTR_readview), MP_ROM_PTR(&file_obj_readview_obj) },
+    #endif
     { MP_ROM_QSTR(MP_QSTR_write), MP_ROM_PTR(&mp_stream_write_obj) },
     { MP_ROM_QSTR(MP_QSTR_flush), MP_ROM_PTR(&mp_stream_flush_obj) },
     { MP_ROM_QSTR(MP_QSTR_close), MP_ROM_PTR(&mp_stream_close_obj) },
@@ -200,11 +200,65 @@ STATIC mp_uint_t MP_VFS_LFSx(file_ioctl)(mp_obj_t self_in, mp_uint_t request, ui
     }
 }
 
+#if MICROPY_VFS_READVIEW
+STATIC mp_obj_t MP_VFS_LFSx(file_readview)(size_t n_args, const mp_obj_t *args) {
+    MP_OBJ_VFS_LFSx_FILE *self = MP_OBJ_TO_PTR(args[0]);
+    MP_VFS_LFSx(check_open)(self);
+    LFSx_API(t) * lfs = &self->vfs->lfs;
+    LFSx_API(soff_t) pos = LFSx_API(file_tell)(lfs, &self->file);
+    LFSx_API(soff_t) size = LFSx_API(file_size)(lfs, &self->file);
+    if (pos < 0 || size < 0) {
+        mp_raise_OSError(-(pos < 0 ? pos : size));
+    }
+    size_t len = pos < size ? size - pos : 0;
+    if (n_args > 1 && args[1] != mp_const_none) {
+        mp_int_t sz = mp_obj_get_int(args[1]);
+        if (sz >= 0 && (size_t)sz < len) {
+            len = sz;
+        }
+    }
+    bool copy = n_args > 2 && mp_obj_is_true(args[2]);
+
+    const uint8_t *addr = NULL;
+    if (len > 0) {
+        // Read the first byte so that littlefs locates the block and offset of the
+        // data, then check that the whole range lies within that one block.
+        uint8_t first;
+        LFSx_API(ssize_t) sz = LFSx_API(file_read)(lfs, &self->file, &first, 1);
+        if (sz < 0) {
+            mp_raise_OSError(-sz);
+        }
+        #if LFS_BUILD_VERSION == 2
+        bool is_inline = self->file.flags & LFS2_F_INLINE;
+        #else
+        bool is_inline = false;
+        #endif
+        LFSx_API(off_t) off = self->file.off - 1;
+        if (!is_inline && len <= lfs->cfg->block_size - off) {
+            addr = mp_vfs_blockdev_addr(&self->vfs->blockdev, self->file.block);
+            if (addr != NULL) {
+                addr += off;
+            }
+        }
+        int res = LFSx_API(file_seek)(lfs, &self->file, addr != NULL ? pos + (LFSx_API(soff_t))len : pos, LFSx_MACRO(_SEEK_SET));
+        if (res < 0) {
+            mp_raise_OSError(-res);
+        }
+    }
+
+    return mp_vfs_blockdev_readview(args[0], addr, len, copy);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(MP_VFS_LFSx(file_readview_obj), 1, 3, MP_VFS_LFSx(file_readview));
+#endif
+
 STATIC const mp_rom_map_elem_t MP_VFS_LFSx(file_locals_dict_table)[] = {
     { MP_ROM_QSTR(MP_QSTR_read), MP_ROM_PTR(&mp_stream_read_obj) },
     { MP_ROM_QSTR(MP_QSTR_readinto), MP_ROM_PTR(&mp_stream_readinto_obj) },
     { MP_ROM_QSTR(MP_QSTR_readline), MP_ROM_PTR(&mp_stream_unbuffered_readline_obj) },
     { MP_ROM_QSTR(MP_QSTR_readlines), MP_ROM_PTR(&mp_stream_unbuffered_readlines_obj) },
+    #if MICROPY_VFS_READVIEW
+    { MP_ROM_QSTR(MP_QSTR_readview), MP_ROM_PTR(&MP_VFS_LFSx(file_readview_obj)) },
+    #endif
     { MP_ROM_QSTR(MP_QSTR_write), MP_ROM_PTR(&mp_stream_write_obj) },
     { MP_ROM_QSTR(MP_QSTR_flush), MP_ROM_PTR(&mp_stream_flush_obj) },
     { MP_ROM_QSTR(MP_QSTR_close), MP_ROM_PTR(&mp_stream_close_obj) },
@@ -70,6 +70,10 @@ STATIC void mp_reader_vfs_close(void *data) {
 }
 
 void mp_reader_new_file(mp_reader_t *reader, const char *filename) {
+    mp_reader_new_file_at(reader, filename, 0);
+}
+
+void mp_reader_new_file_at(mp_reader_t *reader, const char *filename, size_t offset) {
     mp_reader_vfs_t *rf = m_new_obj(mp_reader_vfs_t);
     mp_obj_t args[2] = {
         mp_obj_new_str(filename, strlen(filename)),
@@ -77,6 +81,34 @@ void mp_reader_new_file(mp_reader_t *reader, const char *filename) {
     };
     rf->file = mp_vfs_open(MP_ARRAY_SIZE(args), &args[0], (mp_map_t *)&mp_const_empty_map);
     int errcode;
+    if (offset != 0) {
+        // seek to the offset, or skip over the bytes if the file can't seek
+        const mp_stream_p_t *stream_p = mp_get_stream(rf->file);
+        struct mp_stream_seek_t seek_s = {offset, MP_SEEK_SET};
+        bool seeked = false;
+        if (stream_p->ioctl != NULL
+            && stream_p->ioctl(rf->file, MP_STREAM_SEEK, (uintptr_t)&seek_s, &errcode) != MP_STREAM_ERROR) {
+            // check the new position, in case the seek request was ignored
+            seek_s.offset = 0;
+            seek_s.whence = MP_SEEK_CUR;
+            seeked = stream_p->ioctl(rf->file, MP_STREAM_SEEK, (uintptr_t)&seek_s, &errcode) != MP_STREAM_ERROR
+                && seek_s.offset == (mp_off_t)offset;
+        }
+        if (!seeked) {
+            while (offset > 0) {
+                size_t n = MIN(offset, sizeof(rf->buf));
+                n = mp_stream_rw(rf->file, rf->buf, n, &errcode, MP_STREAM_RW_READ);
+                if (errcode != 0) {
+                    mp_stream_close(rf->file);
+                    mp_raise_OSError(errcode);
+                }
+                if (n == 0) {
+                    break;
+                }
+                offset -= n;
+            }
+        }
+    }
     rf->len = mp_stream_rw(rf->file, rf->buf, sizeof(rf->buf), &errcode, MP_STREAM_RW_READ | MP_STREAM_RW_ONCE);
     if (errcode != 0) {
         mp_raise_OSError(errcode);
@@ -87,4 +119,21 @@ void mp_reader_new_file(mp_reader_t *reader, const char *filename) {
     reader->close = mp_reader_vfs_close;
 }
 
+qstr mp_reader_file_abspath(const char *filename) {
+    if (filename[0] == '/') {
+        return qstr_from_str(filename);
+    }
+    const char *cwd = mp_obj_str_get_str(mp_vfs_getcwd());
+    vstr_t vstr;
+    vstr_init(&vstr, strlen(cwd) + strlen(filename) + 2);
+    vstr_add_str(&vstr, cwd);
+    if (vstr.len == 0 || vstr.buf[vstr.len - 1] != '/') {
+        vstr_add_byte(&vstr, '/');
+    }
+    vstr_add_str(&vstr, filename);
+    qstr q = qstr_from_strn(vstr.buf, vstr.len);
+    vstr_clear(&vstr);
+    return q;
+}
+
 #endif // MICROPY_READER_VFS
@@ -41,6 +41,9 @@
 
 // Command line options, with their defaults
 STATIC uint emit_opt = MP_EMIT_OPT_NONE;
+STATIC bool native_fallback = false;
+STATIC const char *native_profile_file = NULL;
+STATIC unsigned long native_profile_percent = 90;
 mp_uint_t mp_verbose_flag = 0;
 
 // Heap size of GC heap (if enabled)
@@ -53,7 +56,7 @@ STATIC void stderr_print_strn(void *env, const char *str, size_t len) {
     (void)dummy;
 }
 
-STATIC const mp_print_t mp_stderr_print = {NULL, stderr_print_strn};
+const mp_print_t mp_stderr_print = {NULL, stderr_print_strn};
 
 STATIC int compile_and_save(const char *file, const char *output_file, const char *source_file) {
     nlr_buf_t nlr;
@@ -95,6 +98,83 @@ STATIC int compile_and_save(const char *file, const char *output_file, const cha
     }
 }
 
+#if MICROPY_EMIT_NATIVE
+typedef struct _native_profile_entry_t {
+    unsigned long self_us;
+    size_t line;
+    bool in_source;
+} native_profile_entry_t;
+
+STATIC int native_profile_entry_cmp(const void *a, const void *b) {
+    unsigned long a_us = ((const native_profile_entry_t *)a)->self_us;
+    unsigned long b_us = ((const native_profile_entry_t *)b)->self_us;
+    return a_us < b_us ? 1 : a_us > b_us ? -1 : 0;
+}
+
+STATIC const char *path_basename(const char *path) {
+    const char *p = strrchr(path, '/');
+    return p == NULL ? path : p + 1;
+}
+
+// Load a profile made by tools/mpy-profile.py and select the smallest set of
+// functions that together account for native_profile_percent of the profiled
+// time.  Those defined in the file being compiled (matched by name, without
+// the directory) are then compiled natively, and all other functions to bytecode.
+STATIC void load_native_profile(const char *source_file) {
+    FILE *f = fopen(native_profile_file, "r");
+    if (f == NULL) {
+        mp_printf(&mp_stderr_print, "can't open profile '%s'\n", native_profile_file);
+        exit(1);
+    }
+
+    // each line is: <calls> <self time in us> <line> <name> <file>
+    const char *source_base = path_basename(source_file);
+    native_profile_entry_t *entries = NULL;
+    size_t len = 0, alloc = 0;
+    unsigned long long total_us = 0;
+    char buf[512];
+    while (fgets(buf, sizeof(buf), f) != NULL) {
+        unsigned long calls, self_us, line;
+        int name_pos = 0, file_pos = 0;
+        if (buf[0] == '#' || sscanf(buf, "%lu %lu %lu %n%*s %n", &calls, &self_us, &line, &name_pos, &file_pos) != 3 || file_pos == 0) {
+            continue;
+        }
+        char *file = buf + file_pos;
+        file[strcspn(file, "\r\n")] = '\0';
+        if (len == alloc) {
+            alloc = alloc * 2 + 16;
+            entries = realloc(entries, alloc * sizeof(native_profile_entry_t));
+        }
+        entries[len].self_us = self_us;
+        entries[len].line = line;
+        // top-level code of a module is counted in the total but never selected
+        entries[len].in_source = strcmp(path_basename(file), source_base) == 0
+            && strncmp(buf + name_pos, "<module> ", sizeof("<module> ") - 1) != 0;
+        total_us += self_us;
+        ++len;
+    }
+    fclose(f);
+
+    qsort(entries, len, sizeof(native_profile_entry_t), native_profile_entry_cmp);
+    size_t *lines = malloc((len + 1) * sizeof(size_t));
+    size_t num_lines = 0;
+    unsigned long long acc_us = 0;
+    for (size_t i = 0; i < len && acc_us * 100 < total_us * native_profile_percent; ++i) {
+        acc_us += entries[i].self_us;
+        if (entries[i].in_source) {
+            if (mp_verbose_flag) {
+                mp_printf(&mp_stderr_print, "%s:%u: compiling natively\n", source_file, (uint)entries[i].line);
+            }
+            lines[num_lines++] = entries[i].line;
+        }
+    }
+    free(entries);
+
+    mp_dynamic_compiler.native_profile_len = num_lines;
+    mp_dynamic_compiler.native_profile_lines = lines;
+}
+#endif
+
 STATIC int usage(char **argv) {
     printf(
         "usage: %s [<opts>] [-X <implopt>] <input filename>\n"
@@ -117,6 +197,9 @@ STATIC int usage(char **argv) {
     printf(
         #if MICROPY_EMIT_NATIVE
         "  emit={bytecode,native,viper} -- set the default code emitter\n"
+        "  emit=native-fallback -- compile to native code where possible, else to bytecode\n"
+        "  native-profile=<file> -- compile natively only the hot functions in the given profile\n"
+        "  native-profile-percent=<n> -- hot functions account for n%% of the profiled time (default 90)\n"
         #else
         "  emit=bytecode -- set the default code emitter\n"
         #endif
@@ -147,8 +230,20 @@ STATIC void pre_process_options(int argc, char **argv) {
                 #if MICROPY_EMIT_NATIVE
                 } else if (strcmp(argv[a + 1], "emit=native") == 0) {
                     emit_opt = MP_EMIT_OPT_NATIVE_PYTHON;
+                } else if (strcmp(argv[a + 1], "emit=native-fallback") == 0) {
+                    emit_opt = MP_EMIT_OPT_NATIVE_PYTHON;
+                    native_fallback = true;
                 } else if (strcmp(argv[a + 1], "emit=viper") == 0) {
                     emit_opt = MP_EMIT_OPT_VIPER;
+                } else if (strncmp(argv[a + 1], "native-profile=", sizeof("native-profile=") - 1) == 0) {
+                    native_profile_file = argv[a + 1] + sizeof("native-profile=") - 1;
+                    native_fallback = true;
+                } else if (strncmp(argv[a + 1], "native-profile-percent=", sizeof("native-profile-percent=") - 1) == 0) {
+                    char *end;
+                    native_profile_percent = strtoul(argv[a + 1] + sizeof("native-profile-percent=") - 1, &end, 0);
+                    if (*end || native_profile_percent > 100) {
+                        exit(usage(argv));
+                    }
                 #endif
                 } else if (strncmp(argv[a + 1], "heapsize=", sizeof("heapsize=") - 1) == 0) {
                     char *end;
@@ -201,12 +296,16 @@ MP_NOINLINE int main_(int argc, char **argv) {
     MP_STATE_VM(default_emit_opt) = emit_opt;
     #else
     (void)emit_opt;
+    (void)native_fallback;
+    (void)native_profile_file;
+    (void)native_profile_percent;
     #endif
 
     // set default compiler configuration
     mp_dynamic_compiler.small_int_bits = 31;
     mp_dynamic_compiler.opt_cache_map_lookup_in_bytecode = 0;
     mp_dynamic_compiler.py_builtins_str_unicode = 1;
+    mp_dynamic_compiler.native_fallback = native_fallback;
     #if defined(__i386__)
     mp_dynamic_compiler.native_arch = MP_NATIVE_ARCH_X86;
     mp_dynamic_compiler.nlr_buf_num_regs = MICROPY_NLR_NUM_REGS_X86;
@@ -321,6 +420,12 @@ MP_NOINLINE int main_(int argc, char **argv) {
         exit(1);
     }
 
+    #if MICROPY_EMIT_NATIVE
+    if (native_profile_file != NULL) {
+        load_native_profile(source_file == NULL ? input_file : source_file);
+    }
+    #endif
+
     int ret = compile_and_save(input_file, output_file, source_file);
 
     #if MICROPY_PY_MICROPYTHON_MEM_INFO
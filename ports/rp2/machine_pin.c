@@ -28,6 +28,7 @@
 #include <string.h>
 
 #include "py/runtime.h"
+#include "py/mperrno.h"
 #include "py/mphal.h"
 #include "lib/utils/mpirq.h"
 #include "modmachine.h"
@@ -67,6 +68,15 @@ typedef struct _machine_pin_irq_obj_t {
     mp_irq_obj_t base;
     uint32_t flags;
     uint32_t trigger;
+    // Optional edge capture ring buffer, filled by the hard IRQ with
+    // (timestamp, flags) pairs.  The head and tail count modulo twice the
+    // number of entries, so a full buffer can be told apart from an empty one.
+    mp_obj_t capture_obj;
+    uint32_t *capture_buf;
+    uint32_t capture_len;
+    volatile uint32_t capture_head;
+    volatile uint32_t capture_tail;
+    volatile uint32_t capture_overruns;
 } machine_pin_irq_obj_t;
 
 STATIC const mp_irq_methods_t machine_pin_irq_methods;
@@ -107,6 +117,45 @@ STATIC const machine_pin_obj_t machine_pin_obj[NUM_BANK0_GPIOS] = {
 // Mask with "1" indicating that the corresponding pin is in simulated open-drain mode.
 uint32_t machine_pin_open_drain_mask;
 
+// Number of edges waiting in the capture buffer.
+STATIC inline uint32_t machine_pin_capture_avail(machine_pin_irq_obj_t *irq, uint32_t head, uint32_t tail) {
+    uint32_t n = head - tail;
+    if (head < tail) {
+        n += 2 * irq->capture_len;
+    }
+    return n;
+}
+
+// Advance a capture head/tail index, wrapping at twice the number of entries.
+STATIC inline uint32_t machine_pin_capture_next(machine_pin_irq_obj_t *irq, uint32_t idx) {
+    return idx + 1 == 2 * irq->capture_len ? 0 : idx + 1;
+}
+
+// Address of the capture buffer entry for the given head/tail index.
+STATIC inline uint32_t *machine_pin_capture_entry(machine_pin_irq_obj_t *irq, uint32_t idx) {
+    if (idx >= irq->capture_len) {
+        idx -= irq->capture_len;
+    }
+    return &irq->capture_buf[2 * idx];
+}
+
+// Record an edge in the capture buffer.  Returns true if the handler should be
+// called, which is only when the buffer goes from empty to non-empty.
+STATIC bool machine_pin_irq_capture(machine_pin_irq_obj_t *irq) {
+    uint32_t head = irq->capture_head;
+    uint32_t tail = irq->capture_tail;
+    if (machine_pin_capture_avail(irq, head, tail) >= irq->capture_len) {
+        ++irq->capture_overruns;
+        return false;
+    }
+    uint32_t *entry = machine_pin_capture_entry(irq, head);
+    entry[0] = mp_hal_ticks_us() & (MICROPY_PY_UTIME_TICKS_PERIOD - 1);
+    entry[1] = irq->flags;
+    __dmb();
+    irq->capture_head = machine_pin_capture_next(irq, head);
+    return head == tail && irq->base.handler != mp_const_none;
+}
+
 STATIC void gpio_irq(void) {
     for (int i = 0; i < 4; ++i) {
         uint32_t intr = iobank0_hw->intr[i];
@@ -118,7 +167,9 @@ STATIC void gpio_irq(void) {
                     machine_pin_irq_obj_t *irq = MP_STATE_PORT(machine_pin_irq_obj[gpio]);
                     if (irq != NULL && (intr & irq->trigger)) {
                         irq->flags = intr & irq->trigger;
-                        mp_irq_handler(&irq->base);
+                        if (irq->capture_buf == NULL || machine_pin_irq_capture(irq)) {
+                            mp_irq_handler(&irq->base);
+                        }
                     }
                 }
                 intr >>= 4;
@@ -313,13 +364,14 @@ STATIC mp_obj_t machine_pin_toggle(mp_obj_t self_in) {
 }
 STATIC MP_DEFINE_CONST_FUN_OBJ_1(machine_pin_toggle_obj, machine_pin_toggle);
 
-// pin.irq(handler=None, trigger=IRQ_FALLING|IRQ_RISING, hard=False)
+// pin.irq(handler=None, trigger=IRQ_FALLING|IRQ_RISING, hard=False, capture=None)
 STATIC mp_obj_t machine_pin_irq(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
-    enum { ARG_handler, ARG_trigger, ARG_hard };
+    enum { ARG_handler, ARG_trigger, ARG_hard, ARG_capture };
     static const mp_arg_t allowed_args[] = {
         { MP_QSTR_handler, MP_ARG_OBJ, {.u_rom_obj = MP_ROM_NONE} },
         { MP_QSTR_trigger, MP_ARG_INT, {.u_int = GPIO_IRQ_EDGE_FALL | GPIO_IRQ_EDGE_RISE} },
         { MP_QSTR_hard, MP_ARG_BOOL, {.u_bool = false} },
+        { MP_QSTR_capture, MP_ARG_KW_ONLY | MP_ARG_OBJ, {.u_rom_obj = MP_ROM_NONE} },
     };
     machine_pin_obj_t *self = MP_OBJ_TO_PTR(pos_args[0]);
     mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
@@ -336,12 +388,23 @@ STATIC mp_obj_t machine_pin_irq(size_t n_args, const mp_obj_t *pos_args, mp_map_
         irq->base.parent = MP_OBJ_FROM_PTR(self);
         irq->base.handler = mp_const_none;
         irq->base.ishard = false;
+        irq->capture_obj = mp_const_none;
+        irq->capture_buf = NULL;
         MP_STATE_PORT(machine_pin_irq_obj[self->id]) = irq;
     }
 
     if (n_args > 1 || kw_args->used != 0) {
         // Configure IRQ.
 
+        // Get the capture buffer, which holds pairs of 32-bit words.
+        mp_buffer_info_t bufinfo = {.buf = NULL, .len = 0};
+        if (args[ARG_capture].u_obj != mp_const_none) {
+            mp_get_buffer_raise(args[ARG_capture].u_obj, &bufinfo, MP_BUFFER_WRITE);
+            if (bufinfo.len < 2 * sizeof(uint32_t) || ((uintptr_t)bufinfo.buf & 3) != 0) {
+                mp_raise_ValueError(MP_ERROR_TEXT("invalid capture buffer"));
+            }
+        }
+
         // Disable all IRQs while data is updated.
         gpio_set_irq_enabled(self->id, GPIO_IRQ_ALL, false);
 
@@ -350,9 +413,15 @@ STATIC mp_obj_t machine_pin_irq(size_t n_args, const mp_obj_t *pos_args, mp_map_
         irq->base.ishard = args[ARG_hard].u_bool;
         irq->flags = 0;
         irq->trigger = args[ARG_trigger].u_int;
-
-        // Enable IRQ if a handler is given.
-        if (args[ARG_handler].u_obj != mp_const_none) {
+        irq->capture_obj = args[ARG_capture].u_obj;
+        irq->capture_buf = bufinfo.buf;
+        irq->capture_len = bufinfo.len / (2 * sizeof(uint32_t));
+        irq->capture_head = 0;
+        irq->capture_tail = 0;
+        irq->capture_overruns = 0;
+
+        // Enable IRQ if a handler or capture buffer is given.
+        if (args[ARG_handler].u_obj != mp_const_none || irq->capture_buf != NULL) {
             gpio_set_irq_enabled(self->id, args[ARG_trigger].u_int, true);
         }
     }
@@ -361,6 +430,45 @@ STATIC mp_obj_t machine_pin_irq(size_t n_args, const mp_obj_t *pos_args, mp_map_
 }
 STATIC MP_DEFINE_CONST_FUN_OBJ_KW(machine_pin_irq_obj, 1, machine_pin_irq);
 
+// pin.capture([buf])
+STATIC mp_obj_t machine_pin_capture(size_t n_args, const mp_obj_t *args) {
+    machine_pin_obj_t *self = MP_OBJ_TO_PTR(args[0]);
+    machine_pin_irq_obj_t *irq = MP_STATE_PORT(machine_pin_irq_obj[self->id]);
+    if (irq == NULL || irq->capture_buf == NULL) {
+        mp_raise_OSError(MP_EINVAL);
+    }
+
+    if (n_args == 1) {
+        // Return the number of pending edges and the number of edges dropped.
+        mp_obj_t tuple[2] = {
+            mp_obj_new_int_from_uint(machine_pin_capture_avail(irq, irq->capture_head, irq->capture_tail)),
+            mp_obj_new_int_from_uint(irq->capture_overruns),
+        };
+        return mp_obj_new_tuple(2, tuple);
+    }
+
+    // Move as many pending edges as fit into the given buffer.
+    mp_buffer_info_t bufinfo;
+    mp_get_buffer_raise(args[1], &bufinfo, MP_BUFFER_WRITE);
+    uint32_t *dest = bufinfo.buf;
+    uint32_t n = bufinfo.len / (2 * sizeof(uint32_t));
+    uint32_t tail = irq->capture_tail;
+    uint32_t avail = machine_pin_capture_avail(irq, irq->capture_head, tail);
+    if (n > avail) {
+        n = avail;
+    }
+    __dmb();
+    for (uint32_t i = 0; i < n; ++i, tail = machine_pin_capture_next(irq, tail)) {
+        const uint32_t *entry = machine_pin_capture_entry(irq, tail);
+        memcpy(dest, entry, 2 * sizeof(uint32_t));
+        dest += 2;
+    }
+    __dmb();
+    irq->capture_tail = tail;
+    return MP_OBJ_NEW_SMALL_INT(n);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(machine_pin_capture_obj, 1, 2, machine_pin_capture);
+
 STATIC const mp_rom_map_elem_t machine_pin_locals_dict_table[] = {
     // instance methods
     { MP_ROM_QSTR(MP_QSTR_init), MP_ROM_PTR(&machine_pin_init_obj) },
@@ -371,6 +479,7 @@ STATIC const mp_rom_map_elem_t machine_pin_locals_dict_table[] = {
     { MP_ROM_QSTR(MP_QSTR_on), MP_ROM_PTR(&machine_pin_high_obj) },
     { MP_ROM_QSTR(MP_QSTR_toggle), MP_ROM_PTR(&machine_pin_toggle_obj) },
     { MP_ROM_QSTR(MP_QSTR_irq), MP_ROM_PTR(&machine_pin_irq_obj) },
+    { MP_ROM_QSTR(MP_QSTR_capture), MP_ROM_PTR(&machine_pin_capture_obj) },
 
     // class constants
     { MP_ROM_QSTR(MP_QSTR_IN), MP_ROM_INT(GPIO_MODE_IN) },
@@ -47,7 +47,7 @@
 #include "hardware/structs/rosc.h"
 
 extern uint8_t __StackTop, __StackBottom;
-static char gc_heap[192 * 1024];
+extern uint8_t __GcHeapStart, __GcHeapEnd;
 
 // Embed version info in the binary in machine readable form
 bi_decl(bi_program_version_string(MICROPY_GIT_TAG));
@@ -91,7 +91,11 @@ int main(int argc, char **argv) {
     // Initialise stack extents and GC heap.
     mp_stack_set_top(&__StackTop);
     mp_stack_set_limit(&__StackTop - &__StackBottom - 256);
-    gc_init(&gc_heap[0], &gc_heap[MP_ARRAY_SIZE(gc_heap)]);
+    #if MICROPY_GC_HEAP_SIZE
+    gc_init(&__GcHeapStart, MIN(&__GcHeapStart + MICROPY_GC_HEAP_SIZE, &__GcHeapEnd));
+    #else
+    gc_init(&__GcHeapStart, &__GcHeapEnd);
+    #endif
 
     for (;;) {
 
@@ -32,6 +32,9 @@ STATIC const mp_rom_map_elem_t rp2_module_globals_table[] = {
     { MP_ROM_QSTR(MP_QSTR_Flash),               MP_ROM_PTR(&rp2_flash_type) },
     { MP_ROM_QSTR(MP_QSTR_PIO),                 MP_ROM_PTR(&rp2_pio_type) },
     { MP_ROM_QSTR(MP_QSTR_StateMachine),        MP_ROM_PTR(&rp2_state_machine_type) },
+    #if MICROPY_HW_ENABLE_USBDEV && MICROPY_HW_USB_CDC_DATA
+    { MP_ROM_QSTR(MP_QSTR_USBCDC),              MP_ROM_PTR(&rp2_usb_cdc_type) },
+    #endif
 };
 STATIC MP_DEFINE_CONST_DICT(rp2_module_globals, rp2_module_globals_table);
 
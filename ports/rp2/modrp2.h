@@ -31,6 +31,7 @@
 extern const mp_obj_type_t rp2_flash_type;
 extern const mp_obj_type_t rp2_pio_type;
 extern const mp_obj_type_t rp2_state_machine_type;
+extern const mp_obj_type_t rp2_usb_cdc_type;
 
 void rp2_pio_init(void);
 void rp2_pio_deinit(void);
@@ -38,10 +38,38 @@
 #define MICROPY_HW_ENABLE_UART_REPL             (0) // useful if there is no USB
 #define MICROPY_HW_ENABLE_USBDEV                (1)
 
+// USB CDC FIFO sizes, and an optional second CDC interface for binary data
+#ifndef MICROPY_HW_USB_CDC_RX_BUFSIZE
+#define MICROPY_HW_USB_CDC_RX_BUFSIZE           (256)
+#endif
+#ifndef MICROPY_HW_USB_CDC_TX_BUFSIZE
+#define MICROPY_HW_USB_CDC_TX_BUFSIZE           (1024)
+#endif
+#ifndef MICROPY_HW_USB_CDC_DATA
+#define MICROPY_HW_USB_CDC_DATA                 (0)
+#endif
+
 // Memory allocation policies
 #define MICROPY_GC_STACK_ENTRY_TYPE             uint16_t
+#define MICROPY_GC_SIZE_CLASSES                 (4)
+#define MICROPY_GC_INCREMENTAL_SWEEP            (1)
+#define MICROPY_GC_LARGE_ALLOC_BLOCKS           (64)
+#define MICROPY_GC_NURSERY                      (2)
+#ifndef MICROPY_GC_HEAP_SIZE
+#define MICROPY_GC_HEAP_SIZE                    (0) // 0 means use all free RAM
+#endif
 #define MICROPY_ALLOC_PATH_MAX                  (128)
 #define MICROPY_QSTR_BYTES_IN_HASH              (1)
+#define MICROPY_QSTR_HASH_INDEX                 (1)
+#define MICROPY_OPT_COMPUTED_GOTO               (1)
+#define MICROPY_OPT_COMPUTED_GOTO_SAVE_SPACE    (1)
+#define MICROPY_OPT_VM_SUPERINSTRUCTIONS        (1)
+#define MICROPY_OPT_MAP_LOOKUP_CACHE            (1)
+#define MICROPY_OPT_TYPE_ATTR_CACHE             (1)
+#define MICROPY_OPT_TYPE_ATTR_CACHE_SIZE        (32)
+#define MICROPY_MAP_COMPACT                     (1)
+#define MICROPY_OPT_MPZ_KARATSUBA               (1)
+#define MICROPY_OPT_MPZ_POW3_MONTGOMERY         (1)
 
 // MicroPython emitters
 #define MICROPY_PERSISTENT_CODE_LOAD            (1)
@@ -122,6 +150,7 @@
 #define MICROPY_PY_UHASHLIB                     (1)
 #define MICROPY_PY_UBINASCII                    (1)
 #define MICROPY_PY_UBINASCII_CRC32              (1)
+#define MICROPY_PY_UBUF                         (1)
 #define MICROPY_PY_UTIME_MP_HAL                 (1)
 #define MICROPY_PY_URANDOM                      (1)
 #define MICROPY_PY_URANDOM_EXTRA_FUNCS          (1)
@@ -134,6 +163,7 @@
 #define MICROPY_PY_MACHINE_PIN_MAKE_NEW         mp_pin_make_new
 #define MICROPY_PY_MACHINE_PULSE                (1)
 #define MICROPY_PY_MACHINE_I2C                  (1)
+#define MICROPY_PY_MACHINE_I2C_MEM_BATCH        (1)
 #define MICROPY_PY_MACHINE_SPI                  (1)
 #define MICROPY_PY_MACHINE_SPI_MSB              (SPI_MSB_FIRST)
 #define MICROPY_PY_MACHINE_SPI_LSB              (SPI_LSB_FIRST)
@@ -141,6 +171,7 @@
 #define MICROPY_VFS                             (1)
 #define MICROPY_VFS_LFS2                        (1)
 #define MICROPY_VFS_FAT                         (1)
+#define MICROPY_VFS_READVIEW                    (1)
 
 // fatfs configuration
 #define MICROPY_FATFS_ENABLE_LFN                (1)
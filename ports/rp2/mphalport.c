@@ -49,8 +49,10 @@ ringbuf_t stdin_ringbuf = { stdin_ringbuf_array, sizeof(stdin_ringbuf_array) };
 int mp_interrupt_char = -1;
 
 void tud_cdc_rx_wanted_cb(uint8_t itf, char wanted_char) {
-    (void)itf;
     (void)wanted_char;
+    if (itf != 0) {
+        return;
+    }
     tud_cdc_read_char(); // discard interrupt char
     mp_sched_keyboard_interrupt();
 }
@@ -99,6 +101,35 @@ int mp_hal_stdin_rx_chr(void) {
     }
 }
 
+#if MICROPY_HW_ENABLE_USBDEV
+
+// Write all data to the given CDC interface.  The TX FIFO is filled as much as
+// possible on each pass, and tinyusb starts a bulk transfer whenever at least
+// one packet is queued, so only the final partial packet needs a flush.
+void mp_hal_usb_cdc_write(uint8_t itf, const uint8_t *buf, size_t len) {
+    while (len) {
+        uint32_t n = tud_cdc_n_write_available(itf);
+        if (n == 0) {
+            tud_task();
+            tud_cdc_n_write_flush(itf);
+            if (!tud_cdc_n_connected(itf)) {
+                return;
+            }
+            continue;
+        }
+        if (n > len) {
+            n = len;
+        }
+        n = tud_cdc_n_write(itf, buf, n);
+        buf += n;
+        len -= n;
+    }
+    tud_task();
+    tud_cdc_n_write_flush(itf);
+}
+
+#endif
+
 // Send string of given length
 void mp_hal_stdout_tx_strn(const char *str, mp_uint_t len) {
     #if MICROPY_HW_ENABLE_UART_REPL
@@ -107,20 +138,7 @@ void mp_hal_stdout_tx_strn(const char *str, mp_uint_t len) {
 
     #if MICROPY_HW_ENABLE_USBDEV
     if (tud_cdc_connected()) {
-        for (size_t i = 0; i < len;) {
-            uint32_t n = len - i;
-            if (n > CFG_TUD_CDC_EP_BUFSIZE) {
-                n = CFG_TUD_CDC_EP_BUFSIZE;
-            }
-            while (n > tud_cdc_write_available()) {
-                tud_task();
-                tud_cdc_write_flush();
-            }
-            uint32_t n2 = tud_cdc_write(str + i, n);
-            tud_task();
-            tud_cdc_write_flush();
-            i += n2;
-        }
+        mp_hal_usb_cdc_write(0, (const uint8_t *)str, len);
     }
     #endif
 }
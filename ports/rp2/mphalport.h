@@ -33,6 +33,7 @@ extern int mp_interrupt_char;
 extern ringbuf_t stdin_ringbuf;
 
 void mp_hal_set_interrupt_char(int c);
+void mp_hal_usb_cdc_write(uint8_t itf, const uint8_t *buf, size_t len);
 
 static inline void mp_hal_delay_us(mp_uint_t us) {
     sleep_us(us);
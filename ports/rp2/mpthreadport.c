@@ -33,6 +33,9 @@
 #if MICROPY_PY_THREAD
 
 extern uint8_t __StackTop, __StackBottom;
+#if MICROPY_HW_CORE1_STACK_IN_SCRATCH
+extern uint8_t __StackOneTop, __StackOneBottom;
+#endif
 
 void *core_state[2];
 
@@ -77,9 +80,16 @@ void mp_thread_create(void *(*entry)(void *), void *arg, size_t *stack_size) {
         mp_raise_msg(&mp_type_OSError, MP_ERROR_TEXT("core1 in use"));
     }
 
-    core1_entry = entry;
-    core1_arg = arg;
-
+    #if MICROPY_HW_CORE1_STACK_IN_SCRATCH
+    // Use the fixed stack reserved for core1 in SCRATCH_X, leaving the GC heap untouched.
+    // The linker script checks its size too, but a zero-length stack must never be used.
+    if (&__StackOneTop - &__StackOneBottom < 2048) {
+        mp_raise_msg(&mp_type_OSError, MP_ERROR_TEXT("core1 stack too small"));
+    }
+    core1_stack = (uint32_t *)&__StackOneBottom;
+    *stack_size = &__StackOneTop - &__StackOneBottom;
+    core1_stack_num_words = *stack_size / sizeof(uint32_t);
+    #else
     if (*stack_size == 0) {
         *stack_size = 4096; // default stack size
     } else if (*stack_size < 2048) {
@@ -92,6 +102,10 @@ void mp_thread_create(void *(*entry)(void *), void *arg, size_t *stack_size) {
 
     // Allocate stack.
     core1_stack = m_new(uint32_t, core1_stack_num_words);
+    #endif
+
+    core1_entry = entry;
+    core1_arg = arg;
 
     // Create thread on core1.
     multicore_reset_core1();
@@ -126,12 +126,27 @@ STATIC mp_obj_t rp2_flash_ioctl(mp_obj_t self_in, mp_obj_t cmd_in, mp_obj_t arg_
             // TODO check return value
             return MP_OBJ_NEW_SMALL_INT(0);
         }
+        case MP_BLOCKDEV_IOCTL_BLOCK_ADDR:
+            // The storage is memory mapped via XIP so data can be read in place
+            return mp_obj_new_int_from_uint(XIP_BASE + self->flash_base + mp_obj_get_int(arg_in) * BLOCK_SIZE_BYTES);
         default:
             return mp_const_none;
     }
 }
 STATIC MP_DEFINE_CONST_FUN_OBJ_3(rp2_flash_ioctl_obj, rp2_flash_ioctl);
 
+// Expose the storage read-only via the buffer protocol, eg memoryview(rp2.Flash())
+STATIC mp_int_t rp2_flash_get_buffer(mp_obj_t self_in, mp_buffer_info_t *bufinfo, mp_uint_t flags) {
+    rp2_flash_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    if (flags & MP_BUFFER_WRITE) {
+        return 1;
+    }
+    bufinfo->buf = (void *)(XIP_BASE + self->flash_base);
+    bufinfo->len = self->flash_size;
+    bufinfo->typecode = 'B';
+    return 0;
+}
+
 STATIC const mp_rom_map_elem_t rp2_flash_locals_dict_table[] = {
     { MP_ROM_QSTR(MP_QSTR_readblocks), MP_ROM_PTR(&rp2_flash_readblocks_obj) },
     { MP_ROM_QSTR(MP_QSTR_writeblocks), MP_ROM_PTR(&rp2_flash_writeblocks_obj) },
@@ -143,5 +158,6 @@ const mp_obj_type_t rp2_flash_type = {
     { &mp_type_type },
     .name = MP_QSTR_Flash,
     .make_new = rp2_flash_make_new,
+    .buffer_p = { .get_buffer = rp2_flash_get_buffer },
     .locals_dict = (mp_obj_dict_t *)&rp2_flash_locals_dict,
 };
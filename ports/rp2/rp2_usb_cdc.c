@@ -0,0 +1,130 @@
+/*
+ * This file is part of the MicroPython project, http://micropython.org/
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 agent
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "py/runtime.h"
+#include "py/stream.h"
+#include "py/mperrno.h"
+#include "py/mphal.h"
+#include "modrp2.h"
+#include "tusb.h"
+
+#if MICROPY_HW_ENABLE_USBDEV && MICROPY_HW_USB_CDC_DATA
+
+// CDC interface used for the binary data channel; interface 0 is the REPL.
+#define RP2_USB_CDC_DATA_ITF (1)
+
+typedef struct _rp2_usb_cdc_obj_t {
+    mp_obj_base_t base;
+} rp2_usb_cdc_obj_t;
+
+STATIC const rp2_usb_cdc_obj_t rp2_usb_cdc_obj = {{&rp2_usb_cdc_type}};
+
+STATIC mp_obj_t rp2_usb_cdc_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, const mp_obj_t *all_args) {
+    mp_arg_check_num(n_args, n_kw, 0, 0, false);
+    return MP_OBJ_FROM_PTR(&rp2_usb_cdc_obj);
+}
+
+STATIC mp_obj_t rp2_usb_cdc_isconnected(mp_obj_t self_in) {
+    return mp_obj_new_bool(tud_cdc_n_connected(RP2_USB_CDC_DATA_ITF));
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(rp2_usb_cdc_isconnected_obj, rp2_usb_cdc_isconnected);
+
+STATIC mp_obj_t rp2_usb_cdc_any(mp_obj_t self_in) {
+    return MP_OBJ_NEW_SMALL_INT(tud_cdc_n_available(RP2_USB_CDC_DATA_ITF));
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(rp2_usb_cdc_any_obj, rp2_usb_cdc_any);
+
+STATIC const mp_rom_map_elem_t rp2_usb_cdc_locals_dict_table[] = {
+    { MP_ROM_QSTR(MP_QSTR_isconnected), MP_ROM_PTR(&rp2_usb_cdc_isconnected_obj) },
+    { MP_ROM_QSTR(MP_QSTR_any), MP_ROM_PTR(&rp2_usb_cdc_any_obj) },
+    { MP_ROM_QSTR(MP_QSTR_read), MP_ROM_PTR(&mp_stream_read_obj) },
+    { MP_ROM_QSTR(MP_QSTR_readinto), MP_ROM_PTR(&mp_stream_readinto_obj) },
+    { MP_ROM_QSTR(MP_QSTR_readline), MP_ROM_PTR(&mp_stream_unbuffered_readline_obj) },
+    { MP_ROM_QSTR(MP_QSTR_write), MP_ROM_PTR(&mp_stream_write_obj) },
+};
+STATIC MP_DEFINE_CONST_DICT(rp2_usb_cdc_locals_dict, rp2_usb_cdc_locals_dict_table);
+
+// Read whatever data is available, without blocking.
+STATIC mp_uint_t rp2_usb_cdc_read(mp_obj_t self_in, void *buf_in, mp_uint_t size, int *errcode) {
+    tud_task();
+    uint32_t n = tud_cdc_n_read(RP2_USB_CDC_DATA_ITF, buf_in, size);
+    if (n == 0 && size != 0) {
+        *errcode = MP_EAGAIN;
+        return MP_STREAM_ERROR;
+    }
+    return n;
+}
+
+// Write data directly from the caller's buffer into the CDC TX FIFO.
+STATIC mp_uint_t rp2_usb_cdc_write(mp_obj_t self_in, const void *buf_in, mp_uint_t size, int *errcode) {
+    if (!tud_cdc_n_connected(RP2_USB_CDC_DATA_ITF)) {
+        *errcode = MP_ENOTCONN;
+        return MP_STREAM_ERROR;
+    }
+    mp_hal_usb_cdc_write(RP2_USB_CDC_DATA_ITF, buf_in, size);
+    return size;
+}
+
+STATIC mp_uint_t rp2_usb_cdc_ioctl(mp_obj_t self_in, mp_uint_t request, mp_uint_t arg, int *errcode) {
+    mp_uint_t ret;
+    if (request == MP_STREAM_POLL) {
+        uintptr_t flags = arg;
+        ret = 0;
+        tud_task();
+        if ((flags & MP_STREAM_POLL_RD) && tud_cdc_n_available(RP2_USB_CDC_DATA_ITF) > 0) {
+            ret |= MP_STREAM_POLL_RD;
+        }
+        if ((flags & MP_STREAM_POLL_WR) && tud_cdc_n_write_available(RP2_USB_CDC_DATA_ITF) > 0) {
+            ret |= MP_STREAM_POLL_WR;
+        }
+    } else if (request == MP_STREAM_FLUSH) {
+        tud_cdc_n_write_flush(RP2_USB_CDC_DATA_ITF);
+        ret = 0;
+    } else {
+        *errcode = MP_EINVAL;
+        ret = MP_STREAM_ERROR;
+    }
+    return ret;
+}
+
+STATIC const mp_stream_p_t rp2_usb_cdc_stream_p = {
+    .read = rp2_usb_cdc_read,
+    .write = rp2_usb_cdc_write,
+    .ioctl = rp2_usb_cdc_ioctl,
+    .is_text = false,
+};
+
+const mp_obj_type_t rp2_usb_cdc_type = {
+    { &mp_type_type },
+    .name = MP_QSTR_USBCDC,
+    .make_new = rp2_usb_cdc_make_new,
+    .getiter = mp_identity_getiter,
+    .iternext = mp_stream_unbuffered_iter,
+    .protocol = &rp2_usb_cdc_stream_p,
+    .locals_dict = (mp_obj_dict_t *)&rp2_usb_cdc_locals_dict,
+};
+
+#endif // MICROPY_HW_ENABLE_USBDEV && MICROPY_HW_USB_CDC_DATA
@@ -25,10 +25,12 @@
 #ifndef MICROPY_INCLUDED_RP2_TUSB_CONFIG_H
 #define MICROPY_INCLUDED_RP2_TUSB_CONFIG_H
 
+#include "py/mpconfig.h"
+
 #define CFG_TUSB_RHPORT0_MODE   (OPT_MODE_DEVICE)
 
-#define CFG_TUD_CDC             (1)
-#define CFG_TUD_CDC_RX_BUFSIZE  (256)
-#define CFG_TUD_CDC_TX_BUFSIZE  (256)
+#define CFG_TUD_CDC             (1 + MICROPY_HW_USB_CDC_DATA)
+#define CFG_TUD_CDC_RX_BUFSIZE  (MICROPY_HW_USB_CDC_RX_BUFSIZE)
+#define CFG_TUD_CDC_TX_BUFSIZE  (MICROPY_HW_USB_CDC_TX_BUFSIZE)
 
 #endif // MICROPY_INCLUDED_RP2_TUSB_CONFIG_H
@@ -30,15 +30,19 @@
 #define USBD_VID (0x2E8A) // Raspberry Pi
 #define USBD_PID (0x0005) // RP2 MicroPython
 
-#define USBD_DESC_LEN (TUD_CONFIG_DESC_LEN + TUD_CDC_DESC_LEN)
+#define USBD_DESC_LEN (TUD_CONFIG_DESC_LEN + CFG_TUD_CDC * TUD_CDC_DESC_LEN)
 #define USBD_MAX_POWER_MA (250)
 
 #define USBD_ITF_CDC (0) // needs 2 interfaces
-#define USBD_ITF_MAX (2)
+#define USBD_ITF_CDC_DATA (2) // needs 2 interfaces
+#define USBD_ITF_MAX (2 * CFG_TUD_CDC)
 
 #define USBD_CDC_EP_CMD (0x81)
 #define USBD_CDC_EP_OUT (0x02)
 #define USBD_CDC_EP_IN (0x82)
+#define USBD_CDC_DATA_EP_CMD (0x83)
+#define USBD_CDC_DATA_EP_OUT (0x04)
+#define USBD_CDC_DATA_EP_IN (0x84)
 #define USBD_CDC_CMD_MAX_SIZE (8)
 #define USBD_CDC_IN_OUT_MAX_SIZE (64)
 
@@ -47,6 +51,7 @@
 #define USBD_STR_PRODUCT (0x02)
 #define USBD_STR_SERIAL (0x03)
 #define USBD_STR_CDC (0x04)
+#define USBD_STR_CDC_DATA (0x05)
 
 // Note: descriptors returned from callbacks must exist long enough for transfer to complete
 
@@ -73,6 +78,11 @@ static const uint8_t usbd_desc_cfg[USBD_DESC_LEN] = {
 
     TUD_CDC_DESCRIPTOR(USBD_ITF_CDC, USBD_STR_CDC, USBD_CDC_EP_CMD,
         USBD_CDC_CMD_MAX_SIZE, USBD_CDC_EP_OUT, USBD_CDC_EP_IN, USBD_CDC_IN_OUT_MAX_SIZE),
+
+    #if MICROPY_HW_USB_CDC_DATA
+    TUD_CDC_DESCRIPTOR(USBD_ITF_CDC_DATA, USBD_STR_CDC_DATA, USBD_CDC_DATA_EP_CMD,
+        USBD_CDC_CMD_MAX_SIZE, USBD_CDC_DATA_EP_OUT, USBD_CDC_DATA_EP_IN, USBD_CDC_IN_OUT_MAX_SIZE),
+    #endif
 };
 
 static const char *const usbd_desc_str[] = {
@@ -80,6 +90,9 @@ static const char *const usbd_desc_str[] = {
     [USBD_STR_PRODUCT] = "Board in FS mode",
     [USBD_STR_SERIAL] = NULL, // generated dynamically
     [USBD_STR_CDC] = "Board CDC",
+    #if MICROPY_HW_USB_CDC_DATA
+    [USBD_STR_CDC_DATA] = "Board CDC Data",
+    #endif
 };
 
 const uint8_t *tud_descriptor_device_cb(void) {
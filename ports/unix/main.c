@@ -456,9 +456,24 @@ MP_NOINLINE int main_(int argc, char **argv) {
     pre_process_options(argc, argv);
 
     #if MICROPY_ENABLE_GC
+    #if MICROPY_GC_SPLIT_HEAP_N_HEAPS
+    // Split the heap into separately malloc'd areas, to exercise the GC's
+    // support for a discontiguous heap.
+    char *heaps[MICROPY_GC_SPLIT_HEAP_N_HEAPS];
+    long area_size = heap_size / MICROPY_GC_SPLIT_HEAP_N_HEAPS;
+    for (size_t i = 0; i < MICROPY_GC_SPLIT_HEAP_N_HEAPS; ++i) {
+        heaps[i] = malloc(area_size);
+        if (i == 0) {
+            gc_init(heaps[i], heaps[i] + area_size);
+        } else {
+            gc_add(heaps[i], heaps[i] + area_size);
+        }
+    }
+    #else
     char *heap = malloc(heap_size);
     gc_init(heap, heap + heap_size);
     #endif
+    #endif
 
     #if MICROPY_ENABLE_PYSTACK
     static mp_obj_t pystack[1024];
@@ -712,8 +727,14 @@ MP_NOINLINE int main_(int argc, char **argv) {
     #if MICROPY_ENABLE_GC && !defined(NDEBUG)
     // We don't really need to free memory since we are about to exit the
     // process, but doing so helps to find memory leaks.
+    #if MICROPY_GC_SPLIT_HEAP_N_HEAPS
+    for (size_t i = 0; i < MICROPY_GC_SPLIT_HEAP_N_HEAPS; ++i) {
+        free(heaps[i]);
+    }
+    #else
     free(heap);
     #endif
+    #endif
 
     // printf("total bytes = %d\n", m_get_total_bytes_allocated());
     return ret & 0xff;
@@ -52,10 +52,24 @@
     #define MICROPY_EMIT_ARM        (1)
 #endif
 #define MICROPY_COMP_MODULE_CONST   (1)
+#define MICROPY_COMP_CONST_STR      (1)
+#define MICROPY_COMP_CONST_FLOAT    (1)
+#define MICROPY_COMP_CONST_TUPLE    (1)
 #define MICROPY_COMP_TRIPLE_TUPLE_ASSIGN (1)
 #define MICROPY_COMP_RETURN_IF_EXPR (1)
+#ifndef MICROPY_COMP_STREAMING
+#define MICROPY_COMP_STREAMING     (!MICROPY_PY_SYS_SETTRACE)
+#endif
+#define MICROPY_COMP_BC_PEEPHOLE    (1)
+#define MICROPY_QSTR_HASH_INDEX     (1)
 #define MICROPY_ENABLE_GC           (1)
 #define MICROPY_ENABLE_FINALISER    (1)
+#define MICROPY_GC_SIZE_CLASSES     (4)
+#define MICROPY_GC_LARGE_ALLOC_BLOCKS (32)
+#define MICROPY_GC_NURSERY          (2)
+#ifndef MICROPY_GC_SPLIT_HEAP_N_HEAPS
+#define MICROPY_GC_SPLIT_HEAP_N_HEAPS (0)
+#endif
 #define MICROPY_STACK_CHECK         (1)
 #define MICROPY_MALLOC_USES_ALLOCATED_SIZE (1)
 #define MICROPY_MEM_STATS           (1)
@@ -79,9 +93,27 @@
 #endif
 #define MICROPY_STREAMS_POSIX_API   (1)
 #define MICROPY_OPT_COMPUTED_GOTO   (1)
+#ifndef MICROPY_OPT_VM_SUPERINSTRUCTIONS
+#define MICROPY_OPT_VM_SUPERINSTRUCTIONS (1)
+#endif
 #ifndef MICROPY_OPT_CACHE_MAP_LOOKUP_IN_BYTECODE
 #define MICROPY_OPT_CACHE_MAP_LOOKUP_IN_BYTECODE (1)
 #endif
+#ifndef MICROPY_OPT_MAP_LOOKUP_CACHE
+#define MICROPY_OPT_MAP_LOOKUP_CACHE (1)
+#endif
+#ifndef MICROPY_OPT_TYPE_ATTR_CACHE
+#define MICROPY_OPT_TYPE_ATTR_CACHE (1)
+#endif
+#ifndef MICROPY_MAP_COMPACT
+#define MICROPY_MAP_COMPACT         (1)
+#endif
+#ifndef MICROPY_OPT_MPZ_KARATSUBA
+#define MICROPY_OPT_MPZ_KARATSUBA   (1)
+#endif
+#ifndef MICROPY_OPT_MPZ_POW3_MONTGOMERY
+#define MICROPY_OPT_MPZ_POW3_MONTGOMERY (1)
+#endif
 #define MICROPY_MODULE_WEAK_LINKS   (1)
 #define MICROPY_CAN_OVERRIDE_BUILTINS (1)
 #define MICROPY_VFS_POSIX_FILE      (1)
@@ -155,6 +187,7 @@
 #endif
 #define MICROPY_PY_UBINASCII        (1)
 #define MICROPY_PY_UBINASCII_CRC32  (1)
+#define MICROPY_PY_UBUF             (1)
 #define MICROPY_PY_URANDOM          (1)
 #ifndef MICROPY_PY_USELECT_POSIX
 #define MICROPY_PY_USELECT_POSIX    (1)
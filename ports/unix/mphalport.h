@@ -69,6 +69,16 @@ static inline void mp_hal_delay_us(mp_uint_t us) {
 }
 #define mp_hal_ticks_cpu() 0
 
+#if MICROPY_PY_MACHINE_I2C
+// SoftI2C runs over virtual pins, ie instances of machine.PinBase.
+#define mp_hal_delay_us_fast(us) mp_hal_delay_us(us)
+#define MP_HAL_PIN_FMT "%q"
+#define mp_hal_pin_name(p) (mp_obj_get_type(p)->name)
+#define mp_hal_pin_open_drain(p) mp_virtual_pin_write(p, 1)
+#define mp_hal_pin_od_low(p) mp_virtual_pin_write(p, 0)
+#define mp_hal_pin_od_high(p) mp_virtual_pin_write(p, 1)
+#endif
+
 // This macro is used to implement PEP 475 to retry specified syscalls on EINTR
 #define MP_HAL_RETRY_SYSCALL(ret, syscall, raise) { \
         for (;;) { \
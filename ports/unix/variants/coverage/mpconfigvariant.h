@@ -31,10 +31,16 @@
 #define MICROPY_PY_UOS_VFS             (1)
 
 #define MICROPY_DEBUG_PARSE_RULE_NAME  (1)
+#define MICROPY_GC_SPLIT_HEAP          (1)
+#define MICROPY_GC_SPLIT_HEAP_N_HEAPS  (4)
+#define MICROPY_GC_INCREMENTAL_SWEEP   (1)
+#define MICROPY_GC_PROFILE             (1)
+#define MICROPY_OPT_COMPUTED_GOTO_SAVE_SPACE (1)
 #define MICROPY_OPT_MATH_FACTORIAL     (1)
 #define MICROPY_FLOAT_HIGH_QUALITY_HASH (1)
 #define MICROPY_ENABLE_SCHEDULER       (1)
 #define MICROPY_READER_VFS             (1)
+#define MICROPY_PERSISTENT_CODE_LOAD_LAZY (1)
 #define MICROPY_REPL_EMACS_WORDS_MOVE  (1)
 #define MICROPY_REPL_EMACS_EXTRA_WORDS_MOVE (1)
 #define MICROPY_WARNINGS_CATEGORY      (1)
@@ -58,7 +64,10 @@
 #define MICROPY_PY_URE_MATCH_SPAN_START_END (1)
 #define MICROPY_PY_URE_SUB             (1)
 #define MICROPY_VFS_POSIX              (1)
+#define MICROPY_VFS_READVIEW           (1)
 #define MICROPY_PY_FRAMEBUF            (1)
+#define MICROPY_PY_MACHINE_I2C         (1)
+#define MICROPY_PY_MACHINE_I2C_MEM_BATCH (1)
 #define MICROPY_PY_COLLECTIONS_NAMEDTUPLE__ASDICT (1)
 #define MICROPY_PY_UCRYPTOLIB          (1)
 #define MICROPY_PY_UCRYPTOLIB_CTR      (1)
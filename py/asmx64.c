@@ -93,6 +93,7 @@
 #define MODRM_RM_DISP32 (0x80)
 #define MODRM_RM_REG    (0xc0)
 #define MODRM_RM_R64(x) ((x) & 0x7)
+#define MODRM_RM_SIB    (0x04)
 
 #define OP_SIZE_PREFIX (0x66)
 
@@ -204,6 +205,26 @@ STATIC void asm_x64_write_r64_disp(asm_x64_t *as, int r64, int disp_r64, int dis
     }
 }
 
+// Writes the optional REX prefix for an instruction addressing [base + index * scale]
+STATIC void asm_x64_write_rex_index(asm_x64_t *as, bool force, int r64, int base_r64, int index_r64) {
+    uint8_t rex = REX_PREFIX | REX_R_FROM_R64(r64) | REX_X_FROM_R64(index_r64) | REX_B_FROM_R64(base_r64);
+    if (force || rex != REX_PREFIX) {
+        asm_x64_write_byte_1(as, rex);
+    }
+}
+
+// Writes the ModRM and SIB bytes for [base + index << scale_log2]
+STATIC void asm_x64_write_r64_index(asm_x64_t *as, int r64, int base_r64, int index_r64, int scale_log2) {
+    assert((index_r64 & 0xf) != ASM_X64_REG_RSP);
+    uint8_t sib = scale_log2 << 6 | MODRM_R64(index_r64) | MODRM_RM_R64(base_r64);
+    if ((base_r64 & 7) == ASM_X64_REG_RBP) {
+        // rbp and r13 can only be a base with a displacement
+        asm_x64_write_byte_3(as, MODRM_R64(r64) | MODRM_RM_DISP8 | MODRM_RM_SIB, sib, 0);
+    } else {
+        asm_x64_write_byte_2(as, MODRM_R64(r64) | MODRM_RM_DISP0 | MODRM_RM_SIB, sib);
+    }
+}
+
 STATIC void asm_x64_generic_r64_r64(asm_x64_t *as, int dest_r64, int src_r64, int op) {
     asm_x64_write_byte_3(as, REX_PREFIX | REX_W | REX_R_FROM_R64(src_r64) | REX_B_FROM_R64(dest_r64), op, MODRM_R64(src_r64) | MODRM_RM_REG | MODRM_RM_R64(dest_r64));
 }
@@ -252,7 +273,8 @@ void asm_x64_mov_r64_r64(asm_x64_t *as, int dest_r64, int src_r64) {
 }
 
 void asm_x64_mov_r8_to_mem8(asm_x64_t *as, int src_r64, int dest_r64, int dest_disp) {
-    if (src_r64 < 8 && dest_r64 < 8) {
+    // without a REX prefix the source registers 4-7 encode ah, ch, dh and bh
+    if (src_r64 < 4 && dest_r64 < 8) {
         asm_x64_write_byte_1(as, OPCODE_MOV_R8_TO_RM8);
     } else {
         asm_x64_write_byte_2(as, REX_PREFIX | REX_R_FROM_R64(src_r64) | REX_B_FROM_R64(dest_r64), OPCODE_MOV_R8_TO_RM8);
@@ -285,31 +307,28 @@ void asm_x64_mov_r64_to_mem64(asm_x64_t *as, int src_r64, int dest_r64, int dest
 }
 
 void asm_x64_mov_mem8_to_r64zx(asm_x64_t *as, int src_r64, int src_disp, int dest_r64) {
-    assert(src_r64 < 8);
-    if (dest_r64 < 8) {
+    if (src_r64 < 8 && dest_r64 < 8) {
         asm_x64_write_byte_2(as, 0x0f, OPCODE_MOVZX_RM8_TO_R64);
     } else {
-        asm_x64_write_byte_3(as, REX_PREFIX | REX_R, 0x0f, OPCODE_MOVZX_RM8_TO_R64);
+        asm_x64_write_byte_3(as, REX_PREFIX | REX_R_FROM_R64(dest_r64) | REX_B_FROM_R64(src_r64), 0x0f, OPCODE_MOVZX_RM8_TO_R64);
     }
     asm_x64_write_r64_disp(as, dest_r64, src_r64, src_disp);
 }
 
 void asm_x64_mov_mem16_to_r64zx(asm_x64_t *as, int src_r64, int src_disp, int dest_r64) {
-    assert(src_r64 < 8);
-    if (dest_r64 < 8) {
+    if (src_r64 < 8 && dest_r64 < 8) {
         asm_x64_write_byte_2(as, 0x0f, OPCODE_MOVZX_RM16_TO_R64);
     } else {
-        asm_x64_write_byte_3(as, REX_PREFIX | REX_R, 0x0f, OPCODE_MOVZX_RM16_TO_R64);
+        asm_x64_write_byte_3(as, REX_PREFIX | REX_R_FROM_R64(dest_r64) | REX_B_FROM_R64(src_r64), 0x0f, OPCODE_MOVZX_RM16_TO_R64);
     }
     asm_x64_write_r64_disp(as, dest_r64, src_r64, src_disp);
 }
 
 void asm_x64_mov_mem32_to_r64zx(asm_x64_t *as, int src_r64, int src_disp, int dest_r64) {
-    assert(src_r64 < 8);
-    if (dest_r64 < 8) {
+    if (src_r64 < 8 && dest_r64 < 8) {
         asm_x64_write_byte_1(as, OPCODE_MOV_RM64_TO_R64);
     } else {
-        asm_x64_write_byte_2(as, REX_PREFIX | REX_R, OPCODE_MOV_RM64_TO_R64);
+        asm_x64_write_byte_2(as, REX_PREFIX | REX_R_FROM_R64(dest_r64) | REX_B_FROM_R64(src_r64), OPCODE_MOV_RM64_TO_R64);
     }
     asm_x64_write_r64_disp(as, dest_r64, src_r64, src_disp);
 }
@@ -320,6 +339,44 @@ void asm_x64_mov_mem64_to_r64(asm_x64_t *as, int src_r64, int src_disp, int dest
     asm_x64_write_r64_disp(as, dest_r64, src_r64, src_disp);
 }
 
+void asm_x64_mov_r8_to_mem8_index(asm_x64_t *as, int src_r64, int base_r64, int index_r64) {
+    // without a REX prefix the source registers 4-7 encode ah, ch, dh and bh
+    asm_x64_write_rex_index(as, src_r64 >= 4, src_r64, base_r64, index_r64);
+    asm_x64_write_byte_1(as, OPCODE_MOV_R8_TO_RM8);
+    asm_x64_write_r64_index(as, src_r64, base_r64, index_r64, 0);
+}
+
+void asm_x64_mov_r16_to_mem16_index(asm_x64_t *as, int src_r64, int base_r64, int index_r64) {
+    asm_x64_write_byte_1(as, OP_SIZE_PREFIX);
+    asm_x64_write_rex_index(as, false, src_r64, base_r64, index_r64);
+    asm_x64_write_byte_1(as, OPCODE_MOV_R64_TO_RM64);
+    asm_x64_write_r64_index(as, src_r64, base_r64, index_r64, 1);
+}
+
+void asm_x64_mov_r32_to_mem32_index(asm_x64_t *as, int src_r64, int base_r64, int index_r64) {
+    asm_x64_write_rex_index(as, false, src_r64, base_r64, index_r64);
+    asm_x64_write_byte_1(as, OPCODE_MOV_R64_TO_RM64);
+    asm_x64_write_r64_index(as, src_r64, base_r64, index_r64, 2);
+}
+
+void asm_x64_mov_mem8_index_to_r64zx(asm_x64_t *as, int base_r64, int index_r64, int dest_r64) {
+    asm_x64_write_rex_index(as, false, dest_r64, base_r64, index_r64);
+    asm_x64_write_byte_2(as, 0x0f, OPCODE_MOVZX_RM8_TO_R64);
+    asm_x64_write_r64_index(as, dest_r64, base_r64, index_r64, 0);
+}
+
+void asm_x64_mov_mem16_index_to_r64zx(asm_x64_t *as, int base_r64, int index_r64, int dest_r64) {
+    asm_x64_write_rex_index(as, false, dest_r64, base_r64, index_r64);
+    asm_x64_write_byte_2(as, 0x0f, OPCODE_MOVZX_RM16_TO_R64);
+    asm_x64_write_r64_index(as, dest_r64, base_r64, index_r64, 1);
+}
+
+void asm_x64_mov_mem32_index_to_r64zx(asm_x64_t *as, int base_r64, int index_r64, int dest_r64) {
+    asm_x64_write_rex_index(as, false, dest_r64, base_r64, index_r64);
+    asm_x64_write_byte_1(as, OPCODE_MOV_RM64_TO_R64);
+    asm_x64_write_r64_index(as, dest_r64, base_r64, index_r64, 2);
+}
+
 STATIC void asm_x64_lea_disp_to_r64(asm_x64_t *as, int src_r64, int src_disp, int dest_r64) {
     // use REX prefix for 64 bit operation
     assert(src_r64 < 8);
@@ -466,9 +523,13 @@ void asm_x64_cmp_i32_with_r32(asm_x64_t *as, int src_i32, int src_r32) {
 */
 
 void asm_x64_test_r8_with_r8(asm_x64_t *as, int src_r64_a, int src_r64_b) {
-    assert(src_r64_a < 8);
-    assert(src_r64_b < 8);
-    asm_x64_write_byte_2(as, OPCODE_TEST_R8_WITH_RM8, MODRM_R64(src_r64_a) | MODRM_RM_REG | MODRM_RM_R64(src_r64_b));
+    if (src_r64_a < 4 && src_r64_b < 4) {
+        asm_x64_write_byte_1(as, OPCODE_TEST_R8_WITH_RM8);
+    } else {
+        // a REX prefix is needed to select the low byte of registers 4 and up
+        asm_x64_write_byte_2(as, REX_PREFIX | REX_R_FROM_R64(src_r64_a) | REX_B_FROM_R64(src_r64_b), OPCODE_TEST_R8_WITH_RM8);
+    }
+    asm_x64_write_byte_1(as, MODRM_R64(src_r64_a) | MODRM_RM_REG | MODRM_RM_R64(src_r64_b));
 }
 
 void asm_x64_test_r64_with_r64(asm_x64_t *as, int src_r64_a, int src_r64_b) {
@@ -540,6 +601,8 @@ void asm_x64_entry(asm_x64_t *as, int num_locals) {
     asm_x64_push_r64(as, ASM_X64_REG_RBX);
     asm_x64_push_r64(as, ASM_X64_REG_R12);
     asm_x64_push_r64(as, ASM_X64_REG_R13);
+    asm_x64_push_r64(as, ASM_X64_REG_R14);
+    asm_x64_push_r64(as, ASM_X64_REG_R15);
     num_locals |= 1; // make it odd so stack is aligned on 16 byte boundary
     asm_x64_sub_r64_i32(as, ASM_X64_REG_RSP, num_locals * WORD_SIZE);
     as->num_locals = num_locals;
@@ -547,6 +610,8 @@ void asm_x64_entry(asm_x64_t *as, int num_locals) {
 
 void asm_x64_exit(asm_x64_t *as) {
     asm_x64_sub_r64_i32(as, ASM_X64_REG_RSP, -as->num_locals * WORD_SIZE);
+    asm_x64_pop_r64(as, ASM_X64_REG_R15);
+    asm_x64_pop_r64(as, ASM_X64_REG_R14);
     asm_x64_pop_r64(as, ASM_X64_REG_R13);
     asm_x64_pop_r64(as, ASM_X64_REG_R12);
     asm_x64_pop_r64(as, ASM_X64_REG_RBX);
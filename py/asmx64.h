@@ -96,6 +96,12 @@ void asm_x64_mov_r64_to_mem64(asm_x64_t *as, int src_r64, int dest_r64, int dest
 void asm_x64_mov_mem8_to_r64zx(asm_x64_t *as, int src_r64, int src_disp, int dest_r64);
 void asm_x64_mov_mem16_to_r64zx(asm_x64_t *as, int src_r64, int src_disp, int dest_r64);
 void asm_x64_mov_mem32_to_r64zx(asm_x64_t *as, int src_r64, int src_disp, int dest_r64);
+void asm_x64_mov_r8_to_mem8_index(asm_x64_t *as, int src_r64, int base_r64, int index_r64);
+void asm_x64_mov_r16_to_mem16_index(asm_x64_t *as, int src_r64, int base_r64, int index_r64);
+void asm_x64_mov_r32_to_mem32_index(asm_x64_t *as, int src_r64, int base_r64, int index_r64);
+void asm_x64_mov_mem8_index_to_r64zx(asm_x64_t *as, int base_r64, int index_r64, int dest_r64);
+void asm_x64_mov_mem16_index_to_r64zx(asm_x64_t *as, int base_r64, int index_r64, int dest_r64);
+void asm_x64_mov_mem32_index_to_r64zx(asm_x64_t *as, int base_r64, int index_r64, int dest_r64);
 void asm_x64_mov_mem64_to_r64(asm_x64_t *as, int src_r64, int src_disp, int dest_r64);
 void asm_x64_and_r64_r64(asm_x64_t *as, int dest_r64, int src_r64);
 void asm_x64_or_r64_r64(asm_x64_t *as, int dest_r64, int src_r64);
@@ -147,7 +153,9 @@ void asm_x64_call_ind(asm_x64_t *as, size_t fun_id, int temp_r32);
 #define REG_LOCAL_1 ASM_X64_REG_RBX
 #define REG_LOCAL_2 ASM_X64_REG_R12
 #define REG_LOCAL_3 ASM_X64_REG_R13
-#define REG_LOCAL_NUM (3)
+#define REG_LOCAL_4 ASM_X64_REG_R14
+#define REG_LOCAL_5 ASM_X64_REG_R15
+#define REG_LOCAL_NUM (5)
 
 // Holds a pointer to mp_fun_table
 #define REG_FUN_TABLE ASM_X64_REG_FUN_TABLE
@@ -208,12 +216,18 @@ void asm_x64_call_ind(asm_x64_t *as, size_t fun_id, int temp_r32);
 #define ASM_LOAD8_REG_REG(as, reg_dest, reg_base) asm_x64_mov_mem8_to_r64zx((as), (reg_base), 0, (reg_dest))
 #define ASM_LOAD16_REG_REG(as, reg_dest, reg_base) asm_x64_mov_mem16_to_r64zx((as), (reg_base), 0, (reg_dest))
 #define ASM_LOAD32_REG_REG(as, reg_dest, reg_base) asm_x64_mov_mem32_to_r64zx((as), (reg_base), 0, (reg_dest))
+#define ASM_LOAD8_REG_REG_REG(as, reg_dest, reg_base, reg_index) asm_x64_mov_mem8_index_to_r64zx((as), (reg_base), (reg_index), (reg_dest))
+#define ASM_LOAD16_REG_REG_REG(as, reg_dest, reg_base, reg_index) asm_x64_mov_mem16_index_to_r64zx((as), (reg_base), (reg_index), (reg_dest))
+#define ASM_LOAD32_REG_REG_REG(as, reg_dest, reg_base, reg_index) asm_x64_mov_mem32_index_to_r64zx((as), (reg_base), (reg_index), (reg_dest))
 
 #define ASM_STORE_REG_REG(as, reg_src, reg_base) asm_x64_mov_r64_to_mem64((as), (reg_src), (reg_base), 0)
 #define ASM_STORE_REG_REG_OFFSET(as, reg_src, reg_base, word_offset) asm_x64_mov_r64_to_mem64((as), (reg_src), (reg_base), 8 * (word_offset))
 #define ASM_STORE8_REG_REG(as, reg_src, reg_base) asm_x64_mov_r8_to_mem8((as), (reg_src), (reg_base), 0)
 #define ASM_STORE16_REG_REG(as, reg_src, reg_base) asm_x64_mov_r16_to_mem16((as), (reg_src), (reg_base), 0)
 #define ASM_STORE32_REG_REG(as, reg_src, reg_base) asm_x64_mov_r32_to_mem32((as), (reg_src), (reg_base), 0)
+#define ASM_STORE8_REG_REG_REG(as, reg_src, reg_base, reg_index) asm_x64_mov_r8_to_mem8_index((as), (reg_src), (reg_base), (reg_index))
+#define ASM_STORE16_REG_REG_REG(as, reg_src, reg_base, reg_index) asm_x64_mov_r16_to_mem16_index((as), (reg_src), (reg_base), (reg_index))
+#define ASM_STORE32_REG_REG_REG(as, reg_src, reg_base, reg_index) asm_x64_mov_r32_to_mem32_index((as), (reg_src), (reg_base), (reg_index))
 
 #endif // GENERIC_ASM_API
 
@@ -317,7 +317,91 @@ STATIC void compile_delete_id(compiler_t *comp, qstr qst) {
     }
 }
 
+#if MICROPY_COMP_CONST_TUPLE
+STATIC mp_obj_t get_const_object(mp_parse_node_struct_t *pns);
+
+// Get the value of a constant node, if it's a constant that can go in a tuple
+STATIC bool get_const_maybe(compiler_t *comp, mp_parse_node_t pn, mp_obj_t *o) {
+    if (MP_PARSE_NODE_IS_SMALL_INT(pn)) {
+        *o = MP_OBJ_NEW_SMALL_INT(MP_PARSE_NODE_LEAF_SMALL_INT(pn));
+    } else if (MP_PARSE_NODE_IS_LEAF(pn)) {
+        uintptr_t arg = MP_PARSE_NODE_LEAF_ARG(pn);
+        switch (MP_PARSE_NODE_LEAF_KIND(pn)) {
+            case MP_PARSE_NODE_STRING:
+                *o = MP_OBJ_NEW_QSTR(arg);
+                break;
+            case MP_PARSE_NODE_BYTES:
+                // only create the actual bytes object on the last pass
+                if (comp->pass != MP_PASS_EMIT) {
+                    *o = mp_const_none;
+                } else {
+                    size_t len;
+                    const byte *data = qstr_data(arg, &len);
+                    *o = mp_obj_new_bytes(data, len);
+                }
+                break;
+            case MP_PARSE_NODE_TOKEN:
+                if (arg == MP_TOKEN_KW_NONE) {
+                    *o = mp_const_none;
+                } else if (arg == MP_TOKEN_KW_FALSE) {
+                    *o = mp_const_false;
+                } else if (arg == MP_TOKEN_KW_TRUE) {
+                    *o = mp_const_true;
+                } else if (arg == MP_TOKEN_ELLIPSIS) {
+                    *o = MP_OBJ_FROM_PTR(&mp_const_ellipsis_obj);
+                } else {
+                    return false;
+                }
+                break;
+            default:
+                return false;
+        }
+    } else if (MP_PARSE_NODE_IS_STRUCT_KIND(pn, PN_const_object)) {
+        *o = get_const_object((mp_parse_node_struct_t *)pn);
+    } else {
+        return false;
+    }
+    return true;
+}
+
+// Load a tuple whose items are all constants as a single constant object
+STATIC bool c_tuple_const(compiler_t *comp, mp_parse_node_t pn, mp_parse_node_struct_t *pns_list) {
+    size_t n = MP_PARSE_NODE_IS_NULL(pn) ? 0 : 1;
+    if (pns_list != NULL) {
+        n += MP_PARSE_NODE_STRUCT_NUM_NODES(pns_list);
+    }
+    // on passes before the last one the items are only checked, so the tuple
+    // is only created (with the actual bytes objects) on the last pass
+    mp_obj_tuple_t *tuple = NULL;
+    if (comp->pass == MP_PASS_EMIT) {
+        tuple = MP_OBJ_TO_PTR(mp_obj_new_tuple(n, NULL));
+    }
+    for (size_t i = 0; i < n; ++i) {
+        mp_parse_node_t pn_item = pn;
+        if (MP_PARSE_NODE_IS_NULL(pn)) {
+            pn_item = pns_list->nodes[i];
+        } else if (i > 0) {
+            pn_item = pns_list->nodes[i - 1];
+        }
+        mp_obj_t item;
+        if (!get_const_maybe(comp, pn_item, &item)) {
+            return false;
+        }
+        if (tuple != NULL) {
+            tuple->items[i] = item;
+        }
+    }
+    EMIT_ARG(load_const_obj, tuple == NULL ? mp_const_none : MP_OBJ_FROM_PTR(tuple));
+    return true;
+}
+#endif
+
 STATIC void c_tuple(compiler_t *comp, mp_parse_node_t pn, mp_parse_node_struct_t *pns_list) {
+    #if MICROPY_COMP_CONST_TUPLE
+    if (c_tuple_const(comp, pn, pns_list)) {
+        return;
+    }
+    #endif
     int total = 0;
     if (!MP_PARSE_NODE_IS_NULL(pn)) {
         compile_node(comp, pn);
@@ -768,6 +852,24 @@ STATIC void compile_funcdef_lambdef(compiler_t *comp, scope_t *scope, mp_parse_n
     comp->num_default_params = orig_num_default_params;
 }
 
+#if MICROPY_EMIT_NATIVE && MICROPY_DYNAMIC_COMPILER
+// When compiling with profile data, functions that the profile found to be hot
+// are compiled natively and all others to bytecode.  A function is identified by
+// the line it starts on, which is the line of its first decorator if it has any.
+STATIC uint compile_profile_emit_options(size_t line, uint emit_options) {
+    if (mp_dynamic_compiler.native_profile_lines == NULL
+        || emit_options == MP_EMIT_OPT_VIPER || emit_options == MP_EMIT_OPT_ASM) {
+        return emit_options;
+    }
+    for (size_t i = 0; i < mp_dynamic_compiler.native_profile_len; ++i) {
+        if (mp_dynamic_compiler.native_profile_lines[i] == line) {
+            return MP_EMIT_OPT_NATIVE_PYTHON;
+        }
+    }
+    return MP_EMIT_OPT_BYTECODE;
+}
+#endif
+
 // leaves function object on stack
 // returns function name
 STATIC qstr compile_funcdef_helper(compiler_t *comp, mp_parse_node_struct_t *pns, uint emit_options) {
@@ -915,6 +1017,11 @@ STATIC void compile_decorated(compiler_t *comp, mp_parse_node_struct_t *pns) {
     // compile the body (funcdef, async funcdef or classdef) and get its name
     mp_parse_node_struct_t *pns_body = (mp_parse_node_struct_t *)pns->nodes[1];
     qstr body_name = 0;
+    #if MICROPY_EMIT_NATIVE && MICROPY_DYNAMIC_COMPILER
+    if (num_built_in_decorators == 0 && MP_PARSE_NODE_STRUCT_KIND(pns_body) != PN_classdef) {
+        emit_options = compile_profile_emit_options(pns->source_line, emit_options);
+    }
+    #endif
     if (MP_PARSE_NODE_STRUCT_KIND(pns_body) == PN_funcdef) {
         body_name = compile_funcdef_helper(comp, pns_body, emit_options);
     #if MICROPY_PY_ASYNC_AWAIT
@@ -940,7 +1047,11 @@ STATIC void compile_decorated(compiler_t *comp, mp_parse_node_struct_t *pns) {
 }
 
 STATIC void compile_funcdef(compiler_t *comp, mp_parse_node_struct_t *pns) {
-    qstr fname = compile_funcdef_helper(comp, pns, comp->scope_cur->emit_options);
+    uint emit_options = comp->scope_cur->emit_options;
+    #if MICROPY_EMIT_NATIVE && MICROPY_DYNAMIC_COMPILER
+    emit_options = compile_profile_emit_options(pns->source_line, emit_options);
+    #endif
+    qstr fname = compile_funcdef_helper(comp, pns, emit_options);
     // store function object into function name
     compile_store_id(comp, fname);
 }
@@ -1958,6 +2069,17 @@ STATIC void compile_async_with_stmt(compiler_t *comp, mp_parse_node_struct_t *pn
     size_t n = mp_parse_node_extract_list(&pns->nodes[0], PN_with_stmt_list, &nodes);
     assert(n > 0);
 
+    #if MICROPY_EMIT_NATIVE
+    if (comp->pass > MP_PASS_SCOPE && comp->scope_cur->emit_options != MP_EMIT_OPT_BYTECODE) {
+        // the native emitter can't track the stack through the __aexit__ handler
+        if (comp->compile_error == MP_OBJ_NULL) {
+            comp->compile_error = mp_obj_new_exception_msg(&mp_type_NotImplementedError, MP_ERROR_TEXT("native async with"));
+            compile_error_set_line(comp, (mp_parse_node_t)pns);
+        }
+        return;
+    }
+    #endif
+
     // compile in a nested fashion
     compile_async_with_stmt_helper(comp, n, nodes, pns->nodes[1]);
 }
@@ -3484,6 +3606,78 @@ STATIC void scope_compute_things(scope_t *scope) {
     }
 }
 
+STATIC void compile_scope_code(compiler_t *comp, scope_t *scope) {
+    // need a pass to compute stack size
+    compile_scope(comp, scope, MP_PASS_STACK_SIZE);
+
+    // second last pass: compute code size
+    if (comp->compile_error == MP_OBJ_NULL) {
+        compile_scope(comp, scope, MP_PASS_CODE_SIZE);
+    }
+
+    // final pass: emit code
+    if (comp->compile_error == MP_OBJ_NULL) {
+        compile_scope(comp, scope, MP_PASS_EMIT);
+    }
+}
+
+#if MICROPY_EMIT_NATIVE && MICROPY_DYNAMIC_COMPILER
+// Try to compile the scope with the native emitter, and if it rejects the code
+// (eg the function is too big, or uses too many locals) then compile the scope
+// to bytecode instead.  The resulting raw code can be saved alongside native
+// ones in the same .mpy file.
+STATIC void compile_scope_native_with_fallback(compiler_t *comp, scope_t *scope, emit_t *emit_bc, emit_t **emit_native) {
+    nlr_buf_t nlr;
+    if (nlr_push(&nlr) == 0) {
+        compile_scope_code(comp, scope);
+        nlr_pop();
+    } else if (mp_obj_exception_match(MP_OBJ_FROM_PTR(nlr.ret_val), MP_OBJ_FROM_PTR(&mp_type_NotImplementedError))) {
+        // the native emitter and assemblers raise this for code they can't handle
+        comp->compile_error = MP_OBJ_FROM_PTR(nlr.ret_val);
+    } else {
+        nlr_jump(nlr.ret_val);
+    }
+
+    if (comp->compile_error == MP_OBJ_NULL) {
+        return;
+    }
+
+    // the failed pass may have left the native emitter in an inconsistent state,
+    // so discard it (a new one is created for the next native scope) and reset
+    // the compiler state
+    NATIVE_EMITTER(free)(*emit_native);
+    *emit_native = NULL;
+    mp_obj_t native_error = comp->compile_error;
+    comp->compile_error = MP_OBJ_NULL;
+    comp->compile_error_line = 0;
+    comp->break_label = INVALID_LABEL;
+    comp->continue_label = INVALID_LABEL;
+    comp->cur_except_level = 0;
+    comp->break_continue_except_level = 0;
+
+    scope->emit_options = MP_EMIT_OPT_BYTECODE;
+    comp->emit = emit_bc;
+    comp->emit_method_table = &emit_bc_method_table;
+    compile_scope_code(comp, scope);
+
+    #if MICROPY_WARNINGS
+    if (comp->compile_error == MP_OBJ_NULL) {
+        // report the function that fell back, and why
+        vstr_t vstr;
+        mp_print_t print;
+        vstr_init_print(&vstr, 32, &print);
+        mp_obj_print_helper(&print, native_error, PRINT_STR);
+        size_t line = MP_PARSE_NODE_IS_STRUCT(scope->pn) ? ((mp_parse_node_struct_t *)scope->pn)->source_line : 0;
+        mp_warning(NULL, "%q:%u: '%q' compiled to bytecode: %s",
+            comp->source_file, (uint)line, scope->simple_name, vstr_null_terminated_str(&vstr));
+        vstr_clear(&vstr);
+    }
+    #else
+    (void)native_error;
+    #endif
+}
+#endif
+
 #if !MICROPY_PERSISTENT_CODE_SAVE
 STATIC
 #endif
@@ -3601,17 +3795,13 @@ mp_raw_code_t *mp_compile_to_raw_code(mp_parse_tree_t *parse_tree, qstr source_f
                     break;
             }
 
-            // need a pass to compute stack size
-            compile_scope(comp, s, MP_PASS_STACK_SIZE);
-
-            // second last pass: compute code size
-            if (comp->compile_error == MP_OBJ_NULL) {
-                compile_scope(comp, s, MP_PASS_CODE_SIZE);
-            }
-
-            // final pass: emit code
-            if (comp->compile_error == MP_OBJ_NULL) {
-                compile_scope(comp, s, MP_PASS_EMIT);
+            #if MICROPY_EMIT_NATIVE && MICROPY_DYNAMIC_COMPILER
+            if (mp_dynamic_compiler.native_fallback && s->emit_options == MP_EMIT_OPT_NATIVE_PYTHON) {
+                compile_scope_native_with_fallback(comp, s, emit_bc, &emit_native);
+            } else
+            #endif
+            {
+                compile_scope_code(comp, s);
             }
         }
     }
@@ -3663,4 +3853,26 @@ mp_obj_t mp_compile(mp_parse_tree_t *parse_tree, qstr source_file, bool is_repl)
     return mp_make_function_from_raw_code(rc, MP_OBJ_NULL, MP_OBJ_NULL);
 }
 
+#if MICROPY_COMP_STREAMING
+
+typedef struct _compile_stream_t {
+    qstr source_file;
+    mp_obj_t funs;
+} compile_stream_t;
+
+STATIC void compile_stream_stmts(void *env, mp_parse_tree_t *parse_tree) {
+    compile_stream_t *cs = env;
+    mp_obj_list_append(cs->funs, mp_compile(parse_tree, cs->source_file, false));
+}
+
+// Top-level statements only refer to each other through the globals, so each
+// batch of them can be compiled as a module of its own, as soon as it is parsed.
+mp_obj_t mp_compile_stream(mp_lexer_t *lex) {
+    compile_stream_t cs = {lex->source_name, mp_obj_new_list(0, NULL)};
+    mp_parse_stream(lex, compile_stream_stmts, &cs);
+    return cs.funs;
+}
+
+#endif
+
 #endif // MICROPY_ENABLE_COMPILER
@@ -39,6 +39,12 @@
 #define BYTES_FOR_INT ((MP_BYTES_PER_OBJ_WORD * 8 + 6) / 7)
 #define DUMMY_DATA_SIZE (BYTES_FOR_INT)
 
+#define NO_LABEL ((mp_uint_t)-1)
+
+// flags for each label, found by the MP_PASS_STACK_SIZE pass
+#define LABEL_FLAG_USED (1) // a jump to the label may be reached
+#define LABEL_FLAG_FINALLY (2) // the label is the handler of a finally or with block
+
 struct _emit_t {
     // Accessed as mp_obj_t, so must be aligned as such, and we rely on the
     // memory allocator returning a suitably aligned pointer.
@@ -58,6 +64,19 @@ struct _emit_t {
     mp_uint_t max_num_labels;
     mp_uint_t *label_offsets;
 
+    #if MICROPY_COMP_BC_PEEPHOLE
+    // set after an unconditional jump, return or raise, until the next label
+    bool code_unreachable;
+    // the run of labels assigned at the current bytecode offset, which are
+    // linked through label_jump_targets until it's known what follows them
+    mp_uint_t label_run;
+    size_t label_run_offset;
+    // for each label, the label to jump to instead of it (or NO_LABEL) if the
+    // code at the label is an unconditional jump
+    mp_uint_t *label_jump_targets;
+    byte *label_flags;
+    #endif
+
     size_t code_info_offset;
     size_t code_info_size;
     size_t bytecode_offset;
@@ -83,10 +102,18 @@ emit_t *emit_bc_new(void) {
 void emit_bc_set_max_num_labels(emit_t *emit, mp_uint_t max_num_labels) {
     emit->max_num_labels = max_num_labels;
     emit->label_offsets = m_new(mp_uint_t, emit->max_num_labels);
+    #if MICROPY_COMP_BC_PEEPHOLE
+    emit->label_jump_targets = m_new(mp_uint_t, emit->max_num_labels);
+    emit->label_flags = m_new(byte, emit->max_num_labels);
+    #endif
 }
 
 void emit_bc_free(emit_t *emit) {
     m_del(mp_uint_t, emit->label_offsets, emit->max_num_labels);
+    #if MICROPY_COMP_BC_PEEPHOLE
+    m_del(mp_uint_t, emit->label_jump_targets, emit->max_num_labels);
+    m_del(byte, emit->label_flags, emit->max_num_labels);
+    #endif
     m_del_obj(emit_t, emit);
 }
 
@@ -167,6 +194,12 @@ STATIC void emit_write_code_info_bytes_lines(emit_t *emit, mp_uint_t bytes_to_sk
 
 // all functions must go through this one to emit byte code
 STATIC byte *emit_get_cur_to_write_bytecode(emit_t *emit, int num_bytes_to_write) {
+    #if MICROPY_COMP_BC_PEEPHOLE
+    if (emit->code_unreachable) {
+        // discard the bytes
+        return emit->dummy_data;
+    }
+    #endif
     if (emit->pass < MP_PASS_EMIT) {
         emit->bytecode_offset += num_bytes_to_write;
         return emit->dummy_data;
@@ -245,10 +278,19 @@ STATIC void emit_write_bytecode_byte_qstr(emit_t *emit, int stack_adj, byte b, q
 
 STATIC void emit_write_bytecode_byte_obj(emit_t *emit, int stack_adj, byte b, mp_obj_t obj) {
     #if MICROPY_PERSISTENT_CODE
+    // If the code is unreachable the object still takes a slot in the constant
+    // table, so the table has the same layout in all passes.
     emit_write_bytecode_byte_const(emit, stack_adj, b,
         emit->scope->num_pos_args + emit->scope->num_kwonly_args
         + emit->ct_cur_obj++, (mp_uint_t)obj);
     #else
+    #if MICROPY_COMP_BC_PEEPHOLE
+    if (emit->code_unreachable) {
+        // don't align the bytecode
+        mp_emit_bc_adjust_stack_size(emit, stack_adj);
+        return;
+    }
+    #endif
     // aligns the pointer so it is friendly to GC
     emit_write_bytecode_byte(emit, stack_adj, b);
     emit->bytecode_offset = (size_t)MP_ALIGN(emit->bytecode_offset, sizeof(mp_obj_t));
@@ -265,6 +307,12 @@ STATIC void emit_write_bytecode_byte_raw_code(emit_t *emit, int stack_adj, byte
         emit->scope->num_pos_args + emit->scope->num_kwonly_args
         + emit->ct_num_obj + emit->ct_cur_raw_code++, (mp_uint_t)(uintptr_t)rc);
     #else
+    #if MICROPY_COMP_BC_PEEPHOLE
+    if (emit->code_unreachable) {
+        mp_emit_bc_adjust_stack_size(emit, stack_adj);
+        return;
+    }
+    #endif
     // aligns the pointer so it is friendly to GC
     emit_write_bytecode_byte(emit, stack_adj, b);
     emit->bytecode_offset = (size_t)MP_ALIGN(emit->bytecode_offset, sizeof(void *));
@@ -278,9 +326,20 @@ STATIC void emit_write_bytecode_byte_raw_code(emit_t *emit, int stack_adj, byte
     #endif
 }
 
+#if MICROPY_COMP_BC_PEEPHOLE
+STATIC void emit_bc_mark_label_used(emit_t *emit, mp_uint_t label) {
+    if (emit->pass == MP_PASS_STACK_SIZE && !emit->code_unreachable) {
+        emit->label_flags[label] |= LABEL_FLAG_USED;
+    }
+}
+#endif
+
 // unsigned labels are relative to ip following this instruction, stored as 16 bits
 STATIC void emit_write_bytecode_byte_unsigned_label(emit_t *emit, int stack_adj, byte b1, mp_uint_t label) {
     mp_emit_bc_adjust_stack_size(emit, stack_adj);
+    #if MICROPY_COMP_BC_PEEPHOLE
+    emit_bc_mark_label_used(emit, label);
+    #endif
     mp_uint_t bytecode_offset;
     if (emit->pass < MP_PASS_EMIT) {
         bytecode_offset = 0;
@@ -296,6 +355,9 @@ STATIC void emit_write_bytecode_byte_unsigned_label(emit_t *emit, int stack_adj,
 // signed labels are relative to ip following this instruction, stored as 16 bits, in excess
 STATIC void emit_write_bytecode_byte_signed_label(emit_t *emit, int stack_adj, byte b1, mp_uint_t label) {
     mp_emit_bc_adjust_stack_size(emit, stack_adj);
+    #if MICROPY_COMP_BC_PEEPHOLE
+    emit_bc_mark_label_used(emit, label);
+    #endif
     int bytecode_offset;
     if (emit->pass < MP_PASS_EMIT) {
         bytecode_offset = 0;
@@ -308,10 +370,42 @@ STATIC void emit_write_bytecode_byte_signed_label(emit_t *emit, int stack_adj, b
     c[2] = bytecode_offset >> 8;
 }
 
+#if MICROPY_COMP_BC_PEEPHOLE
+// End the run of labels at the current offset, recording that jumps to them
+// can go to the given label instead (NO_LABEL if the code there isn't a jump)
+STATIC void emit_bc_end_label_run(emit_t *emit, mp_uint_t target) {
+    mp_uint_t l = emit->label_run;
+    while (l != NO_LABEL) {
+        mp_uint_t next = emit->label_jump_targets[l];
+        emit->label_jump_targets[l] = target;
+        l = next;
+    }
+    emit->label_run = NO_LABEL;
+}
+
+// Get the label that a jump to the given label can go to directly
+STATIC mp_uint_t emit_bc_thread_label(emit_t *emit, mp_uint_t label) {
+    if (emit->pass >= MP_PASS_CODE_SIZE) {
+        // follow a limited number of jumps, in case they form a loop
+        for (int i = 0; i < 8 && emit->label_jump_targets[label] != NO_LABEL; ++i) {
+            label = emit->label_jump_targets[label];
+        }
+    }
+    return label;
+}
+#endif
+
 void mp_emit_bc_start_pass(emit_t *emit, pass_kind_t pass, scope_t *scope) {
     emit->pass = pass;
     emit->stack_size = 0;
     emit->last_emit_was_return_value = false;
+    #if MICROPY_COMP_BC_PEEPHOLE
+    emit->code_unreachable = false;
+    emit->label_run = NO_LABEL;
+    if (pass == MP_PASS_STACK_SIZE) {
+        memset(emit->label_flags, 0, emit->max_num_labels);
+    }
+    #endif
     emit->scope = scope;
     emit->last_source_line_offset = 0;
     emit->last_source_line = 1;
@@ -396,6 +490,12 @@ void mp_emit_bc_end_pass(emit_t *emit) {
     // check stack is back to zero size
     assert(emit->stack_size == 0);
 
+    #if MICROPY_COMP_BC_PEEPHOLE
+    if (emit->pass == MP_PASS_STACK_SIZE) {
+        emit_bc_end_label_run(emit, NO_LABEL);
+    }
+    #endif
+
     emit_write_code_info_byte(emit, 0); // end of line number info
 
     // Calculate size of source code info section
@@ -491,6 +591,28 @@ void mp_emit_bc_label_assign(emit_t *emit, mp_uint_t l) {
         return;
     }
     assert(l < emit->max_num_labels);
+    #if MICROPY_COMP_BC_PEEPHOLE
+    // Code following a label is reachable if the label may be jumped to.  This
+    // is only known after the MP_PASS_STACK_SIZE pass, which assumes it is.
+    if (emit->pass == MP_PASS_STACK_SIZE || (emit->label_flags[l] & LABEL_FLAG_USED)) {
+        if (emit->code_unreachable && (emit->label_flags[l] & LABEL_FLAG_FINALLY)) {
+            // The VM uses the position of a finally handler to tell whether a
+            // return or unwind jump is inside its block, so the handler must
+            // not directly follow the last instruction of the block.
+            emit->code_unreachable = false;
+            emit_write_bytecode_raw_byte(emit, MP_BC_LOAD_CONST_NONE);
+        }
+        emit->code_unreachable = false;
+    }
+    if (emit->pass == MP_PASS_STACK_SIZE) {
+        if (emit->bytecode_offset != emit->label_run_offset) {
+            emit_bc_end_label_run(emit, NO_LABEL);
+        }
+        emit->label_jump_targets[l] = emit->label_run;
+        emit->label_run = l;
+        emit->label_run_offset = emit->bytecode_offset;
+    }
+    #endif
     if (emit->pass < MP_PASS_EMIT) {
         // assign label offset
         assert(emit->label_offsets[l] == (mp_uint_t)-1);
@@ -652,10 +774,24 @@ void mp_emit_bc_rot_three(emit_t *emit) {
 }
 
 void mp_emit_bc_jump(emit_t *emit, mp_uint_t label) {
+    #if MICROPY_COMP_BC_PEEPHOLE
+    if (emit->pass == MP_PASS_STACK_SIZE && !emit->code_unreachable
+        && emit->bytecode_offset == emit->label_run_offset) {
+        // this jump directly follows the labels in the run
+        emit_bc_end_label_run(emit, label);
+    }
+    label = emit_bc_thread_label(emit, label);
+    #endif
     emit_write_bytecode_byte_signed_label(emit, 0, MP_BC_JUMP, label);
+    #if MICROPY_COMP_BC_PEEPHOLE
+    emit->code_unreachable = true;
+    #endif
 }
 
 void mp_emit_bc_pop_jump_if(emit_t *emit, bool cond, mp_uint_t label) {
+    #if MICROPY_COMP_BC_PEEPHOLE
+    label = emit_bc_thread_label(emit, label);
+    #endif
     if (cond) {
         emit_write_bytecode_byte_signed_label(emit, -1, MP_BC_POP_JUMP_IF_TRUE, label);
     } else {
@@ -664,6 +800,9 @@ void mp_emit_bc_pop_jump_if(emit_t *emit, bool cond, mp_uint_t label) {
 }
 
 void mp_emit_bc_jump_if_or_pop(emit_t *emit, bool cond, mp_uint_t label) {
+    #if MICROPY_COMP_BC_PEEPHOLE
+    label = emit_bc_thread_label(emit, label);
+    #endif
     if (cond) {
         emit_write_bytecode_byte_signed_label(emit, -1, MP_BC_JUMP_IF_TRUE_OR_POP, label);
     } else {
@@ -686,6 +825,9 @@ void mp_emit_bc_unwind_jump(emit_t *emit, mp_uint_t label, mp_uint_t except_dept
         emit_write_bytecode_byte_signed_label(emit, 0, MP_BC_UNWIND_JUMP, label & ~MP_EMIT_BREAK_FROM_FOR);
         emit_write_bytecode_raw_byte(emit, ((label & MP_EMIT_BREAK_FROM_FOR) ? 0x80 : 0) | except_depth);
     }
+    #if MICROPY_COMP_BC_PEEPHOLE
+    emit->code_unreachable = true;
+    #endif
 }
 
 void mp_emit_bc_setup_block(emit_t *emit, mp_uint_t label, int kind) {
@@ -695,6 +837,11 @@ void mp_emit_bc_setup_block(emit_t *emit, mp_uint_t label, int kind) {
     // The SETUP_WITH opcode pops ctx_mgr from the top of the stack
     // and then pushes 3 entries: __exit__, ctx_mgr, as_value.
     int stack_adj = kind == MP_EMIT_SETUP_BLOCK_WITH ? 2 : 0;
+    #if MICROPY_COMP_BC_PEEPHOLE
+    if (emit->pass == MP_PASS_STACK_SIZE && kind != MP_EMIT_SETUP_BLOCK_EXCEPT) {
+        emit->label_flags[label] |= LABEL_FLAG_FINALLY;
+    }
+    #endif
     emit_write_bytecode_byte_unsigned_label(emit, stack_adj, MP_BC_SETUP_WITH + kind, label);
 }
 
@@ -727,6 +874,9 @@ void mp_emit_bc_for_iter_end(emit_t *emit) {
 void mp_emit_bc_pop_except_jump(emit_t *emit, mp_uint_t label, bool within_exc_handler) {
     (void)within_exc_handler;
     emit_write_bytecode_byte_unsigned_label(emit, 0, MP_BC_POP_EXCEPT_JUMP, label);
+    #if MICROPY_COMP_BC_PEEPHOLE
+    emit->code_unreachable = true;
+    #endif
 }
 
 void mp_emit_bc_unary_op(emit_t *emit, mp_unary_op_t op) {
@@ -829,6 +979,9 @@ void mp_emit_bc_call_method(emit_t *emit, mp_uint_t n_positional, mp_uint_t n_ke
 void mp_emit_bc_return_value(emit_t *emit) {
     emit_write_bytecode_byte(emit, -1, MP_BC_RETURN_VALUE);
     emit->last_emit_was_return_value = true;
+    #if MICROPY_COMP_BC_PEEPHOLE
+    emit->code_unreachable = true;
+    #endif
 }
 
 void mp_emit_bc_raise_varargs(emit_t *emit, mp_uint_t n_args) {
@@ -836,6 +989,9 @@ void mp_emit_bc_raise_varargs(emit_t *emit, mp_uint_t n_args) {
     MP_STATIC_ASSERT(MP_BC_RAISE_LAST + 2 == MP_BC_RAISE_FROM);
     assert(n_args <= 2);
     emit_write_bytecode_byte(emit, -n_args, MP_BC_RAISE_LAST + n_args);
+    #if MICROPY_COMP_BC_PEEPHOLE
+    emit->code_unreachable = true;
+    #endif
 }
 
 void mp_emit_bc_yield(emit_t *emit, int kind) {
@@ -133,6 +133,13 @@
 
 #define REG_GENERATOR_STATE (REG_LOCAL_3)
 
+// Weight multiplier applied to uses of a local for each loop that encloses them,
+// when choosing which locals to keep in registers
+#define LOCAL_USE_LOOP_WEIGHT (8)
+
+// Whether an immediate viper index, scaled by up to 4, fits in a signed 32-bit displacement
+#define VIPER_INDEX_FITS_DISP32(index) ((index) >= -0x20000000 && (index) < 0x20000000)
+
 #define EMIT_NATIVE_VIPER_TYPE_ERROR(emit, ...) do { \
         *emit->error_slot = mp_obj_new_exception_msg_varg(&mp_type_ViperTypeError, __VA_ARGS__); \
 } while (0)
@@ -197,6 +204,13 @@ typedef struct _stack_info_t {
 #define UNWIND_LABEL_UNUSED (0x7fff)
 #define UNWIND_LABEL_DO_FINAL_UNWIND (0x7ffe)
 
+// A use of a local, recorded while working out which locals to keep in registers
+typedef struct _local_use_t {
+    size_t code_pos;
+    uint16_t local_num;
+    uint16_t weight;
+} local_use_t;
+
 typedef struct _exc_stack_entry_t {
     uint16_t label : 15;
     uint16_t is_finally : 1;
@@ -216,6 +230,12 @@ struct _emit_t {
     mp_uint_t local_vtype_alloc;
     vtype_kind_t *local_vtype;
 
+    // locals held in each of the reg_local_table registers, or REG_LOCAL_NONE
+    uint16_t reg_local_num[REG_LOCAL_NUM];
+    size_t local_use_alloc;
+    size_t local_use_len;
+    local_use_t *local_use;
+
     mp_uint_t stack_info_alloc;
     stack_info_t *stack_info;
     vtype_kind_t saved_stack_vtype;
@@ -249,7 +269,13 @@ struct _emit_t {
     ASM_T *as;
 };
 
+#if REG_LOCAL_NUM > 3
+STATIC const uint8_t reg_local_table[REG_LOCAL_NUM] = {REG_LOCAL_1, REG_LOCAL_2, REG_LOCAL_3, REG_LOCAL_4, REG_LOCAL_5};
+#else
 STATIC const uint8_t reg_local_table[REG_LOCAL_NUM] = {REG_LOCAL_1, REG_LOCAL_2, REG_LOCAL_3};
+#endif
+
+#define REG_LOCAL_NONE (0xffff)
 
 STATIC void emit_native_global_exc_entry(emit_t *emit);
 STATIC void emit_native_global_exc_exit(emit_t *emit);
@@ -273,6 +299,7 @@ void EXPORT_FUN(free)(emit_t * emit) {
     m_del_obj(ASM_T, emit->as);
     m_del(exc_stack_entry_t, emit->exc_stack, emit->exc_stack_alloc);
     m_del(vtype_kind_t, emit->local_vtype, emit->local_vtype_alloc);
+    m_del(local_use_t, emit->local_use, emit->local_use_alloc);
     m_del(stack_info_t, emit->stack_info, emit->stack_info_alloc);
     m_del_obj(emit_t, emit);
 }
@@ -283,6 +310,76 @@ STATIC void emit_native_mov_reg_const(emit_t *emit, int reg_dest, int const_val)
     ASM_LOAD_REG_REG_OFFSET(emit->as, reg_dest, REG_FUN_TABLE, const_val);
 }
 
+// Returns the register that holds the given local, or -1 if it's in the state
+STATIC int emit_native_local_reg(emit_t *emit, mp_uint_t local_num) {
+    if (CAN_USE_REGS_FOR_LOCALS(emit)) {
+        for (int i = 0; i < REG_LOCAL_NUM; ++i) {
+            if (emit->reg_local_num[i] == local_num) {
+                return reg_local_table[i];
+            }
+        }
+    }
+    return -1;
+}
+
+// In the stack-size pass, record a use of a local so that the most used ones,
+// weighted by how deeply they are nested in loops, can be put in registers
+STATIC void emit_native_record_local_use(emit_t *emit, mp_uint_t local_num) {
+    if (emit->pass != MP_PASS_STACK_SIZE || !CAN_USE_REGS_FOR_LOCALS(emit)) {
+        return;
+    }
+    if (emit->local_use_len >= emit->local_use_alloc) {
+        emit->local_use = m_renew(local_use_t, emit->local_use, emit->local_use_alloc, emit->local_use_alloc + 32);
+        emit->local_use_alloc += 32;
+    }
+    local_use_t *u = &emit->local_use[emit->local_use_len++];
+    u->code_pos = mp_asm_base_get_code_pos(&emit->as->base);
+    u->local_num = local_num;
+    u->weight = 1;
+}
+
+// In the stack-size pass, a jump back to an already-assigned label closes a
+// loop, so increase the weight of the uses of locals within that loop
+STATIC void emit_native_record_jump(emit_t *emit, mp_uint_t label) {
+    if (emit->pass != MP_PASS_STACK_SIZE) {
+        return;
+    }
+    size_t label_pos = emit->as->base.label_offsets[label];
+    if (label_pos == (size_t)-1) {
+        // forward jump
+        return;
+    }
+    for (size_t i = emit->local_use_len; i > 0 && emit->local_use[i - 1].code_pos >= label_pos; --i) {
+        local_use_t *u = &emit->local_use[i - 1];
+        u->weight = MIN(0xffff, u->weight * LOCAL_USE_LOOP_WEIGHT);
+    }
+}
+
+// At the end of the stack-size pass, pick the locals to keep in registers for
+// the remaining passes: those with the largest total weight of uses
+STATIC void emit_native_assign_local_regs(emit_t *emit) {
+    mp_uint_t num_locals = emit->scope->num_locals;
+    uint32_t *weight = m_new0(uint32_t, num_locals);
+    for (size_t i = 0; i < emit->local_use_len; ++i) {
+        weight[emit->local_use[i].local_num] += emit->local_use[i].weight;
+    }
+    for (int r = 0; r < REG_LOCAL_NUM; ++r) {
+        uint32_t best_weight = 0;
+        mp_uint_t best = REG_LOCAL_NONE;
+        for (mp_uint_t i = 0; i < num_locals; ++i) {
+            if (weight[i] > best_weight) {
+                best_weight = weight[i];
+                best = i;
+            }
+        }
+        emit->reg_local_num[r] = best;
+        if (best != REG_LOCAL_NONE) {
+            weight[best] = 0;
+        }
+    }
+    m_del(uint32_t, weight, num_locals);
+}
+
 STATIC void emit_native_mov_state_reg(emit_t *emit, int local_num, int reg_src) {
     if (emit->scope->scope_flags & MP_SCOPE_FLAG_GENERATOR) {
         ASM_STORE_REG_REG_OFFSET(emit->as, reg_src, REG_GENERATOR_STATE, local_num);
@@ -376,6 +473,14 @@ STATIC void emit_native_start_pass(emit_t *emit, pass_kind_t pass, scope_t *scop
         emit->local_vtype_alloc = scope->num_locals;
     }
 
+    // the first locals are held in registers until their uses have been counted
+    if (pass == MP_PASS_STACK_SIZE) {
+        for (mp_uint_t i = 0; i < REG_LOCAL_NUM; ++i) {
+            emit->reg_local_num[i] = i < scope->num_locals ? i : REG_LOCAL_NONE;
+        }
+        emit->local_use_len = 0;
+    }
+
     // set default type for arguments
     mp_uint_t num_args = emit->scope->num_pos_args + emit->scope->num_kwonly_args;
     if (scope->scope_flags & MP_SCOPE_FLAG_VARARGS) {
@@ -424,17 +529,6 @@ STATIC void emit_native_start_pass(emit_t *emit, pass_kind_t pass, scope_t *scop
         // Work out size of state (locals plus stack)
         // n_state counts all stack and locals, even those in registers
         emit->n_state = scope->num_locals + scope->stack_size;
-        int num_locals_in_regs = 0;
-        if (CAN_USE_REGS_FOR_LOCALS(emit)) {
-            num_locals_in_regs = scope->num_locals;
-            if (num_locals_in_regs > REG_LOCAL_NUM) {
-                num_locals_in_regs = REG_LOCAL_NUM;
-            }
-            // Need a spot for REG_LOCAL_3 if 4 or more args (see below)
-            if (scope->num_pos_args >= 4) {
-                --num_locals_in_regs;
-            }
-        }
 
         // Work out where the locals and Python stack start within the C stack
         if (NEED_GLOBAL_EXC_HANDLER(emit)) {
@@ -448,7 +542,7 @@ STATIC void emit_native_start_pass(emit_t *emit, pass_kind_t pass, scope_t *scop
         }
 
         // Entry to function
-        ASM_ENTRY(emit->as, emit->stack_start + emit->n_state - num_locals_in_regs);
+        ASM_ENTRY(emit->as, emit->stack_start + emit->n_state);
 
         #if N_X86
         asm_x86_mov_arg_to_r32(emit->as, 0, REG_PARENT_ARG_1);
@@ -492,15 +586,17 @@ STATIC void emit_native_start_pass(emit_t *emit, pass_kind_t pass, scope_t *scop
                 r = REG_RET;
             }
             // REG_LOCAL_3 points to the args array so be sure not to overwrite it if it's still needed
-            if (i < REG_LOCAL_NUM && CAN_USE_REGS_FOR_LOCALS(emit) && (i != 2 || emit->scope->num_pos_args == 3)) {
-                ASM_MOV_REG_REG(emit->as, reg_local_table[i], r);
+            int reg_local = emit_native_local_reg(emit, i);
+            if (reg_local != -1 && (reg_local != REG_LOCAL_3 || i == emit->scope->num_pos_args - 1)) {
+                ASM_MOV_REG_REG(emit->as, reg_local, r);
             } else {
                 emit_native_mov_state_reg(emit, LOCAL_IDX_LOCAL_VAR(emit, i), r);
             }
         }
-        // Get 3rd local from the stack back into REG_LOCAL_3 if this reg couldn't be written to above
-        if (emit->scope->num_pos_args >= 4 && CAN_USE_REGS_FOR_LOCALS(emit)) {
-            ASM_MOV_REG_LOCAL(emit->as, REG_LOCAL_3, LOCAL_IDX_LOCAL_VAR(emit, 2));
+        // Get the arg for REG_LOCAL_3 from the stack if this reg couldn't be written to above
+        mp_uint_t local_3 = emit->reg_local_num[2];
+        if (CAN_USE_REGS_FOR_LOCALS(emit) && local_3 + 1 < emit->scope->num_pos_args) {
+            ASM_MOV_REG_LOCAL(emit->as, REG_LOCAL_3, LOCAL_IDX_LOCAL_VAR(emit, local_3));
         }
 
         emit_native_global_exc_entry(emit);
@@ -616,8 +712,10 @@ STATIC void emit_native_start_pass(emit_t *emit, pass_kind_t pass, scope_t *scop
 
         // cache some locals in registers, but only if no exception handlers
         if (CAN_USE_REGS_FOR_LOCALS(emit)) {
-            for (int i = 0; i < REG_LOCAL_NUM && i < scope->num_locals; ++i) {
-                ASM_MOV_REG_LOCAL(emit->as, reg_local_table[i], LOCAL_IDX_LOCAL_VAR(emit, i));
+            for (int i = 0; i < REG_LOCAL_NUM; ++i) {
+                if (emit->reg_local_num[i] != REG_LOCAL_NONE) {
+                    ASM_MOV_REG_LOCAL(emit->as, reg_local_table[i], LOCAL_IDX_LOCAL_VAR(emit, emit->reg_local_num[i]));
+                }
             }
         }
 
@@ -655,6 +753,10 @@ static inline void emit_native_write_code_info_byte(emit_t *emit, byte val) {
 STATIC void emit_native_end_pass(emit_t *emit) {
     emit_native_global_exc_exit(emit);
 
+    if (emit->pass == MP_PASS_STACK_SIZE && CAN_USE_REGS_FOR_LOCALS(emit)) {
+        emit_native_assign_local_regs(emit);
+    }
+
     if (!emit->do_viper_types) {
         emit->prelude_offset = mp_asm_base_get_code_pos(&emit->as->base);
 
@@ -1442,8 +1544,10 @@ STATIC void emit_native_load_fast(emit_t *emit, qstr qst, mp_uint_t local_num) {
         EMIT_NATIVE_VIPER_TYPE_ERROR(emit, MP_ERROR_TEXT("local '%q' used before type known"), qst);
     }
     emit_native_pre(emit);
-    if (local_num < REG_LOCAL_NUM && CAN_USE_REGS_FOR_LOCALS(emit)) {
-        emit_post_push_reg(emit, vtype, reg_local_table[local_num]);
+    emit_native_record_local_use(emit, local_num);
+    int reg_local = emit_native_local_reg(emit, local_num);
+    if (reg_local != -1) {
+        emit_post_push_reg(emit, vtype, reg_local);
     } else {
         need_reg_single(emit, REG_TEMP0, 0);
         emit_native_mov_reg_state(emit, REG_TEMP0, LOCAL_IDX_LOCAL_VAR(emit, local_num));
@@ -1559,10 +1663,13 @@ STATIC void emit_native_load_subscr(emit_t *emit) {
             int reg_base = REG_ARG_1;
             int reg_index = REG_ARG_2;
             emit_pre_pop_reg_flexible(emit, &vtype_base, &reg_base, reg_index, reg_index);
+            // the base may have come from a local register, so make sure no
+            // remaining stack entry lives in the scratch registers we write
+            need_reg_single(emit, reg_index, 0);
+            need_reg_single(emit, REG_RET, 0);
             switch (vtype_base) {
                 case VTYPE_PTR8: {
                     // pointer to 8-bit memory
-                    // TODO optimise to use thumb ldrb r1, [r2, r3]
                     if (index_value != 0) {
                         // index is non-zero
                         #if N_THUMB
@@ -1571,6 +1678,17 @@ STATIC void emit_native_load_subscr(emit_t *emit) {
                             break;
                         }
                         #endif
+                        #if N_X64
+                        if (VIPER_INDEX_FITS_DISP32(index_value)) {
+                            asm_x64_mov_mem8_to_r64zx(emit->as, reg_base, index_value, REG_RET);
+                            break;
+                        }
+                        #endif
+                        #ifdef ASM_LOAD8_REG_REG_REG
+                        ASM_MOV_REG_IMM(emit->as, reg_index, index_value);
+                        ASM_LOAD8_REG_REG_REG(emit->as, REG_RET, reg_base, reg_index); // load from (base+index)
+                        break;
+                        #endif
                         ASM_MOV_REG_IMM(emit->as, reg_index, index_value);
                         ASM_ADD_REG_REG(emit->as, reg_index, reg_base); // add index to base
                         reg_base = reg_index;
@@ -1588,6 +1706,17 @@ STATIC void emit_native_load_subscr(emit_t *emit) {
                             break;
                         }
                         #endif
+                        #if N_X64
+                        if (VIPER_INDEX_FITS_DISP32(index_value)) {
+                            asm_x64_mov_mem16_to_r64zx(emit->as, reg_base, index_value << 1, REG_RET);
+                            break;
+                        }
+                        #endif
+                        #ifdef ASM_LOAD16_REG_REG_REG
+                        ASM_MOV_REG_IMM(emit->as, reg_index, index_value);
+                        ASM_LOAD16_REG_REG_REG(emit->as, REG_RET, reg_base, reg_index); // load from (base+2*index)
+                        break;
+                        #endif
                         ASM_MOV_REG_IMM(emit->as, reg_index, index_value << 1);
                         ASM_ADD_REG_REG(emit->as, reg_index, reg_base); // add 2*index to base
                         reg_base = reg_index;
@@ -1605,6 +1734,17 @@ STATIC void emit_native_load_subscr(emit_t *emit) {
                             break;
                         }
                         #endif
+                        #if N_X64
+                        if (VIPER_INDEX_FITS_DISP32(index_value)) {
+                            asm_x64_mov_mem32_to_r64zx(emit->as, reg_base, index_value << 2, REG_RET);
+                            break;
+                        }
+                        #endif
+                        #ifdef ASM_LOAD32_REG_REG_REG
+                        ASM_MOV_REG_IMM(emit->as, reg_index, index_value);
+                        ASM_LOAD32_REG_REG_REG(emit->as, REG_RET, reg_base, reg_index); // load from (base+4*index)
+                        break;
+                        #endif
                         ASM_MOV_REG_IMM(emit->as, reg_index, index_value << 2);
                         ASM_ADD_REG_REG(emit->as, reg_index, reg_base); // add 4*index to base
                         reg_base = reg_index;
@@ -1622,6 +1762,7 @@ STATIC void emit_native_load_subscr(emit_t *emit) {
             int reg_index = REG_ARG_2;
             emit_pre_pop_reg_flexible(emit, &vtype_index, &reg_index, REG_ARG_1, REG_ARG_1);
             emit_pre_pop_reg(emit, &vtype_base, REG_ARG_1);
+            need_reg_single(emit, REG_RET, 0);
             if (vtype_index != VTYPE_INT && vtype_index != VTYPE_UINT) {
                 EMIT_NATIVE_VIPER_TYPE_ERROR(emit,
                     MP_ERROR_TEXT("can't load with '%q' index"), vtype_to_qstr(vtype_index));
@@ -1629,13 +1770,20 @@ STATIC void emit_native_load_subscr(emit_t *emit) {
             switch (vtype_base) {
                 case VTYPE_PTR8: {
                     // pointer to 8-bit memory
-                    // TODO optimise to use thumb ldrb r1, [r2, r3]
+                    #ifdef ASM_LOAD8_REG_REG_REG
+                    ASM_LOAD8_REG_REG_REG(emit->as, REG_RET, REG_ARG_1, reg_index); // load from (base+index)
+                    break;
+                    #endif
                     ASM_ADD_REG_REG(emit->as, REG_ARG_1, reg_index); // add index to base
                     ASM_LOAD8_REG_REG(emit->as, REG_RET, REG_ARG_1); // store value to (base+index)
                     break;
                 }
                 case VTYPE_PTR16: {
                     // pointer to 16-bit memory
+                    #ifdef ASM_LOAD16_REG_REG_REG
+                    ASM_LOAD16_REG_REG_REG(emit->as, REG_RET, REG_ARG_1, reg_index); // load from (base+2*index)
+                    break;
+                    #endif
                     ASM_ADD_REG_REG(emit->as, REG_ARG_1, reg_index); // add index to base
                     ASM_ADD_REG_REG(emit->as, REG_ARG_1, reg_index); // add index to base
                     ASM_LOAD16_REG_REG(emit->as, REG_RET, REG_ARG_1); // load from (base+2*index)
@@ -1643,6 +1791,10 @@ STATIC void emit_native_load_subscr(emit_t *emit) {
                 }
                 case VTYPE_PTR32: {
                     // pointer to word-size memory
+                    #ifdef ASM_LOAD32_REG_REG_REG
+                    ASM_LOAD32_REG_REG_REG(emit->as, REG_RET, REG_ARG_1, reg_index); // load from (base+4*index)
+                    break;
+                    #endif
                     ASM_ADD_REG_REG(emit->as, REG_ARG_1, reg_index); // add index to base
                     ASM_ADD_REG_REG(emit->as, REG_ARG_1, reg_index); // add index to base
                     ASM_ADD_REG_REG(emit->as, REG_ARG_1, reg_index); // add index to base
@@ -1661,8 +1813,10 @@ STATIC void emit_native_load_subscr(emit_t *emit) {
 
 STATIC void emit_native_store_fast(emit_t *emit, qstr qst, mp_uint_t local_num) {
     vtype_kind_t vtype;
-    if (local_num < REG_LOCAL_NUM && CAN_USE_REGS_FOR_LOCALS(emit)) {
-        emit_pre_pop_reg(emit, &vtype, reg_local_table[local_num]);
+    emit_native_record_local_use(emit, local_num);
+    int reg_local = emit_native_local_reg(emit, local_num);
+    if (reg_local != -1) {
+        emit_pre_pop_reg(emit, &vtype, reg_local);
     } else {
         emit_pre_pop_reg(emit, &vtype, REG_TEMP0);
         emit_native_mov_state_reg(emit, LOCAL_IDX_LOCAL_VAR(emit, local_num), REG_TEMP0);
@@ -1775,6 +1929,7 @@ STATIC void emit_native_store_subscr(emit_t *emit) {
             #else
             emit_pre_pop_reg_flexible(emit, &vtype_value, &reg_value, reg_base, reg_index);
             #endif
+            need_reg_single(emit, reg_index, 0);
             if (vtype_value != VTYPE_BOOL && vtype_value != VTYPE_INT && vtype_value != VTYPE_UINT) {
                 EMIT_NATIVE_VIPER_TYPE_ERROR(emit,
                     MP_ERROR_TEXT("can't store '%q'"), vtype_to_qstr(vtype_value));
@@ -1782,7 +1937,6 @@ STATIC void emit_native_store_subscr(emit_t *emit) {
             switch (vtype_base) {
                 case VTYPE_PTR8: {
                     // pointer to 8-bit memory
-                    // TODO optimise to use thumb strb r1, [r2, r3]
                     if (index_value != 0) {
                         // index is non-zero
                         #if N_THUMB
@@ -1791,10 +1945,16 @@ STATIC void emit_native_store_subscr(emit_t *emit) {
                             break;
                         }
                         #endif
+                        #if N_X64
+                        if (VIPER_INDEX_FITS_DISP32(index_value)) {
+                            asm_x64_mov_r8_to_mem8(emit->as, reg_value, reg_base, index_value);
+                            break;
+                        }
+                        #endif
                         ASM_MOV_REG_IMM(emit->as, reg_index, index_value);
-                        #if N_ARM
-                        asm_arm_strb_reg_reg_reg(emit->as, reg_value, reg_base, reg_index);
-                        return;
+                        #ifdef ASM_STORE8_REG_REG_REG
+                        ASM_STORE8_REG_REG_REG(emit->as, reg_value, reg_base, reg_index); // store value to (base+index)
+                        break;
                         #endif
                         ASM_ADD_REG_REG(emit->as, reg_index, reg_base); // add index to base
                         reg_base = reg_index;
@@ -1812,6 +1972,17 @@ STATIC void emit_native_store_subscr(emit_t *emit) {
                             break;
                         }
                         #endif
+                        #if N_X64
+                        if (VIPER_INDEX_FITS_DISP32(index_value)) {
+                            asm_x64_mov_r16_to_mem16(emit->as, reg_value, reg_base, index_value << 1);
+                            break;
+                        }
+                        #endif
+                        #ifdef ASM_STORE16_REG_REG_REG
+                        ASM_MOV_REG_IMM(emit->as, reg_index, index_value);
+                        ASM_STORE16_REG_REG_REG(emit->as, reg_value, reg_base, reg_index); // store value to (base+2*index)
+                        break;
+                        #endif
                         ASM_MOV_REG_IMM(emit->as, reg_index, index_value << 1);
                         ASM_ADD_REG_REG(emit->as, reg_index, reg_base); // add 2*index to base
                         reg_base = reg_index;
@@ -1829,10 +2000,16 @@ STATIC void emit_native_store_subscr(emit_t *emit) {
                             break;
                         }
                         #endif
-                        #if N_ARM
+                        #if N_X64
+                        if (VIPER_INDEX_FITS_DISP32(index_value)) {
+                            asm_x64_mov_r32_to_mem32(emit->as, reg_value, reg_base, index_value << 2);
+                            break;
+                        }
+                        #endif
+                        #ifdef ASM_STORE32_REG_REG_REG
                         ASM_MOV_REG_IMM(emit->as, reg_index, index_value);
-                        asm_arm_str_reg_reg_reg(emit->as, reg_value, reg_base, reg_index);
-                        return;
+                        ASM_STORE32_REG_REG_REG(emit->as, reg_value, reg_base, reg_index); // store value to (base+4*index)
+                        break;
                         #endif
                         ASM_MOV_REG_IMM(emit->as, reg_index, index_value << 2);
                         ASM_ADD_REG_REG(emit->as, reg_index, reg_base); // add 4*index to base
@@ -1869,9 +2046,8 @@ STATIC void emit_native_store_subscr(emit_t *emit) {
             switch (vtype_base) {
                 case VTYPE_PTR8: {
                     // pointer to 8-bit memory
-                    // TODO optimise to use thumb strb r1, [r2, r3]
-                    #if N_ARM
-                    asm_arm_strb_reg_reg_reg(emit->as, reg_value, REG_ARG_1, reg_index);
+                    #ifdef ASM_STORE8_REG_REG_REG
+                    ASM_STORE8_REG_REG_REG(emit->as, reg_value, REG_ARG_1, reg_index); // store value to (base+index)
                     break;
                     #endif
                     ASM_ADD_REG_REG(emit->as, REG_ARG_1, reg_index); // add index to base
@@ -1880,8 +2056,8 @@ STATIC void emit_native_store_subscr(emit_t *emit) {
                 }
                 case VTYPE_PTR16: {
                     // pointer to 16-bit memory
-                    #if N_ARM
-                    asm_arm_strh_reg_reg_reg(emit->as, reg_value, REG_ARG_1, reg_index);
+                    #ifdef ASM_STORE16_REG_REG_REG
+                    ASM_STORE16_REG_REG_REG(emit->as, reg_value, REG_ARG_1, reg_index); // store value to (base+2*index)
                     break;
                     #endif
                     ASM_ADD_REG_REG(emit->as, REG_ARG_1, reg_index); // add index to base
@@ -1891,8 +2067,8 @@ STATIC void emit_native_store_subscr(emit_t *emit) {
                 }
                 case VTYPE_PTR32: {
                     // pointer to 32-bit memory
-                    #if N_ARM
-                    asm_arm_str_reg_reg_reg(emit->as, reg_value, REG_ARG_1, reg_index);
+                    #ifdef ASM_STORE32_REG_REG_REG
+                    ASM_STORE32_REG_REG_REG(emit->as, reg_value, REG_ARG_1, reg_index); // store value to (base+4*index)
                     break;
                     #endif
                     ASM_ADD_REG_REG(emit->as, REG_ARG_1, reg_index); // add index to base
@@ -2007,6 +2183,7 @@ STATIC void emit_native_jump(emit_t *emit, mp_uint_t label) {
     emit_native_pre(emit);
     // need to commit stack because we are jumping elsewhere
     need_stack_settled(emit);
+    emit_native_record_jump(emit, label);
     ASM_JUMP(emit->as, label);
     emit_post(emit);
 }
@@ -2036,6 +2213,7 @@ STATIC void emit_native_jump_helper(emit_t *emit, bool cond, mp_uint_t label, bo
     }
     // need to commit stack because we may jump elsewhere
     need_stack_settled(emit);
+    emit_native_record_jump(emit, label);
     // Emit the jump
     if (cond) {
         ASM_JUMP_IF_REG_NONZERO(emit->as, REG_RET, label, vtype == VTYPE_PYOBJ);
@@ -2833,8 +3011,10 @@ STATIC void emit_native_return_value(emit_t *emit) {
 }
 
 STATIC void emit_native_raise_varargs(emit_t *emit, mp_uint_t n_args) {
-    (void)n_args;
-    assert(n_args == 1);
+    if (n_args != 1) {
+        // re-raise and "raise ... from ..." are not supported
+        mp_raise_NotImplementedError(MP_ERROR_TEXT("native raise"));
+    }
     vtype_kind_t vtype_exc;
     emit_pre_pop_reg(emit, &vtype_exc, REG_ARG_1); // arg1 = object to raise
     if (vtype_exc != VTYPE_PYOBJ) {
@@ -32,6 +32,14 @@
 #include "py/gc.h"
 #include "py/runtime.h"
 
+#if MICROPY_GC_INCREMENTAL_SWEEP || MICROPY_GC_PROFILE
+#include "py/mphal.h"
+#endif
+
+#if MICROPY_GC_PROFILE
+#include "py/bc.h"
+#endif
+
 #if MICROPY_ENABLE_GC
 
 #if MICROPY_DEBUG_VERBOSE // print debugging info
@@ -75,26 +83,39 @@
 #define ATB_3_IS_FREE(a) (((a) & ATB_MASK_3) == 0)
 
 #define BLOCK_SHIFT(block) (2 * ((block) & (BLOCKS_PER_ATB - 1)))
-#define ATB_GET_KIND(block) ((MP_STATE_MEM(gc_alloc_table_start)[(block) / BLOCKS_PER_ATB] >> BLOCK_SHIFT(block)) & 3)
-#define ATB_ANY_TO_FREE(block) do { MP_STATE_MEM(gc_alloc_table_start)[(block) / BLOCKS_PER_ATB] &= (~(AT_MARK << BLOCK_SHIFT(block))); } while (0)
-#define ATB_FREE_TO_HEAD(block) do { MP_STATE_MEM(gc_alloc_table_start)[(block) / BLOCKS_PER_ATB] |= (AT_HEAD << BLOCK_SHIFT(block)); } while (0)
-#define ATB_FREE_TO_TAIL(block) do { MP_STATE_MEM(gc_alloc_table_start)[(block) / BLOCKS_PER_ATB] |= (AT_TAIL << BLOCK_SHIFT(block)); } while (0)
-#define ATB_HEAD_TO_MARK(block) do { MP_STATE_MEM(gc_alloc_table_start)[(block) / BLOCKS_PER_ATB] |= (AT_MARK << BLOCK_SHIFT(block)); } while (0)
-#define ATB_MARK_TO_HEAD(block) do { MP_STATE_MEM(gc_alloc_table_start)[(block) / BLOCKS_PER_ATB] &= (~(AT_TAIL << BLOCK_SHIFT(block))); } while (0)
-
-#define BLOCK_FROM_PTR(ptr) (((byte *)(ptr) - MP_STATE_MEM(gc_pool_start)) / BYTES_PER_BLOCK)
-#define PTR_FROM_BLOCK(block) (((block) * BYTES_PER_BLOCK + (uintptr_t)MP_STATE_MEM(gc_pool_start)))
+#define ATB_GET_KIND(area, block) (((area)->gc_alloc_table_start[(block) / BLOCKS_PER_ATB] >> BLOCK_SHIFT(block)) & 3)
+#define ATB_ANY_TO_FREE(area, block) do { (area)->gc_alloc_table_start[(block) / BLOCKS_PER_ATB] &= (~(AT_MARK << BLOCK_SHIFT(block))); } while (0)
+#define ATB_FREE_TO_HEAD(area, block) do { (area)->gc_alloc_table_start[(block) / BLOCKS_PER_ATB] |= (AT_HEAD << BLOCK_SHIFT(block)); } while (0)
+#define ATB_FREE_TO_TAIL(area, block) do { (area)->gc_alloc_table_start[(block) / BLOCKS_PER_ATB] |= (AT_TAIL << BLOCK_SHIFT(block)); } while (0)
+#define ATB_HEAD_TO_MARK(area, block) do { (area)->gc_alloc_table_start[(block) / BLOCKS_PER_ATB] |= (AT_MARK << BLOCK_SHIFT(block)); } while (0)
+#define ATB_MARK_TO_HEAD(area, block) do { (area)->gc_alloc_table_start[(block) / BLOCKS_PER_ATB] &= (~(AT_TAIL << BLOCK_SHIFT(block))); } while (0)
+
+#if MICROPY_GC_INCREMENTAL_SWEEP
+// heads that a deferred sweep has yet to reach may still be marked
+#define ATB_IS_HEAD(area, block) ((ATB_GET_KIND(area, block) & AT_HEAD) != 0)
+#else
+#define ATB_IS_HEAD(area, block) (ATB_GET_KIND(area, block) == AT_HEAD)
+#endif
+
+#define BLOCK_FROM_PTR(area, ptr) (((byte *)(ptr) - (area)->gc_pool_start) / BYTES_PER_BLOCK)
+#define PTR_FROM_BLOCK(area, block) (((block) * BYTES_PER_BLOCK + (uintptr_t)(area)->gc_pool_start))
 #define ATB_FROM_BLOCK(bl) ((bl) / BLOCKS_PER_ATB)
 
+#if MICROPY_GC_SPLIT_HEAP
+#define NEXT_AREA(area) ((area)->next)
+#else
+#define NEXT_AREA(area) (NULL)
+#endif
+
 #if MICROPY_ENABLE_FINALISER
 // FTB = finaliser table byte
 // if set, then the corresponding block may have a finaliser
 
 #define BLOCKS_PER_FTB (8)
 
-#define FTB_GET(block) ((MP_STATE_MEM(gc_finaliser_table_start)[(block) / BLOCKS_PER_FTB] >> ((block) & 7)) & 1)
-#define FTB_SET(block) do { MP_STATE_MEM(gc_finaliser_table_start)[(block) / BLOCKS_PER_FTB] |= (1 << ((block) & 7)); } while (0)
-#define FTB_CLEAR(block) do { MP_STATE_MEM(gc_finaliser_table_start)[(block) / BLOCKS_PER_FTB] &= (~(1 << ((block) & 7))); } while (0)
+#define FTB_GET(area, block) (((area)->gc_finaliser_table_start[(block) / BLOCKS_PER_FTB] >> ((block) & 7)) & 1)
+#define FTB_SET(area, block) do { (area)->gc_finaliser_table_start[(block) / BLOCKS_PER_FTB] |= (1 << ((block) & 7)); } while (0)
+#define FTB_CLEAR(area, block) do { (area)->gc_finaliser_table_start[(block) / BLOCKS_PER_FTB] &= (~(1 << ((block) & 7))); } while (0)
 #endif
 
 #if MICROPY_PY_THREAD && !MICROPY_PY_THREAD_GIL
@@ -106,11 +127,7 @@
 #endif
 
 // TODO waste less memory; currently requires that all entries in alloc_table have a corresponding block in pool
-void gc_init(void *start, void *end) {
-    // align end pointer on block boundary
-    end = (void *)((uintptr_t)end & (~(BYTES_PER_BLOCK - 1)));
-    DEBUG_printf("Initializing GC heap: %p..%p = " UINT_FMT " bytes\n", start, end, (byte *)end - (byte *)start);
-
+STATIC void gc_setup_area(mp_state_mem_area_t *area, void *start, void *end) {
     // calculate parameters for GC (T=total, A=alloc table, F=finaliser table, P=pool; all in bytes):
     // T = A + F + P
     //     F = A * BLOCKS_PER_ATB / BLOCKS_PER_FTB
@@ -118,36 +135,71 @@ void gc_init(void *start, void *end) {
     // => T = A * (1 + BLOCKS_PER_ATB / BLOCKS_PER_FTB + BLOCKS_PER_ATB * BYTES_PER_BLOCK)
     size_t total_byte_len = (byte *)end - (byte *)start;
     #if MICROPY_ENABLE_FINALISER
-    MP_STATE_MEM(gc_alloc_table_byte_len) = total_byte_len * MP_BITS_PER_BYTE / (MP_BITS_PER_BYTE + MP_BITS_PER_BYTE * BLOCKS_PER_ATB / BLOCKS_PER_FTB + MP_BITS_PER_BYTE * BLOCKS_PER_ATB * BYTES_PER_BLOCK);
+    area->gc_alloc_table_byte_len = total_byte_len * MP_BITS_PER_BYTE / (MP_BITS_PER_BYTE + MP_BITS_PER_BYTE * BLOCKS_PER_ATB / BLOCKS_PER_FTB + MP_BITS_PER_BYTE * BLOCKS_PER_ATB * BYTES_PER_BLOCK);
     #else
-    MP_STATE_MEM(gc_alloc_table_byte_len) = total_byte_len / (1 + MP_BITS_PER_BYTE / 2 * BYTES_PER_BLOCK);
+    area->gc_alloc_table_byte_len = total_byte_len / (1 + MP_BITS_PER_BYTE / 2 * BYTES_PER_BLOCK);
     #endif
 
-    MP_STATE_MEM(gc_alloc_table_start) = (byte *)start;
+    area->gc_alloc_table_start = (byte *)start;
 
     #if MICROPY_ENABLE_FINALISER
-    size_t gc_finaliser_table_byte_len = (MP_STATE_MEM(gc_alloc_table_byte_len) * BLOCKS_PER_ATB + BLOCKS_PER_FTB - 1) / BLOCKS_PER_FTB;
-    MP_STATE_MEM(gc_finaliser_table_start) = MP_STATE_MEM(gc_alloc_table_start) + MP_STATE_MEM(gc_alloc_table_byte_len);
+    size_t gc_finaliser_table_byte_len = (area->gc_alloc_table_byte_len * BLOCKS_PER_ATB + BLOCKS_PER_FTB - 1) / BLOCKS_PER_FTB;
+    area->gc_finaliser_table_start = area->gc_alloc_table_start + area->gc_alloc_table_byte_len;
     #endif
 
-    size_t gc_pool_block_len = MP_STATE_MEM(gc_alloc_table_byte_len) * BLOCKS_PER_ATB;
-    MP_STATE_MEM(gc_pool_start) = (byte *)end - gc_pool_block_len * BYTES_PER_BLOCK;
-    MP_STATE_MEM(gc_pool_end) = end;
+    size_t gc_pool_block_len = area->gc_alloc_table_byte_len * BLOCKS_PER_ATB;
+    area->gc_pool_start = (byte *)end - gc_pool_block_len * BYTES_PER_BLOCK;
+    area->gc_pool_end = end;
 
     #if MICROPY_ENABLE_FINALISER
-    assert(MP_STATE_MEM(gc_pool_start) >= MP_STATE_MEM(gc_finaliser_table_start) + gc_finaliser_table_byte_len);
+    assert(area->gc_pool_start >= area->gc_finaliser_table_start + gc_finaliser_table_byte_len);
     #endif
 
     // clear ATBs
-    memset(MP_STATE_MEM(gc_alloc_table_start), 0, MP_STATE_MEM(gc_alloc_table_byte_len));
+    memset(area->gc_alloc_table_start, 0, area->gc_alloc_table_byte_len);
 
     #if MICROPY_ENABLE_FINALISER
     // clear FTBs
-    memset(MP_STATE_MEM(gc_finaliser_table_start), 0, gc_finaliser_table_byte_len);
+    memset(area->gc_finaliser_table_start, 0, gc_finaliser_table_byte_len);
     #endif
 
     // set last free ATB index to start of heap
-    MP_STATE_MEM(gc_last_free_atb_index) = 0;
+    area->gc_last_free_atb_index = 0;
+
+    #if MICROPY_GC_INCREMENTAL_SWEEP
+    // nothing to sweep yet
+    area->gc_sweep_block = gc_pool_block_len;
+    #endif
+
+    #if MICROPY_GC_SIZE_CLASSES
+    // no free runs recorded yet, they are found by the first sweep
+    memset(area->gc_free_run_len, 0, sizeof(area->gc_free_run_len));
+    #endif
+
+    #if MICROPY_GC_NURSERY
+    // the whole area is free to begin with
+    area->gc_nursery_block = 0;
+    area->gc_nursery_end = gc_pool_block_len;
+    #endif
+
+    #if MICROPY_GC_SPLIT_HEAP
+    area->next = NULL;
+    #endif
+
+    DEBUG_printf("GC layout:\n");
+    DEBUG_printf("  alloc table at %p, length " UINT_FMT " bytes, " UINT_FMT " blocks\n", area->gc_alloc_table_start, area->gc_alloc_table_byte_len, area->gc_alloc_table_byte_len * BLOCKS_PER_ATB);
+    #if MICROPY_ENABLE_FINALISER
+    DEBUG_printf("  finaliser table at %p, length " UINT_FMT " bytes, " UINT_FMT " blocks\n", area->gc_finaliser_table_start, gc_finaliser_table_byte_len, gc_finaliser_table_byte_len * BLOCKS_PER_FTB);
+    #endif
+    DEBUG_printf("  pool at %p, length " UINT_FMT " bytes, " UINT_FMT " blocks\n", area->gc_pool_start, gc_pool_block_len * BYTES_PER_BLOCK, gc_pool_block_len);
+}
+
+void gc_init(void *start, void *end) {
+    // align end pointer on block boundary
+    end = (void *)((uintptr_t)end & (~(BYTES_PER_BLOCK - 1)));
+    DEBUG_printf("Initializing GC heap: %p..%p = " UINT_FMT " bytes\n", start, end, (byte *)end - (byte *)start);
+
+    gc_setup_area(&MP_STATE_MEM(area), start, end);
 
     // unlock the GC
     MP_STATE_THREAD(gc_lock_depth) = 0;
@@ -161,17 +213,43 @@ void gc_init(void *start, void *end) {
     MP_STATE_MEM(gc_alloc_amount) = 0;
     #endif
 
+    #if MICROPY_GC_INCREMENTAL_SWEEP
+    // by default, sweep the whole heap as part of each collection
+    MP_STATE_MEM(gc_sweep_budget_us) = 0;
+    MP_STATE_MEM(gc_sweep_pending) = 0;
+    MP_STATE_MEM(gc_sweep_deferred) = 0;
+    #endif
+
+    #if MICROPY_GC_PROFILE
+    gc_profile_reset();
+    #endif
+
     #if MICROPY_PY_THREAD && !MICROPY_PY_THREAD_GIL
     mp_thread_mutex_init(&MP_STATE_MEM(gc_mutex));
     #endif
+}
 
-    DEBUG_printf("GC layout:\n");
-    DEBUG_printf("  alloc table at %p, length " UINT_FMT " bytes, " UINT_FMT " blocks\n", MP_STATE_MEM(gc_alloc_table_start), MP_STATE_MEM(gc_alloc_table_byte_len), MP_STATE_MEM(gc_alloc_table_byte_len) * BLOCKS_PER_ATB);
-    #if MICROPY_ENABLE_FINALISER
-    DEBUG_printf("  finaliser table at %p, length " UINT_FMT " bytes, " UINT_FMT " blocks\n", MP_STATE_MEM(gc_finaliser_table_start), gc_finaliser_table_byte_len, gc_finaliser_table_byte_len * BLOCKS_PER_FTB);
-    #endif
-    DEBUG_printf("  pool at %p, length " UINT_FMT " bytes, " UINT_FMT " blocks\n", MP_STATE_MEM(gc_pool_start), gc_pool_block_len * BYTES_PER_BLOCK, gc_pool_block_len);
+#if MICROPY_GC_SPLIT_HEAP
+void gc_add(void *start, void *end) {
+    // Place the area descriptor at the start of the new memory, then align
+    // the remaining pointers on block boundaries.
+    mp_state_mem_area_t *area = (mp_state_mem_area_t *)start;
+    start = (void *)(((uintptr_t)(area + 1) + BYTES_PER_BLOCK - 1) & (~(BYTES_PER_BLOCK - 1)));
+    end = (void *)((uintptr_t)end & (~(BYTES_PER_BLOCK - 1)));
+    DEBUG_printf("Adding GC heap: %p..%p = " UINT_FMT " bytes\n", start, end, (byte *)end - (byte *)start);
+
+    gc_setup_area(area, start, end);
+
+    // Append the new area to the end of the list of areas.
+    GC_ENTER();
+    mp_state_mem_area_t *prev_area = &MP_STATE_MEM(area);
+    while (prev_area->next != NULL) {
+        prev_area = prev_area->next;
+    }
+    prev_area->next = area;
+    GC_EXIT();
 }
+#endif
 
 void gc_lock(void) {
     // This does not need to be atomic or have the GC mutex because:
@@ -191,12 +269,152 @@ bool gc_is_locked(void) {
 }
 
 // ptr should be of type void*
-#define VERIFY_PTR(ptr) ( \
-    ((uintptr_t)(ptr) & (BYTES_PER_BLOCK - 1)) == 0          /* must be aligned on a block */ \
-    && ptr >= (void *)MP_STATE_MEM(gc_pool_start)        /* must be above start of pool */ \
-    && ptr < (void *)MP_STATE_MEM(gc_pool_end)           /* must be below end of pool */ \
+#define VERIFY_PTR(area, ptr) ( \
+    ((uintptr_t)(ptr) & (BYTES_PER_BLOCK - 1)) == 0      /* must be aligned on a block */ \
+    && ptr >= (void *)(area)->gc_pool_start              /* must be above start of pool */ \
+    && ptr < (void *)(area)->gc_pool_end                 /* must be below end of pool */ \
     )
 
+// Returns the heap area that contains ptr, or NULL if ptr is not a pointer to
+// the start of a block in the heap.
+static inline mp_state_mem_area_t *gc_get_ptr_area(const void *ptr) {
+    for (mp_state_mem_area_t *area = &MP_STATE_MEM(area); area != NULL; area = NEXT_AREA(area)) {
+        if (VERIFY_PTR(area, ptr)) {
+            return area;
+        }
+    }
+    return NULL;
+}
+
+#if MICROPY_GC_SIZE_CLASSES
+// Record a run of n_blocks free blocks starting at block, split into pieces of
+// at most MICROPY_GC_SIZE_CLASSES blocks.  Pieces that don't fit are dropped.
+STATIC void gc_size_class_push(mp_state_mem_area_t *area, size_t block, size_t n_blocks) {
+    while (n_blocks > 0) {
+        size_t c = MIN(n_blocks, MICROPY_GC_SIZE_CLASSES);
+        uint16_t *len = &area->gc_free_run_len[c - 1];
+        if (*len < MICROPY_GC_SIZE_CLASS_DEPTH) {
+            area->gc_free_run[c - 1][(*len)++] = block;
+        } else if (c == MICROPY_GC_SIZE_CLASSES) {
+            // the rest of the run would go into this same full class
+            break;
+        }
+        block += c;
+        n_blocks -= c;
+    }
+}
+
+// Take a run of n_blocks free blocks from the size class stacks, using the
+// smallest class that can satisfy the request.  Returns the starting block,
+// or (size_t)-1 if no recorded run is available.
+STATIC size_t gc_size_class_pop(mp_state_mem_area_t *area, size_t n_blocks) {
+    for (size_t c = n_blocks; c <= MICROPY_GC_SIZE_CLASSES; ++c) {
+        uint16_t *len = &area->gc_free_run_len[c - 1];
+        while (*len > 0) {
+            size_t block = area->gc_free_run[c - 1][--*len];
+            // the blocks may have been allocated since this run was recorded
+            size_t n_free = 0;
+            while (n_free < c && ATB_GET_KIND(area, block + n_free) == AT_FREE) {
+                ++n_free;
+            }
+            if (n_free == c) {
+                gc_size_class_push(area, block + n_blocks, c - n_blocks);
+                return block;
+            }
+        }
+    }
+    return (size_t)-1;
+}
+#endif
+
+#if MICROPY_GC_NURSERY
+// Take n_blocks free blocks from the nursery of the given area.  Returns the
+// starting block, or (size_t)-1 if the rest of the nursery is too small.
+STATIC size_t gc_nursery_take(mp_state_mem_area_t *area, size_t n_blocks) {
+    size_t block = area->gc_nursery_block;
+    size_t n_free = 0;
+    while (n_free < n_blocks) {
+        if (block + n_free >= area->gc_nursery_end) {
+            area->gc_nursery_block = area->gc_nursery_end;
+            return (size_t)-1;
+        }
+        if (ATB_GET_KIND(area, block + n_free) == AT_FREE) {
+            ++n_free;
+        } else {
+            // taken by another allocation since the nursery was set, skip it
+            block += n_free + 1;
+            n_free = 0;
+        }
+    }
+    area->gc_nursery_block = block + n_blocks;
+    return block;
+}
+#endif
+
+#if MICROPY_GC_PROFILE
+void gc_profile_reset(void) {
+    GC_ENTER();
+    MP_STATE_MEM(gc_prof_collections) = 0;
+    memset(MP_STATE_MEM(gc_prof_pause_us), 0, sizeof(MP_STATE_MEM(gc_prof_pause_us)));
+    memset(MP_STATE_MEM(gc_prof_pause_max_us), 0, sizeof(MP_STATE_MEM(gc_prof_pause_max_us)));
+    MP_STATE_MEM(gc_prof_sites_dropped) = 0;
+    memset(MP_STATE_MEM(gc_prof_sites), 0, sizeof(MP_STATE_MEM(gc_prof_sites)));
+    GC_EXIT();
+}
+
+// Account for a pause in the mark (phase 0) or sweep (phase 1) phase.
+STATIC void gc_profile_pause(size_t phase, mp_uint_t start_us) {
+    mp_uint_t us = mp_hal_ticks_us() - start_us;
+    MP_STATE_MEM(gc_prof_pause_us)[phase] += us;
+    if (us > MP_STATE_MEM(gc_prof_pause_max_us)[phase]) {
+        MP_STATE_MEM(gc_prof_pause_max_us)[phase] = us;
+    }
+}
+
+// Attribute an allocation to the opcode currently being executed, if any.
+// The location of a site is decoded once, when it is first seen.
+STATIC void gc_profile_alloc(size_t n_bytes) {
+    const mp_code_state_t *code_state = MP_STATE_THREAD(current_code_state);
+    const byte *ip = code_state == NULL ? NULL : code_state->ip;
+    size_t mask = MICROPY_GC_PROFILE_SITES - 1;
+    size_t i = ((uintptr_t)ip >> 1) & mask;
+    for (size_t n = 0; n <= mask; ++n, i = (i + 1) & mask) {
+        mp_state_mem_site_t *site = &MP_STATE_MEM(gc_prof_sites)[i];
+        if (site->count == 0) {
+            site->ip = ip;
+            if (code_state == NULL) {
+                site->source_file = MP_QSTRnull;
+                site->block_name = MP_QSTRnull;
+                site->line = 0;
+            } else {
+                mp_code_state_get_location(code_state, &site->source_file, &site->block_name, &site->line);
+            }
+        } else if (site->ip != ip) {
+            continue;
+        }
+        site->count += 1;
+        site->bytes += n_bytes;
+        return;
+    }
+    MP_STATE_MEM(gc_prof_sites_dropped) += 1;
+}
+#endif
+
+#if MICROPY_GC_SIZE_CLASSES || MICROPY_GC_NURSERY
+// Record a run of free blocks found by the sweep.
+STATIC void gc_sweep_free_run(mp_state_mem_area_t *area, size_t block, size_t n_blocks) {
+    #if MICROPY_GC_NURSERY
+    if (n_blocks > area->gc_nursery_end - area->gc_nursery_block) {
+        area->gc_nursery_block = block;
+        area->gc_nursery_end = block + n_blocks;
+    }
+    #endif
+    #if MICROPY_GC_SIZE_CLASSES
+    gc_size_class_push(area, block, n_blocks);
+    #endif
+}
+#endif
+
 #ifndef TRACE_MARK
 #if DEBUG_PRINT
 #define TRACE_MARK(block, ptr) DEBUG_printf("gc_mark(%p)\n", ptr)
@@ -209,7 +427,7 @@ bool gc_is_locked(void) {
 // children: mark the unmarked child blocks and put those newly marked
 // blocks on the stack. When all children have been checked, pop off the
 // topmost block on the stack and repeat with that one.
-STATIC void gc_mark_subtree(size_t block) {
+STATIC void gc_mark_subtree(mp_state_mem_area_t *area, size_t block) {
     // Start with the block passed in the argument.
     size_t sp = 0;
     for (;;) {
@@ -217,21 +435,26 @@ STATIC void gc_mark_subtree(size_t block) {
         size_t n_blocks = 0;
         do {
             n_blocks += 1;
-        } while (ATB_GET_KIND(block + n_blocks) == AT_TAIL);
+        } while (ATB_GET_KIND(area, block + n_blocks) == AT_TAIL);
 
         // check this block's children
-        void **ptrs = (void **)PTR_FROM_BLOCK(block);
+        void **ptrs = (void **)PTR_FROM_BLOCK(area, block);
         for (size_t i = n_blocks * BYTES_PER_BLOCK / sizeof(void *); i > 0; i--, ptrs++) {
             void *ptr = *ptrs;
-            if (VERIFY_PTR(ptr)) {
+            mp_state_mem_area_t *ptr_area = gc_get_ptr_area(ptr);
+            if (ptr_area != NULL) {
                 // Mark and push this pointer
-                size_t childblock = BLOCK_FROM_PTR(ptr);
-                if (ATB_GET_KIND(childblock) == AT_HEAD) {
+                size_t childblock = BLOCK_FROM_PTR(ptr_area, ptr);
+                if (ATB_GET_KIND(ptr_area, childblock) == AT_HEAD) {
                     // an unmarked head, mark it, and push it on gc stack
                     TRACE_MARK(childblock, ptr);
-                    ATB_HEAD_TO_MARK(childblock);
+                    ATB_HEAD_TO_MARK(ptr_area, childblock);
                     if (sp < MICROPY_ALLOC_GC_STACK_SIZE) {
-                        MP_STATE_MEM(gc_stack)[sp++] = childblock;
+                        MP_STATE_MEM(gc_stack)[sp] = childblock;
+                        #if MICROPY_GC_SPLIT_HEAP
+                        MP_STATE_MEM(gc_area_stack)[sp] = ptr_area;
+                        #endif
+                        sp += 1;
                     } else {
                         MP_STATE_MEM(gc_stack_overflow) = 1;
                     }
@@ -245,7 +468,11 @@ STATIC void gc_mark_subtree(size_t block) {
         }
 
         // pop the next block off the stack
-        block = MP_STATE_MEM(gc_stack)[--sp];
+        sp -= 1;
+        block = MP_STATE_MEM(gc_stack)[sp];
+        #if MICROPY_GC_SPLIT_HEAP
+        area = MP_STATE_MEM(gc_area_stack)[sp];
+        #endif
     }
 }
 
@@ -254,73 +481,193 @@ STATIC void gc_deal_with_stack_overflow(void) {
         MP_STATE_MEM(gc_stack_overflow) = 0;
 
         // scan entire memory looking for blocks which have been marked but not their children
-        for (size_t block = 0; block < MP_STATE_MEM(gc_alloc_table_byte_len) * BLOCKS_PER_ATB; block++) {
-            // trace (again) if mark bit set
-            if (ATB_GET_KIND(block) == AT_MARK) {
-                gc_mark_subtree(block);
+        for (mp_state_mem_area_t *area = &MP_STATE_MEM(area); area != NULL; area = NEXT_AREA(area)) {
+            for (size_t block = 0; block < area->gc_alloc_table_byte_len * BLOCKS_PER_ATB; block++) {
+                // trace (again) if mark bit set
+                if (ATB_GET_KIND(area, block) == AT_MARK) {
+                    gc_mark_subtree(area, block);
+                }
             }
         }
     }
 }
 
-STATIC void gc_sweep(void) {
-    #if MICROPY_PY_GC_COLLECT_RETVAL
-    MP_STATE_MEM(gc_collected) = 0;
+#if MICROPY_ENABLE_FINALISER
+// Call the __del__ method, if any, of the object at the given block and clear
+// its finaliser flag.
+STATIC void gc_finalise(mp_state_mem_area_t *area, size_t block) {
+    mp_obj_base_t *obj = (mp_obj_base_t *)PTR_FROM_BLOCK(area, block);
+    if (obj->type != NULL) {
+        // if the object has a type then see if it has a __del__ method
+        mp_obj_t dest[2];
+        mp_load_method_maybe(MP_OBJ_FROM_PTR(obj), MP_QSTR___del__, dest);
+        if (dest[0] != MP_OBJ_NULL) {
+            // load_method returned a method, execute it in a protected environment
+            #if MICROPY_ENABLE_SCHEDULER
+            mp_sched_lock();
+            #endif
+            mp_call_function_1_protected(dest[0], dest[1]);
+            #if MICROPY_ENABLE_SCHEDULER
+            mp_sched_unlock();
+            #endif
+        }
+    }
+    // clear finaliser flag
+    FTB_CLEAR(area, block);
+}
+#endif
+
+#if MICROPY_GC_INCREMENTAL_SWEEP && MICROPY_ENABLE_FINALISER
+// Run the finalisers of all unmarked objects before a deferred sweep starts.
+// A finaliser may use other unreachable objects, which the slices of the sweep
+// free and allocations then reuse, so they can't wait for the sweep to reach
+// their own block.
+STATIC void gc_sweep_finalisers(void) {
+    for (mp_state_mem_area_t *area = &MP_STATE_MEM(area); area != NULL; area = NEXT_AREA(area)) {
+        size_t n_blocks = area->gc_alloc_table_byte_len * BLOCKS_PER_ATB;
+        for (size_t block = 0; block < n_blocks; block += BLOCKS_PER_FTB) {
+            byte ftb = area->gc_finaliser_table_start[block / BLOCKS_PER_FTB];
+            for (size_t i = 0; ftb != 0; ++i, ftb >>= 1) {
+                if ((ftb & 1) && ATB_GET_KIND(area, block + i) == AT_HEAD) {
+                    gc_finalise(area, block + i);
+                }
+            }
+        }
+    }
+}
+#endif
+
+// Free unmarked heads and their tails.  With MICROPY_GC_INCREMENTAL_SWEEP each
+// area is swept from its gc_sweep_block onwards, and if budget_us is non-zero
+// then the sweep stops at the start of a chain once that much time has passed.
+// Returns true if the sweep finished.
+STATIC bool gc_sweep(mp_uint_t budget_us) {
+    #if MICROPY_GC_INCREMENTAL_SWEEP
+    mp_uint_t start_us = mp_hal_ticks_us();
+    #else
+    (void)budget_us;
     #endif
-    // free unmarked heads and their tails
-    int free_tail = 0;
-    for (size_t block = 0; block < MP_STATE_MEM(gc_alloc_table_byte_len) * BLOCKS_PER_ATB; block++) {
-        switch (ATB_GET_KIND(block)) {
-            case AT_HEAD:
-                #if MICROPY_ENABLE_FINALISER
-                if (FTB_GET(block)) {
-                    mp_obj_base_t *obj = (mp_obj_base_t *)PTR_FROM_BLOCK(block);
-                    if (obj->type != NULL) {
-                        // if the object has a type then see if it has a __del__ method
-                        mp_obj_t dest[2];
-                        mp_load_method_maybe(MP_OBJ_FROM_PTR(obj), MP_QSTR___del__, dest);
-                        if (dest[0] != MP_OBJ_NULL) {
-                            // load_method returned a method, execute it in a protected environment
-                            #if MICROPY_ENABLE_SCHEDULER
-                            mp_sched_lock();
-                            #endif
-                            mp_call_function_1_protected(dest[0], dest[1]);
-                            #if MICROPY_ENABLE_SCHEDULER
-                            mp_sched_unlock();
-                            #endif
-                        }
+    for (mp_state_mem_area_t *area = &MP_STATE_MEM(area); area != NULL; area = NEXT_AREA(area)) {
+        size_t block = 0;
+        size_t n_blocks = area->gc_alloc_table_byte_len * BLOCKS_PER_ATB;
+        #if MICROPY_GC_INCREMENTAL_SWEEP
+        block = area->gc_sweep_block;
+        size_t first_block = block;
+        #endif
+        #if MICROPY_GC_SIZE_CLASSES || MICROPY_GC_NURSERY
+        // rebuild the size class stacks and nursery from the free runs left after sweeping
+        if (block == 0) {
+            #if MICROPY_GC_SIZE_CLASSES
+            memset(area->gc_free_run_len, 0, sizeof(area->gc_free_run_len));
+            #endif
+            #if MICROPY_GC_NURSERY
+            area->gc_nursery_block = 0;
+            area->gc_nursery_end = 0;
+            #endif
+        }
+        size_t run_start = 0;
+        size_t run_len = 0;
+        #endif
+        int free_tail = 0;
+        for (; block < n_blocks; block++) {
+            #if MICROPY_GC_INCREMENTAL_SWEEP
+            if (budget_us != 0 && block != first_block && (block & 63) == 0
+                && ATB_GET_KIND(area, block) != AT_TAIL
+                && mp_hal_ticks_us() - start_us >= budget_us) {
+                // out of time, resume from this block next time
+                break;
+            }
+            #endif
+            switch (ATB_GET_KIND(area, block)) {
+                case AT_HEAD:
+                    #if MICROPY_ENABLE_FINALISER
+                    if (FTB_GET(area, block)) {
+                        gc_finalise(area, block);
                     }
-                    // clear finaliser flag
-                    FTB_CLEAR(block);
-                }
-                #endif
-                free_tail = 1;
-                DEBUG_printf("gc_sweep(%p)\n", (void *)PTR_FROM_BLOCK(block));
-                #if MICROPY_PY_GC_COLLECT_RETVAL
-                MP_STATE_MEM(gc_collected)++;
-                #endif
-                // fall through to free the head
-                MP_FALLTHROUGH
-
-            case AT_TAIL:
-                if (free_tail) {
-                    ATB_ANY_TO_FREE(block);
-                    #if CLEAR_ON_SWEEP
-                    memset((void *)PTR_FROM_BLOCK(block), 0, BYTES_PER_BLOCK);
                     #endif
-                }
-                break;
+                    free_tail = 1;
+                    DEBUG_printf("gc_sweep(%p)\n", (void *)PTR_FROM_BLOCK(area, block));
+                    #if MICROPY_PY_GC_COLLECT_RETVAL
+                    MP_STATE_MEM(gc_collected)++;
+                    #endif
+                    // fall through to free the head
+                    MP_FALLTHROUGH
+
+                case AT_TAIL:
+                    if (free_tail) {
+                        ATB_ANY_TO_FREE(area, block);
+                        #if CLEAR_ON_SWEEP
+                        memset((void *)PTR_FROM_BLOCK(area, block), 0, BYTES_PER_BLOCK);
+                        #endif
+                    }
+                    break;
 
-            case AT_MARK:
-                ATB_MARK_TO_HEAD(block);
-                free_tail = 0;
-                break;
+                case AT_MARK:
+                    ATB_MARK_TO_HEAD(area, block);
+                    free_tail = 0;
+                    break;
+            }
+
+            #if MICROPY_GC_SIZE_CLASSES || MICROPY_GC_NURSERY
+            if (ATB_GET_KIND(area, block) == AT_FREE) {
+                if (run_len++ == 0) {
+                    run_start = block;
+                }
+            } else if (run_len > 0) {
+                gc_sweep_free_run(area, run_start, run_len);
+                run_len = 0;
+            }
+            #endif
+        }
+        #if MICROPY_GC_SIZE_CLASSES || MICROPY_GC_NURSERY
+        if (run_len > 0) {
+            gc_sweep_free_run(area, run_start, run_len);
+        }
+        #endif
+        #if MICROPY_GC_INCREMENTAL_SWEEP
+        area->gc_sweep_block = block;
+        // allocations may have moved the last free index past the blocks just freed
+        if (first_block / BLOCKS_PER_ATB < area->gc_last_free_atb_index) {
+            area->gc_last_free_atb_index = first_block / BLOCKS_PER_ATB;
+        }
+        if (block < n_blocks) {
+            return false;
         }
+        #endif
+    }
+    return true;
+}
+
+#if MICROPY_GC_INCREMENTAL_SWEEP
+// Continue a sweep that was deferred by gc_collect_end, either for at most the
+// pause budget or to completion.  Must be called with the GC mutex held.
+STATIC void gc_sweep_continue(bool limit) {
+    MP_STATE_THREAD(gc_lock_depth)++;
+    #if MICROPY_GC_PROFILE
+    mp_uint_t start_us = mp_hal_ticks_us();
+    #endif
+    if (gc_sweep(limit ? MP_STATE_MEM(gc_sweep_budget_us) : 0)) {
+        MP_STATE_MEM(gc_sweep_pending) = 0;
     }
+    #if MICROPY_GC_PROFILE
+    gc_profile_pause(1, start_us);
+    #endif
+    MP_STATE_THREAD(gc_lock_depth)--;
 }
+#endif
 
 void gc_collect_start(void) {
     GC_ENTER();
+    #if MICROPY_GC_INCREMENTAL_SWEEP
+    // the marking phase needs all the marks from the last collection cleared
+    if (MP_STATE_MEM(gc_sweep_pending)) {
+        gc_sweep_continue(false);
+    }
+    #endif
+    #if MICROPY_GC_PROFILE
+    MP_STATE_MEM(gc_prof_collections) += 1;
+    MP_STATE_MEM(gc_prof_start_us) = mp_hal_ticks_us();
+    #endif
     MP_STATE_THREAD(gc_lock_depth)++;
     #if MICROPY_GC_ALLOC_THRESHOLD
     MP_STATE_MEM(gc_alloc_amount) = 0;
@@ -345,13 +692,14 @@ void gc_collect_start(void) {
 void gc_collect_root(void **ptrs, size_t len) {
     for (size_t i = 0; i < len; i++) {
         void *ptr = ptrs[i];
-        if (VERIFY_PTR(ptr)) {
-            size_t block = BLOCK_FROM_PTR(ptr);
-            if (ATB_GET_KIND(block) == AT_HEAD) {
+        mp_state_mem_area_t *area = gc_get_ptr_area(ptr);
+        if (area != NULL) {
+            size_t block = BLOCK_FROM_PTR(area, ptr);
+            if (ATB_GET_KIND(area, block) == AT_HEAD) {
                 // An unmarked head: mark it, and mark all its children
                 TRACE_MARK(block, ptr);
-                ATB_HEAD_TO_MARK(block);
-                gc_mark_subtree(block);
+                ATB_HEAD_TO_MARK(area, block);
+                gc_mark_subtree(area, block);
             }
         }
     }
@@ -359,14 +707,51 @@ void gc_collect_root(void **ptrs, size_t len) {
 
 void gc_collect_end(void) {
     gc_deal_with_stack_overflow();
-    gc_sweep();
-    MP_STATE_MEM(gc_last_free_atb_index) = 0;
+    #if MICROPY_GC_PROFILE
+    gc_profile_pause(0, MP_STATE_MEM(gc_prof_start_us));
+    #endif
+    #if MICROPY_PY_GC_COLLECT_RETVAL
+    MP_STATE_MEM(gc_collected) = 0;
+    #endif
+    for (mp_state_mem_area_t *area = &MP_STATE_MEM(area); area != NULL; area = NEXT_AREA(area)) {
+        area->gc_last_free_atb_index = 0;
+        #if MICROPY_GC_INCREMENTAL_SWEEP
+        area->gc_sweep_block = 0;
+        #endif
+    }
+    #if MICROPY_GC_INCREMENTAL_SWEEP
+    if (MP_STATE_MEM(gc_sweep_deferred)) {
+        // leave the sweep to be done in slices by subsequent allocations
+        MP_STATE_MEM(gc_sweep_deferred) = 0;
+        #if MICROPY_ENABLE_FINALISER
+        gc_sweep_finalisers();
+        #endif
+        MP_STATE_MEM(gc_sweep_pending) = 1;
+    } else
+    #endif
+    {
+        #if MICROPY_GC_PROFILE
+        mp_uint_t start_us = mp_hal_ticks_us();
+        #endif
+        gc_sweep(0);
+        #if MICROPY_GC_PROFILE
+        gc_profile_pause(1, start_us);
+        #endif
+    }
     MP_STATE_THREAD(gc_lock_depth)--;
     GC_EXIT();
 }
 
 void gc_sweep_all(void) {
     GC_ENTER();
+    #if MICROPY_GC_INCREMENTAL_SWEEP
+    if (MP_STATE_MEM(gc_sweep_pending)) {
+        gc_sweep_continue(false);
+    }
+    #endif
+    #if MICROPY_GC_PROFILE
+    MP_STATE_MEM(gc_prof_start_us) = mp_hal_ticks_us();
+    #endif
     MP_STATE_THREAD(gc_lock_depth)++;
     MP_STATE_MEM(gc_stack_overflow) = 0;
     gc_collect_end();
@@ -374,59 +759,71 @@ void gc_sweep_all(void) {
 
 void gc_info(gc_info_t *info) {
     GC_ENTER();
-    info->total = MP_STATE_MEM(gc_pool_end) - MP_STATE_MEM(gc_pool_start);
+    info->total = 0;
     info->used = 0;
     info->free = 0;
     info->max_free = 0;
     info->num_1block = 0;
     info->num_2block = 0;
     info->max_block = 0;
-    bool finish = false;
-    for (size_t block = 0, len = 0, len_free = 0; !finish;) {
-        size_t kind = ATB_GET_KIND(block);
-        switch (kind) {
-            case AT_FREE:
-                info->free += 1;
-                len_free += 1;
-                len = 0;
-                break;
-
-            case AT_HEAD:
-                info->used += 1;
-                len = 1;
-                break;
-
-            case AT_TAIL:
-                info->used += 1;
-                len += 1;
-                break;
-
-            case AT_MARK:
-                // shouldn't happen
-                break;
-        }
-
-        block++;
-        finish = (block == MP_STATE_MEM(gc_alloc_table_byte_len) * BLOCKS_PER_ATB);
-        // Get next block type if possible
-        if (!finish) {
-            kind = ATB_GET_KIND(block);
-        }
-
-        if (finish || kind == AT_FREE || kind == AT_HEAD) {
-            if (len == 1) {
-                info->num_1block += 1;
-            } else if (len == 2) {
-                info->num_2block += 1;
+    memset(info->free_runs, 0, sizeof(info->free_runs));
+    for (mp_state_mem_area_t *area = &MP_STATE_MEM(area); area != NULL; area = NEXT_AREA(area)) {
+        info->total += area->gc_pool_end - area->gc_pool_start;
+        bool finish = false;
+        for (size_t block = 0, len = 0, len_free = 0; !finish;) {
+            size_t kind = ATB_IS_HEAD(area, block) ? AT_HEAD : ATB_GET_KIND(area, block);
+            switch (kind) {
+                case AT_FREE:
+                    info->free += 1;
+                    len_free += 1;
+                    len = 0;
+                    break;
+
+                case AT_HEAD:
+                    info->used += 1;
+                    len = 1;
+                    break;
+
+                case AT_TAIL:
+                    info->used += 1;
+                    len += 1;
+                    break;
+
+                case AT_MARK:
+                    // shouldn't happen
+                    break;
             }
-            if (len > info->max_block) {
-                info->max_block = len;
+
+            block++;
+            finish = (block == area->gc_alloc_table_byte_len * BLOCKS_PER_ATB);
+            // Get next block type if possible
+            if (!finish) {
+                kind = ATB_IS_HEAD(area, block) ? AT_HEAD : ATB_GET_KIND(area, block);
             }
-            if (finish || kind == AT_HEAD) {
-                if (len_free > info->max_free) {
-                    info->max_free = len_free;
+
+            if (finish || kind == AT_FREE || kind == AT_HEAD) {
+                if (len == 1) {
+                    info->num_1block += 1;
+                } else if (len == 2) {
+                    info->num_2block += 1;
+                }
+                if (len > info->max_block) {
+                    info->max_block = len;
+                }
+                if (finish || kind == AT_HEAD) {
+                    if (len_free > info->max_free) {
+                        info->max_free = len_free;
+                    }
+                    if (len_free > 0) {
+                        // bucket the free run by the log2 of its length
+                        size_t bucket = 0;
+                        while (len_free >> (bucket + 1) && bucket < GC_INFO_FREE_RUNS_LEN - 1) {
+                            bucket += 1;
+                        }
+                        info->free_runs[bucket] += 1;
+                    }
+                    len_free = 0;
                 }
-                len_free = 0;
             }
         }
     }
@@ -453,6 +850,7 @@ void *gc_alloc(size_t n_bytes, unsigned int alloc_flags) {
 
     GC_ENTER();
 
+    mp_state_mem_area_t *area;
     size_t i;
     size_t end_block;
     size_t start_block;
@@ -462,25 +860,88 @@ void *gc_alloc(size_t n_bytes, unsigned int alloc_flags) {
     #if MICROPY_GC_ALLOC_THRESHOLD
     if (!collected && MP_STATE_MEM(gc_alloc_amount) >= MP_STATE_MEM(gc_alloc_threshold)) {
         GC_EXIT();
+        #if MICROPY_GC_INCREMENTAL_SWEEP
+        MP_STATE_MEM(gc_sweep_deferred) = MP_STATE_MEM(gc_sweep_budget_us) != 0;
+        #endif
         gc_collect();
         collected = 1;
         GC_ENTER();
     }
     #endif
 
+    #if MICROPY_GC_INCREMENTAL_SWEEP
+    // each allocation does a slice of any outstanding sweep
+    if (MP_STATE_MEM(gc_sweep_pending)) {
+        gc_sweep_continue(true);
+    }
+    #endif
+
+    #if MICROPY_GC_NURSERY
+    // small allocations are first bump-allocated from a nursery
+    if (n_blocks <= MICROPY_GC_NURSERY) {
+        for (area = &MP_STATE_MEM(area); area != NULL; area = NEXT_AREA(area)) {
+            start_block = gc_nursery_take(area, n_blocks);
+            if (start_block != (size_t)-1) {
+                end_block = start_block + n_blocks - 1;
+                goto found_run;
+            }
+        }
+    }
+    #endif
+
+    #if MICROPY_GC_SIZE_CLASSES
+    // small allocations are tried from the recorded free runs before scanning
+    if (n_blocks <= MICROPY_GC_SIZE_CLASSES) {
+        for (area = &MP_STATE_MEM(area); area != NULL; area = NEXT_AREA(area)) {
+            start_block = gc_size_class_pop(area, n_blocks);
+            if (start_block != (size_t)-1) {
+                end_block = start_block + n_blocks - 1;
+                goto found_run;
+            }
+        }
+    }
+    #endif
+
     for (;;) {
 
-        // look for a run of n_blocks available blocks
-        n_free = 0;
-        for (i = MP_STATE_MEM(gc_last_free_atb_index); i < MP_STATE_MEM(gc_alloc_table_byte_len); i++) {
-            byte a = MP_STATE_MEM(gc_alloc_table_start)[i];
-            // *FORMAT-OFF*
-            if (ATB_0_IS_FREE(a)) { if (++n_free >= n_blocks) { i = i * BLOCKS_PER_ATB + 0; goto found; } } else { n_free = 0; }
-            if (ATB_1_IS_FREE(a)) { if (++n_free >= n_blocks) { i = i * BLOCKS_PER_ATB + 1; goto found; } } else { n_free = 0; }
-            if (ATB_2_IS_FREE(a)) { if (++n_free >= n_blocks) { i = i * BLOCKS_PER_ATB + 2; goto found; } } else { n_free = 0; }
-            if (ATB_3_IS_FREE(a)) { if (++n_free >= n_blocks) { i = i * BLOCKS_PER_ATB + 3; goto found; } } else { n_free = 0; }
-            // *FORMAT-ON*
+        #if MICROPY_GC_LARGE_ALLOC_BLOCKS
+        if (n_blocks >= MICROPY_GC_LARGE_ALLOC_BLOCKS) {
+            // look for the highest run of n_blocks available blocks, in each area in turn
+            for (area = &MP_STATE_MEM(area); area != NULL; area = NEXT_AREA(area)) {
+                n_free = 0;
+                for (i = area->gc_alloc_table_byte_len; i-- > 0;) {
+                    byte a = area->gc_alloc_table_start[i];
+                    // *FORMAT-OFF*
+                    if (ATB_3_IS_FREE(a)) { if (++n_free >= n_blocks) { start_block = i * BLOCKS_PER_ATB + 3; goto found_high; } } else { n_free = 0; }
+                    if (ATB_2_IS_FREE(a)) { if (++n_free >= n_blocks) { start_block = i * BLOCKS_PER_ATB + 2; goto found_high; } } else { n_free = 0; }
+                    if (ATB_1_IS_FREE(a)) { if (++n_free >= n_blocks) { start_block = i * BLOCKS_PER_ATB + 1; goto found_high; } } else { n_free = 0; }
+                    if (ATB_0_IS_FREE(a)) { if (++n_free >= n_blocks) { start_block = i * BLOCKS_PER_ATB + 0; goto found_high; } } else { n_free = 0; }
+                    // *FORMAT-ON*
+                }
+            }
+        } else
+        #endif
+        // look for a run of n_blocks available blocks, in each area in turn
+        for (area = &MP_STATE_MEM(area); area != NULL; area = NEXT_AREA(area)) {
+            n_free = 0;
+            for (i = area->gc_last_free_atb_index; i < area->gc_alloc_table_byte_len; i++) {
+                byte a = area->gc_alloc_table_start[i];
+                // *FORMAT-OFF*
+                if (ATB_0_IS_FREE(a)) { if (++n_free >= n_blocks) { i = i * BLOCKS_PER_ATB + 0; goto found; } } else { n_free = 0; }
+                if (ATB_1_IS_FREE(a)) { if (++n_free >= n_blocks) { i = i * BLOCKS_PER_ATB + 1; goto found; } } else { n_free = 0; }
+                if (ATB_2_IS_FREE(a)) { if (++n_free >= n_blocks) { i = i * BLOCKS_PER_ATB + 2; goto found; } } else { n_free = 0; }
+                if (ATB_3_IS_FREE(a)) { if (++n_free >= n_blocks) { i = i * BLOCKS_PER_ATB + 3; goto found; } } else { n_free = 0; }
+                // *FORMAT-ON*
+            }
+        }
+
+        #if MICROPY_GC_INCREMENTAL_SWEEP
+        if (MP_STATE_MEM(gc_sweep_pending)) {
+            // sweep some more of the heap and try again
+            gc_sweep_continue(true);
+            continue;
         }
+        #endif
 
         GC_EXIT();
         // nothing found!
@@ -488,11 +949,21 @@ void *gc_alloc(size_t n_bytes, unsigned int alloc_flags) {
             return NULL;
         }
         DEBUG_printf("gc_alloc(" UINT_FMT "): no free mem, triggering GC\n", n_bytes);
+        #if MICROPY_GC_INCREMENTAL_SWEEP
+        MP_STATE_MEM(gc_sweep_deferred) = MP_STATE_MEM(gc_sweep_budget_us) != 0;
+        #endif
         gc_collect();
         collected = 1;
         GC_ENTER();
     }
 
+    #if MICROPY_GC_LARGE_ALLOC_BLOCKS
+    // found, starting at block start_block inclusive
+found_high:
+    end_block = start_block + n_blocks - 1;
+    goto found_run;
+    #endif
+
     // found, ending at block i inclusive
 found:
     // get starting and end blocks, both inclusive
@@ -505,27 +976,41 @@ found:
     // before this one.  Also, whenever we free or shink a block we must check
     // if this index needs adjusting (see gc_realloc and gc_free).
     if (n_free == 1) {
-        MP_STATE_MEM(gc_last_free_atb_index) = (i + 1) / BLOCKS_PER_ATB;
+        area->gc_last_free_atb_index = (i + 1) / BLOCKS_PER_ATB;
     }
 
+    #if MICROPY_GC_SIZE_CLASSES || MICROPY_GC_NURSERY || MICROPY_GC_LARGE_ALLOC_BLOCKS
+found_run:
+    #endif
     // mark first block as used head
-    ATB_FREE_TO_HEAD(start_block);
+    ATB_FREE_TO_HEAD(area, start_block);
+
+    #if MICROPY_GC_INCREMENTAL_SWEEP
+    // blocks that the sweep has yet to reach are allocated marked, so they survive it
+    if (start_block >= area->gc_sweep_block) {
+        ATB_HEAD_TO_MARK(area, start_block);
+    }
+    #endif
 
     // mark rest of blocks as used tail
     // TODO for a run of many blocks can make this more efficient
     for (size_t bl = start_block + 1; bl <= end_block; bl++) {
-        ATB_FREE_TO_TAIL(bl);
+        ATB_FREE_TO_TAIL(area, bl);
     }
 
     // get pointer to first block
     // we must create this pointer before unlocking the GC so a collection can find it
-    void *ret_ptr = (void *)(MP_STATE_MEM(gc_pool_start) + start_block * BYTES_PER_BLOCK);
+    void *ret_ptr = (void *)(area->gc_pool_start + start_block * BYTES_PER_BLOCK);
     DEBUG_printf("gc_alloc(%p)\n", ret_ptr);
 
     #if MICROPY_GC_ALLOC_THRESHOLD
     MP_STATE_MEM(gc_alloc_amount) += n_blocks;
     #endif
 
+    #if MICROPY_GC_PROFILE
+    gc_profile_alloc(n_bytes);
+    #endif
+
     GC_EXIT();
 
     #if MICROPY_GC_CONSERVATIVE_CLEAR
@@ -546,7 +1031,7 @@ found:
         ((mp_obj_base_t *)ret_ptr)->type = NULL;
         // set mp_obj flag only if it has a finaliser
         GC_ENTER();
-        FTB_SET(start_block);
+        FTB_SET(area, start_block);
         GC_EXIT();
     }
     #else
@@ -586,24 +1071,35 @@ void gc_free(void *ptr) {
         GC_EXIT();
     } else {
         // get the GC block number corresponding to this pointer
-        assert(VERIFY_PTR(ptr));
-        size_t block = BLOCK_FROM_PTR(ptr);
-        assert(ATB_GET_KIND(block) == AT_HEAD);
+        mp_state_mem_area_t *area = gc_get_ptr_area(ptr);
+        assert(area != NULL);
+        size_t block = BLOCK_FROM_PTR(area, ptr);
+        assert(ATB_IS_HEAD(area, block));
 
         #if MICROPY_ENABLE_FINALISER
-        FTB_CLEAR(block);
+        FTB_CLEAR(area, block);
         #endif
 
         // set the last_free pointer to this block if it's earlier in the heap
-        if (block / BLOCKS_PER_ATB < MP_STATE_MEM(gc_last_free_atb_index)) {
-            MP_STATE_MEM(gc_last_free_atb_index) = block / BLOCKS_PER_ATB;
+        if (block / BLOCKS_PER_ATB < area->gc_last_free_atb_index) {
+            area->gc_last_free_atb_index = block / BLOCKS_PER_ATB;
         }
 
         // free head and all of its tail blocks
+        #if MICROPY_GC_SIZE_CLASSES
+        size_t start_block = block;
+        #endif
         do {
-            ATB_ANY_TO_FREE(block);
+            ATB_ANY_TO_FREE(area, block);
             block += 1;
-        } while (ATB_GET_KIND(block) == AT_TAIL);
+        } while (ATB_GET_KIND(area, block) == AT_TAIL);
+
+        #if MICROPY_GC_SIZE_CLASSES
+        // keep small freed runs for quick reuse
+        if (block - start_block <= MICROPY_GC_SIZE_CLASSES) {
+            gc_size_class_push(area, start_block, block - start_block);
+        }
+        #endif
 
         GC_EXIT();
 
@@ -615,14 +1111,15 @@ void gc_free(void *ptr) {
 
 size_t gc_nbytes(const void *ptr) {
     GC_ENTER();
-    if (VERIFY_PTR(ptr)) {
-        size_t block = BLOCK_FROM_PTR(ptr);
-        if (ATB_GET_KIND(block) == AT_HEAD) {
+    mp_state_mem_area_t *area = gc_get_ptr_area(ptr);
+    if (area != NULL) {
+        size_t block = BLOCK_FROM_PTR(area, ptr);
+        if (ATB_IS_HEAD(area, block)) {
             // work out number of consecutive blocks in the chain starting with this on
             size_t n_blocks = 0;
             do {
                 n_blocks += 1;
-            } while (ATB_GET_KIND(block + n_blocks) == AT_TAIL);
+            } while (ATB_GET_KIND(area, block + n_blocks) == AT_TAIL);
             GC_EXIT();
             return n_blocks * BYTES_PER_BLOCK;
         }
@@ -645,7 +1142,7 @@ void *gc_realloc(void *ptr, mp_uint_t n_bytes) {
             has_finaliser = false;
         } else {
             #if MICROPY_ENABLE_FINALISER
-            has_finaliser = FTB_GET(BLOCK_FROM_PTR((mp_uint_t)ptr));
+            has_finaliser = FTB_GET(area, BLOCK_FROM_PTR(area, (mp_uint_t)ptr));
             #else
             has_finaliser = false;
             #endif
@@ -683,9 +1180,10 @@ void *gc_realloc(void *ptr_in, size_t n_bytes, bool allow_move) {
     GC_ENTER();
 
     // get the GC block number corresponding to this pointer
-    assert(VERIFY_PTR(ptr));
-    size_t block = BLOCK_FROM_PTR(ptr);
-    assert(ATB_GET_KIND(block) == AT_HEAD);
+    mp_state_mem_area_t *area = gc_get_ptr_area(ptr);
+    assert(area != NULL);
+    size_t block = BLOCK_FROM_PTR(area, ptr);
+    assert(ATB_IS_HEAD(area, block));
 
     // compute number of new blocks that are requested
     size_t new_blocks = (n_bytes + BYTES_PER_BLOCK - 1) / BYTES_PER_BLOCK;
@@ -698,9 +1196,9 @@ void *gc_realloc(void *ptr_in, size_t n_bytes, bool allow_move) {
     // efficiently shrink it (see below for shrinking code).
     size_t n_free = 0;
     size_t n_blocks = 1; // counting HEAD block
-    size_t max_block = MP_STATE_MEM(gc_alloc_table_byte_len) * BLOCKS_PER_ATB;
+    size_t max_block = area->gc_alloc_table_byte_len * BLOCKS_PER_ATB;
     for (size_t bl = block + n_blocks; bl < max_block; bl++) {
-        byte block_type = ATB_GET_KIND(bl);
+        byte block_type = ATB_GET_KIND(area, bl);
         if (block_type == AT_TAIL) {
             n_blocks++;
             continue;
@@ -726,12 +1224,12 @@ void *gc_realloc(void *ptr_in, size_t n_bytes, bool allow_move) {
     if (new_blocks < n_blocks) {
         // free unneeded tail blocks
         for (size_t bl = block + new_blocks, count = n_blocks - new_blocks; count > 0; bl++, count--) {
-            ATB_ANY_TO_FREE(bl);
+            ATB_ANY_TO_FREE(area, bl);
         }
 
         // set the last_free pointer to end of this block if it's earlier in the heap
-        if ((block + new_blocks) / BLOCKS_PER_ATB < MP_STATE_MEM(gc_last_free_atb_index)) {
-            MP_STATE_MEM(gc_last_free_atb_index) = (block + new_blocks) / BLOCKS_PER_ATB;
+        if ((block + new_blocks) / BLOCKS_PER_ATB < area->gc_last_free_atb_index) {
+            area->gc_last_free_atb_index = (block + new_blocks) / BLOCKS_PER_ATB;
         }
 
         GC_EXIT();
@@ -747,8 +1245,8 @@ void *gc_realloc(void *ptr_in, size_t n_bytes, bool allow_move) {
     if (new_blocks <= n_blocks + n_free) {
         // mark few more blocks as used tail
         for (size_t bl = block + n_blocks; bl < block + new_blocks; bl++) {
-            assert(ATB_GET_KIND(bl) == AT_FREE);
-            ATB_FREE_TO_TAIL(bl);
+            assert(ATB_GET_KIND(area, bl) == AT_FREE);
+            ATB_FREE_TO_TAIL(area, bl);
         }
 
         GC_EXIT();
@@ -769,7 +1267,7 @@ void *gc_realloc(void *ptr_in, size_t n_bytes, bool allow_move) {
     }
 
     #if MICROPY_ENABLE_FINALISER
-    bool ftb_state = FTB_GET(block);
+    bool ftb_state = FTB_GET(area, block);
     #else
     bool ftb_state = false;
     #endif
@@ -803,134 +1301,141 @@ void gc_dump_info(void) {
         (uint)info.total, (uint)info.used, (uint)info.free);
     mp_printf(&mp_plat_print, " No. of 1-blocks: %u, 2-blocks: %u, max blk sz: %u, max free sz: %u\n",
         (uint)info.num_1block, (uint)info.num_2block, (uint)info.max_block, (uint)info.max_free);
+    mp_printf(&mp_plat_print, " Free runs by log2 size:");
+    for (size_t i = 0; i < GC_INFO_FREE_RUNS_LEN; i++) {
+        mp_printf(&mp_plat_print, " %u", (uint)info.free_runs[i]);
+    }
+    mp_printf(&mp_plat_print, "\n");
 }
 
 void gc_dump_alloc_table(void) {
     GC_ENTER();
     static const size_t DUMP_BYTES_PER_LINE = 64;
-    #if !EXTENSIVE_HEAP_PROFILING
-    // When comparing heap output we don't want to print the starting
-    // pointer of the heap because it changes from run to run.
-    mp_printf(&mp_plat_print, "GC memory layout; from %p:", MP_STATE_MEM(gc_pool_start));
-    #endif
-    for (size_t bl = 0; bl < MP_STATE_MEM(gc_alloc_table_byte_len) * BLOCKS_PER_ATB; bl++) {
-        if (bl % DUMP_BYTES_PER_LINE == 0) {
-            // a new line of blocks
-            {
-                // check if this line contains only free blocks
-                size_t bl2 = bl;
-                while (bl2 < MP_STATE_MEM(gc_alloc_table_byte_len) * BLOCKS_PER_ATB && ATB_GET_KIND(bl2) == AT_FREE) {
-                    bl2++;
-                }
-                if (bl2 - bl >= 2 * DUMP_BYTES_PER_LINE) {
-                    // there are at least 2 lines containing only free blocks, so abbreviate their printing
-                    mp_printf(&mp_plat_print, "\n       (%u lines all free)", (uint)(bl2 - bl) / DUMP_BYTES_PER_LINE);
-                    bl = bl2 & (~(DUMP_BYTES_PER_LINE - 1));
-                    if (bl >= MP_STATE_MEM(gc_alloc_table_byte_len) * BLOCKS_PER_ATB) {
-                        // got to end of heap
-                        break;
-                    }
-                }
-            }
-            // print header for new line of blocks
-            // (the cast to uint32_t is for 16-bit ports)
-            // mp_printf(&mp_plat_print, "\n%05x: ", (uint)(PTR_FROM_BLOCK(bl) & (uint32_t)0xfffff));
-            mp_printf(&mp_plat_print, "\n%05x: ", (uint)((bl * BYTES_PER_BLOCK) & (uint32_t)0xfffff));
-        }
-        int c = ' ';
-        switch (ATB_GET_KIND(bl)) {
-            case AT_FREE:
-                c = '.';
-                break;
-            /* this prints out if the object is reachable from BSS or STACK (for unix only)
-            case AT_HEAD: {
-                c = 'h';
-                void **ptrs = (void**)(void*)&mp_state_ctx;
-                mp_uint_t len = offsetof(mp_state_ctx_t, vm.stack_top) / sizeof(mp_uint_t);
-                for (mp_uint_t i = 0; i < len; i++) {
-                    mp_uint_t ptr = (mp_uint_t)ptrs[i];
-                    if (VERIFY_PTR(ptr) && BLOCK_FROM_PTR(ptr) == bl) {
-                        c = 'B';
-                        break;
+    for (mp_state_mem_area_t *area = &MP_STATE_MEM(area); area != NULL; area = NEXT_AREA(area)) {
+        #if !EXTENSIVE_HEAP_PROFILING
+        // When comparing heap output we don't want to print the starting
+        // pointer of the heap because it changes from run to run.
+        mp_printf(&mp_plat_print, "GC memory layout; from %p:", area->gc_pool_start);
+        #endif
+        for (size_t bl = 0; bl < area->gc_alloc_table_byte_len * BLOCKS_PER_ATB; bl++) {
+            if (bl % DUMP_BYTES_PER_LINE == 0) {
+                // a new line of blocks
+                {
+                    // check if this line contains only free blocks
+                    size_t bl2 = bl;
+                    while (bl2 < area->gc_alloc_table_byte_len * BLOCKS_PER_ATB && ATB_GET_KIND(area, bl2) == AT_FREE) {
+                        bl2++;
                     }
-                }
-                if (c == 'h') {
-                    ptrs = (void**)&c;
-                    len = ((mp_uint_t)MP_STATE_THREAD(stack_top) - (mp_uint_t)&c) / sizeof(mp_uint_t);
-                    for (mp_uint_t i = 0; i < len; i++) {
-                        mp_uint_t ptr = (mp_uint_t)ptrs[i];
-                        if (VERIFY_PTR(ptr) && BLOCK_FROM_PTR(ptr) == bl) {
-                            c = 'S';
+                    if (bl2 - bl >= 2 * DUMP_BYTES_PER_LINE) {
+                        // there are at least 2 lines containing only free blocks, so abbreviate their printing
+                        mp_printf(&mp_plat_print, "\n       (%u lines all free)", (uint)(bl2 - bl) / DUMP_BYTES_PER_LINE);
+                        bl = bl2 & (~(DUMP_BYTES_PER_LINE - 1));
+                        if (bl >= area->gc_alloc_table_byte_len * BLOCKS_PER_ATB) {
+                            // got to end of heap
                             break;
                         }
                     }
                 }
-                break;
+                // print header for new line of blocks
+                // (the cast to uint32_t is for 16-bit ports)
+                // mp_printf(&mp_plat_print, "\n%05x: ", (uint)(PTR_FROM_BLOCK(bl) & (uint32_t)0xfffff));
+                mp_printf(&mp_plat_print, "\n%05x: ", (uint)((bl * BYTES_PER_BLOCK) & (uint32_t)0xfffff));
             }
-            */
-            /* this prints the uPy object type of the head block */
-            case AT_HEAD: {
-                void **ptr = (void **)(MP_STATE_MEM(gc_pool_start) + bl * BYTES_PER_BLOCK);
-                if (*ptr == &mp_type_tuple) {
-                    c = 'T';
-                } else if (*ptr == &mp_type_list) {
-                    c = 'L';
-                } else if (*ptr == &mp_type_dict) {
-                    c = 'D';
-                } else if (*ptr == &mp_type_str || *ptr == &mp_type_bytes) {
-                    c = 'S';
-                }
-                #if MICROPY_PY_BUILTINS_BYTEARRAY
-                else if (*ptr == &mp_type_bytearray) {
-                    c = 'A';
-                }
-                #endif
-                #if MICROPY_PY_ARRAY
-                else if (*ptr == &mp_type_array) {
-                    c = 'A';
-                }
-                #endif
-                #if MICROPY_PY_BUILTINS_FLOAT
-                else if (*ptr == &mp_type_float) {
-                    c = 'F';
-                }
-                #endif
-                else if (*ptr == &mp_type_fun_bc) {
-                    c = 'B';
-                } else if (*ptr == &mp_type_module) {
-                    c = 'M';
-                } else {
+            int c = ' ';
+            switch (ATB_GET_KIND(area, bl)) {
+                case AT_FREE:
+                    c = '.';
+                    break;
+                /* this prints out if the object is reachable from BSS or STACK (for unix only)
+                case AT_HEAD: {
                     c = 'h';
-                    #if 0
-                    // This code prints "Q" for qstr-pool data, and "q" for qstr-str
-                    // data.  It can be useful to see how qstrs are being allocated,
-                    // but is disabled by default because it is very slow.
-                    for (qstr_pool_t *pool = MP_STATE_VM(last_pool); c == 'h' && pool != NULL; pool = pool->prev) {
-                        if ((qstr_pool_t *)ptr == pool) {
-                            c = 'Q';
+                    void **ptrs = (void**)(void*)&mp_state_ctx;
+                    mp_uint_t len = offsetof(mp_state_ctx_t, vm.stack_top) / sizeof(mp_uint_t);
+                    for (mp_uint_t i = 0; i < len; i++) {
+                        mp_uint_t ptr = (mp_uint_t)ptrs[i];
+                        if (VERIFY_PTR(area, ptr) && BLOCK_FROM_PTR(area, ptr) == bl) {
+                            c = 'B';
                             break;
                         }
-                        for (const byte **q = pool->qstrs, **q_top = pool->qstrs + pool->len; q < q_top; q++) {
-                            if ((const byte *)ptr == *q) {
-                                c = 'q';
+                    }
+                    if (c == 'h') {
+                        ptrs = (void**)&c;
+                        len = ((mp_uint_t)MP_STATE_THREAD(stack_top) - (mp_uint_t)&c) / sizeof(mp_uint_t);
+                        for (mp_uint_t i = 0; i < len; i++) {
+                            mp_uint_t ptr = (mp_uint_t)ptrs[i];
+                            if (VERIFY_PTR(area, ptr) && BLOCK_FROM_PTR(area, ptr) == bl) {
+                                c = 'S';
                                 break;
                             }
                         }
                     }
+                    break;
+                }
+                */
+                /* this prints the uPy object type of the head block */
+                case AT_HEAD: {
+                    void **ptr = (void **)(area->gc_pool_start + bl * BYTES_PER_BLOCK);
+                    if (*ptr == &mp_type_tuple) {
+                        c = 'T';
+                    } else if (*ptr == &mp_type_list) {
+                        c = 'L';
+                    } else if (*ptr == &mp_type_dict) {
+                        c = 'D';
+                    } else if (*ptr == &mp_type_str || *ptr == &mp_type_bytes) {
+                        c = 'S';
+                    }
+                    #if MICROPY_PY_BUILTINS_BYTEARRAY
+                    else if (*ptr == &mp_type_bytearray) {
+                        c = 'A';
+                    }
+                    #endif
+                    #if MICROPY_PY_ARRAY
+                    else if (*ptr == &mp_type_array) {
+                        c = 'A';
+                    }
+                    #endif
+                    #if MICROPY_PY_BUILTINS_FLOAT
+                    else if (*ptr == &mp_type_float) {
+                        c = 'F';
+                    }
                     #endif
+                    else if (*ptr == &mp_type_fun_bc) {
+                        c = 'B';
+                    } else if (*ptr == &mp_type_module) {
+                        c = 'M';
+                    } else {
+                        c = 'h';
+                        #if 0
+                        // This code prints "Q" for qstr-pool data, and "q" for qstr-str
+                        // data.  It can be useful to see how qstrs are being allocated,
+                        // but is disabled by default because it is very slow.
+                        for (qstr_pool_t *pool = MP_STATE_VM(last_pool); c == 'h' && pool != NULL; pool = pool->prev) {
+                            if ((qstr_pool_t *)ptr == pool) {
+                                c = 'Q';
+                                break;
+                            }
+                            for (const byte **q = pool->qstrs, **q_top = pool->qstrs + pool->len; q < q_top; q++) {
+                                if ((const byte *)ptr == *q) {
+                                    c = 'q';
+                                    break;
+                                }
+                            }
+                        }
+                        #endif
+                    }
+                    break;
                 }
-                break;
+                case AT_TAIL:
+                    c = '=';
+                    break;
+                case AT_MARK:
+                    c = 'm';
+                    break;
             }
-            case AT_TAIL:
-                c = '=';
-                break;
-            case AT_MARK:
-                c = 'm';
-                break;
+            mp_printf(&mp_plat_print, "%c", c);
         }
-        mp_printf(&mp_plat_print, "%c", c);
+        mp_print_str(&mp_plat_print, "\n");
     }
-    mp_print_str(&mp_plat_print, "\n");
     GC_EXIT();
 }
 
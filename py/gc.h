@@ -29,8 +29,15 @@
 #include <stdbool.h>
 #include <stddef.h>
 
+#include "py/mpconfig.h"
+
 void gc_init(void *start, void *end);
 
+#if MICROPY_GC_SPLIT_HEAP
+// Used to add additional memory areas to the heap.
+void gc_add(void *start, void *end);
+#endif
+
 // These lock/unlock functions can be nested.
 // They can be used to prevent the GC from allocating/freeing.
 void gc_lock(void);
@@ -55,6 +62,15 @@ void gc_free(void *ptr); // does not call finaliser
 size_t gc_nbytes(const void *ptr);
 void *gc_realloc(void *ptr, size_t n_bytes, bool allow_move);
 
+#if MICROPY_GC_PROFILE
+void gc_profile_reset(void);
+#endif
+
+// Number of buckets in the histogram of free runs: bucket n counts the free
+// runs of 2**n to 2**(n+1)-1 blocks, with the last bucket counting all longer
+// runs.
+#define GC_INFO_FREE_RUNS_LEN (8)
+
 typedef struct _gc_info_t {
     size_t total;
     size_t used;
@@ -63,6 +79,7 @@ typedef struct _gc_info_t {
     size_t num_1block;
     size_t num_2block;
     size_t max_block;
+    size_t free_runs[GC_INFO_FREE_RUNS_LEN];
 } gc_info_t;
 
 void gc_info(gc_info_t *info);
@@ -223,10 +223,15 @@ static_qstr_list = [
 ]
 
 # this must match the equivalent function in qstr.c
-def compute_hash(qstr, bytes_hash):
+def compute_hash_full(qstr):
     hash = 5381
     for b in qstr:
-        hash = (hash * 33) ^ b
+        hash = ((hash * 33) ^ b) & 0xFFFFFFFF
+    return hash
+
+
+def compute_hash(qstr, bytes_hash):
+    hash = compute_hash_full(qstr)
     # Make sure that valid hash is never zero, zero means "hash not computed"
     return (hash & ((1 << (8 * bytes_hash)) - 1)) or 1
 
@@ -359,6 +364,32 @@ def print_qstr_data(qcfgs, qstrs):
         qbytes = make_bytes(cfg_bytes_len, cfg_bytes_hash, qstr)
         print("QDEF(MP_QSTR_%s, %s)" % (ident, qbytes))
 
+    print_qstr_hash_index([qstr for _, _, qstr in sorted(qstrs.values(), key=lambda x: x[0])])
+
+
+# Print a hash table of the qstrs, using open addressing with linear probing,
+# for use by qstr_find_strn.  Each entry is a qstr id, or 0 if empty.
+def print_qstr_hash_index(qstrs):
+    # keep the load factor at or below 2/3
+    size = 16
+    while size * 2 < len(qstrs) * 3:
+        size *= 2
+    table = [0] * size
+    # qstr ids start at 1, after MP_QSTRnull
+    for q, qstr in enumerate(qstrs, 1):
+        i = compute_hash_full(bytes_cons(qstr, "utf8")) & (size - 1)
+        while table[i]:
+            i = (i + 1) & (size - 1)
+        table[i] = q
+
+    print("")
+    print("#ifdef QSTR_HASH_INDEX")
+    print("QSTR_HASH_INDEX(%u) = {" % size)
+    for i in range(0, size, 16):
+        print("    %s," % ", ".join(str(q) for q in table[i : i + 16]))
+    print("};")
+    print("#endif")
+
 
 def do_work(infiles):
     qcfgs, qstrs = parse_input_headers(infiles)
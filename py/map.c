@@ -40,6 +40,15 @@
 #define DEBUG_printf(...) (void)0
 #endif
 
+#if MICROPY_OPT_MAP_LOOKUP_CACHE
+// Slot in the map lookup cache for a given map and qstr key.  The cache stores
+// the low 8 bits of the position of the key, which is verified before use.
+#define MAP_LOOKUP_CACHE_HASH(map, index) \
+    ((((uintptr_t)(map)->table >> 3) ^ ((uintptr_t)(index) >> 3)) & (MICROPY_OPT_MAP_LOOKUP_CACHE_SIZE - 1))
+#endif
+
+#if !MICROPY_MAP_COMPACT || MICROPY_PY_BUILTINS_SET
+
 // This table of sizes is used to control the growth of hash tables.
 // The first set of sizes are chosen so the allocation fits exactly in a
 // 4-word GC block, and it's not so important for these small values to be
@@ -62,6 +71,141 @@ STATIC size_t get_hash_alloc_greater_or_equal_to(size_t x) {
     return (x + x / 2) | 1;
 }
 
+#endif
+
+#if MICROPY_MAP_COMPACT
+
+// With compact maps, the table of a map that is not a fixed array holds the
+// entries in insertion order, from the start of the table up to its fill.  A
+// removed entry is left in place with its key set to MP_OBJ_SENTINEL, so that
+// iteration over the table is not disturbed, and is only dropped when the
+// table is rehashed or when it is at the end of the entries.  Maps with more
+// than a few entries follow them, in the same allocation, by the fill and an
+// index: an open-addressed hash table with a power of 2 number of slots, each
+// 1, 2 or 4 bytes wide depending on alloc, and holding either 0 for an empty
+// slot, all ones for a deleted slot, or 1 + the position of an entry.  Only
+// the index is kept sparse (at most 2/3 full), so the entries need no spare
+// room for hashing.
+
+// Fixed tables, such as those in ROM, are plain arrays without an index.
+#define MAP_IS_LINEAR(map) ((map)->is_fixed && (map)->is_ordered)
+
+// Maps with up to this many entries have no index and are searched linearly,
+// which is as fast as hashing for so few entries and saves the index memory.
+#define MAP_COMPACT_LINEAR_MAX (8)
+
+typedef struct _map_index_t {
+    size_t *fill;
+    byte *slots;
+    size_t len;
+    size_t width;
+    size_t deleted;
+} map_index_t;
+
+STATIC size_t map_index_len(size_t alloc) {
+    if (alloc <= MAP_COMPACT_LINEAR_MAX) {
+        return 0;
+    }
+    size_t len = 16;
+    while (len <= alloc + alloc / 2) {
+        len <<= 1;
+    }
+    return len;
+}
+
+STATIC size_t map_index_width(size_t alloc) {
+    return alloc < 0xff ? 1 : alloc < 0xffff ? 2 : 4;
+}
+
+size_t mp_map_table_bytes(size_t alloc) {
+    size_t len = map_index_len(alloc);
+    if (len == 0) {
+        return alloc * sizeof(mp_map_elem_t);
+    }
+    return alloc * sizeof(mp_map_elem_t) + sizeof(size_t) + len * map_index_width(alloc);
+}
+
+STATIC void map_index_init(map_index_t *idx, const mp_map_t *map) {
+    idx->fill = (size_t *)&map->table[map->alloc];
+    idx->slots = (byte *)(idx->fill + 1);
+    idx->len = map_index_len(map->alloc);
+    idx->width = map_index_width(map->alloc);
+    idx->deleted = idx->width == 1 ? 0xff : idx->width == 2 ? 0xffff : 0xffffffff;
+}
+
+STATIC size_t map_index_get(const map_index_t *idx, size_t i) {
+    if (idx->width == 1) {
+        return idx->slots[i];
+    } else if (idx->width == 2) {
+        return ((uint16_t *)idx->slots)[i];
+    } else {
+        return ((uint32_t *)idx->slots)[i];
+    }
+}
+
+STATIC void map_index_set(const map_index_t *idx, size_t i, size_t value) {
+    if (idx->width == 1) {
+        idx->slots[i] = value;
+    } else if (idx->width == 2) {
+        ((uint16_t *)idx->slots)[i] = value;
+    } else {
+        ((uint32_t *)idx->slots)[i] = value;
+    }
+}
+
+STATIC mp_uint_t map_hash(mp_obj_t key) {
+    if (mp_obj_is_qstr(key)) {
+        return qstr_hash(MP_OBJ_QSTR_VALUE(key));
+    } else {
+        return MP_OBJ_SMALL_INT_VALUE(mp_unary_op(MP_UNARY_OP_HASH, key));
+    }
+}
+
+// Position after the last entry, where the next one is added.  Small maps
+// don't store it, but all their entries before it have a non-null key.
+STATIC size_t map_get_fill(const mp_map_t *map, const map_index_t *idx) {
+    if (idx->len != 0) {
+        return *idx->fill;
+    }
+    size_t fill = map->used;
+    while (fill < map->alloc && map->table[fill].key != MP_OBJ_NULL) {
+        ++fill;
+    }
+    return fill;
+}
+
+size_t mp_map_fill(const mp_map_t *map) {
+    map_index_t idx;
+    map_index_init(&idx, map);
+    return map_get_fill(map, &idx);
+}
+
+// Remove the entry at pos, whose index slot (if any) must already be marked
+// deleted.  The entry stays in the table as a deleted one, keeping its value
+// so the caller can access it, and the returned slot is that of the entry.
+// Deleted entries at the end of the table are dropped, so the last entry
+// before the fill is always a live one.
+STATIC mp_map_elem_t *map_remove_entry(mp_map_t *map, const map_index_t *idx, size_t pos) {
+    size_t fill = map_get_fill(map, idx);
+    --map->used;
+    map->table[pos].key = MP_OBJ_SENTINEL;
+    if (pos + 1 == fill) {
+        do {
+            map->table[--fill].key = MP_OBJ_NULL;
+        } while (fill > 0 && map->table[fill - 1].key == MP_OBJ_SENTINEL);
+        if (idx->len != 0) {
+            *idx->fill = fill;
+        }
+    }
+    return &map->table[pos];
+}
+
+#else
+
+#define MAP_IS_LINEAR(map) ((map)->is_ordered)
+
+#endif
+
 /******************************************************************************/
 /* map                                                                        */
 
@@ -71,12 +215,19 @@ void mp_map_init(mp_map_t *map, size_t n) {
         map->table = NULL;
     } else {
         map->alloc = n;
+        #if MICROPY_MAP_COMPACT
+        map->table = (mp_map_elem_t *)m_new0(byte, mp_map_table_bytes(n));
+        #else
         map->table = m_new0(mp_map_elem_t, map->alloc);
+        #endif
     }
     map->used = 0;
     map->all_keys_are_qstrs = 1;
     map->is_fixed = 0;
     map->is_ordered = 0;
+    #if MICROPY_OPT_TYPE_ATTR_CACHE
+    map->is_class_locals = 0;
+    #endif
 }
 
 void mp_map_init_fixed_table(mp_map_t *map, size_t n, const mp_obj_t *table) {
@@ -85,20 +236,31 @@ void mp_map_init_fixed_table(mp_map_t *map, size_t n, const mp_obj_t *table) {
     map->all_keys_are_qstrs = 1;
     map->is_fixed = 1;
     map->is_ordered = 1;
+    #if MICROPY_OPT_TYPE_ATTR_CACHE
+    map->is_class_locals = 0;
+    #endif
     map->table = (mp_map_elem_t *)table;
 }
 
 // Differentiate from mp_map_clear() - semantics is different
 void mp_map_deinit(mp_map_t *map) {
     if (!map->is_fixed) {
+        #if MICROPY_MAP_COMPACT
+        m_del(byte, map->table, mp_map_table_bytes(map->alloc));
+        #else
         m_del(mp_map_elem_t, map->table, map->alloc);
+        #endif
     }
     map->used = map->alloc = 0;
 }
 
 void mp_map_clear(mp_map_t *map) {
     if (!map->is_fixed) {
+        #if MICROPY_MAP_COMPACT
+        m_del(byte, map->table, mp_map_table_bytes(map->alloc));
+        #else
         m_del(mp_map_elem_t, map->table, map->alloc);
+        #endif
     }
     map->alloc = 0;
     map->used = 0;
@@ -107,6 +269,53 @@ void mp_map_clear(mp_map_t *map) {
     map->table = NULL;
 }
 
+#if MICROPY_MAP_COMPACT
+
+// Grow the table if the entries are (nearly) full, otherwise just rebuild it
+// to drop the deleted entries and index slots.
+STATIC void mp_map_rehash(mp_map_t *map) {
+    size_t old_alloc = map->alloc;
+    size_t new_alloc = old_alloc;
+    if (map->used >= old_alloc - old_alloc / 4) {
+        size_t len = map_index_len(old_alloc);
+        if (old_alloc < MAP_COMPACT_LINEAR_MAX) {
+            new_alloc = old_alloc + 2;
+        } else {
+            // largest alloc whose index has twice as many slots as now
+            len = len ? 2 * len : 32;
+            new_alloc = (2 * len - 1) / 3;
+        }
+    }
+    DEBUG_printf("mp_map_rehash(%p): " UINT_FMT " -> " UINT_FMT "\n", map, old_alloc, new_alloc);
+    mp_map_elem_t *old_table = map->table;
+    mp_map_elem_t *new_table = (mp_map_elem_t *)m_new0(byte, mp_map_table_bytes(new_alloc));
+    // If we reach this point, table resizing succeeded, now we can edit the old map.
+    size_t old_fill = mp_map_fill(map);
+    size_t used = 0;
+    for (size_t i = 0; i < old_fill; i++) {
+        if (old_table[i].key != MP_OBJ_SENTINEL) {
+            new_table[used++] = old_table[i];
+        }
+    }
+    map->alloc = new_alloc;
+    map->table = new_table;
+    map_index_t idx;
+    map_index_init(&idx, map);
+    if (idx.len != 0) {
+        *idx.fill = used;
+    }
+    for (size_t i = 0; idx.len != 0 && i < used; i++) {
+        size_t pos = map_hash(new_table[i].key) & (idx.len - 1);
+        while (map_index_get(&idx, pos) != 0) {
+            pos = (pos + 1) & (idx.len - 1);
+        }
+        map_index_set(&idx, pos, i + 1);
+    }
+    m_del(byte, old_table, mp_map_table_bytes(old_alloc));
+}
+
+#else
+
 STATIC void mp_map_rehash(mp_map_t *map) {
     size_t old_alloc = map->alloc;
     size_t new_alloc = get_hash_alloc_greater_or_equal_to(map->alloc + 1);
@@ -126,6 +335,8 @@ STATIC void mp_map_rehash(mp_map_t *map) {
     m_del(mp_map_elem_t, old_table, old_alloc);
 }
 
+#endif
+
 // MP_MAP_LOOKUP behaviour:
 //  - returns NULL if not found, else the slot it was found in with key,value non-null
 // MP_MAP_LOOKUP_ADD_IF_NOT_FOUND behaviour:
@@ -156,9 +367,25 @@ mp_map_elem_t *mp_map_lookup(mp_map_t *map, mp_obj_t index, mp_map_lookup_kind_t
     }
 
     // if the map is an ordered array then we must do a brute force linear search
-    if (map->is_ordered) {
+    if (MAP_IS_LINEAR(map)) {
+        #if MICROPY_OPT_MAP_LOOKUP_CACHE
+        // first try the position where this key was last found in this map
+        uint8_t *cache_slot = NULL;
+        if (lookup_kind == MP_MAP_LOOKUP && mp_obj_is_qstr(index)) {
+            cache_slot = &MP_STATE_VM(map_lookup_cache)[MAP_LOOKUP_CACHE_HASH(map, index)];
+            size_t i = *cache_slot;
+            if (i < map->used && map->table[i].key == index) {
+                return &map->table[i];
+            }
+        }
+        #endif
         for (mp_map_elem_t *elem = &map->table[0], *top = &map->table[map->used]; elem < top; elem++) {
             if (elem->key == index || (!compare_only_ptrs && mp_obj_equal(elem->key, index))) {
+                #if MICROPY_OPT_MAP_LOOKUP_CACHE
+                if (cache_slot != NULL) {
+                    *cache_slot = elem - &map->table[0];
+                }
+                #endif
                 #if MICROPY_PY_COLLECTIONS_ORDEREDDICT
                 if (MP_UNLIKELY(lookup_kind == MP_MAP_LOOKUP_REMOVE_IF_FOUND)) {
                     // remove the found element by moving the rest of the array down
@@ -206,6 +433,107 @@ mp_map_elem_t *mp_map_lookup(mp_map_t *map, mp_obj_t index, mp_map_lookup_kind_t
         }
     }
 
+    #if MICROPY_MAP_COMPACT
+
+    for (;;) {
+        map_index_t idx;
+        map_index_init(&idx, map);
+
+        if (idx.len == 0) {
+            // small map without an index, so search the entries linearly
+            if (!mp_obj_is_qstr(index) && !mp_obj_is_small_int(index)) {
+                // hash the index anyway so unhashable objects are rejected
+                map_hash(index);
+            }
+            size_t fill = 0;
+            for (; fill < map->alloc && map->table[fill].key != MP_OBJ_NULL; fill++) {
+                mp_map_elem_t *elem = &map->table[fill];
+                if (elem->key == MP_OBJ_SENTINEL) {
+                    continue;
+                }
+                if (elem->key == index || (!compare_only_ptrs && mp_obj_equal(elem->key, index))) {
+                    if (lookup_kind == MP_MAP_LOOKUP_REMOVE_IF_FOUND) {
+                        elem = map_remove_entry(map, &idx, fill);
+                    }
+                    return elem;
+                }
+            }
+            if (lookup_kind != MP_MAP_LOOKUP_ADD_IF_NOT_FOUND) {
+                return NULL;
+            }
+            if (fill < map->alloc) {
+                map->used++;
+                mp_map_elem_t *elem = &map->table[fill];
+                elem->key = index;
+                elem->value = MP_OBJ_NULL;
+                if (!mp_obj_is_qstr(index)) {
+                    map->all_keys_are_qstrs = 0;
+                }
+                return elem;
+            }
+            mp_map_rehash(map);
+            continue;
+        }
+
+        // map has an index, so probe it for the position of the entry
+        size_t mask = idx.len - 1;
+        size_t pos = map_hash(index) & mask;
+        size_t avail_pos = idx.len;
+        size_t n = idx.len;
+        for (; n > 0; --n) {
+            size_t v = map_index_get(&idx, pos);
+            if (v == 0) {
+                // found empty slot, so index is not in map
+                break;
+            } else if (v == idx.deleted) {
+                // found deleted slot, remember for later
+                if (avail_pos == idx.len) {
+                    avail_pos = pos;
+                }
+            } else {
+                mp_map_elem_t *elem = &map->table[v - 1];
+                if (elem->key == index || (!compare_only_ptrs && mp_obj_equal(elem->key, index))) {
+                    // found index
+                    if (lookup_kind == MP_MAP_LOOKUP_REMOVE_IF_FOUND) {
+                        map_index_set(&idx, pos, idx.deleted);
+                        elem = map_remove_entry(map, &idx, v - 1);
+                    }
+                    return elem;
+                }
+            }
+            pos = (pos + 1) & mask;
+        }
+
+        if (lookup_kind != MP_MAP_LOOKUP_ADD_IF_NOT_FOUND) {
+            return NULL;
+        }
+
+        // if there is room for the entry and an empty slot was reached (so
+        // probes don't get too long) then add the entry at the end
+        size_t fill = *idx.fill;
+        if (fill < map->alloc && n > 0) {
+            if (avail_pos == idx.len) {
+                avail_pos = pos;
+            }
+            map->used++;
+            mp_map_elem_t *elem = &map->table[fill];
+            *idx.fill = fill + 1;
+            map_index_set(&idx, avail_pos, fill + 1);
+            elem->key = index;
+            elem->value = MP_OBJ_NULL;
+            if (!mp_obj_is_qstr(index)) {
+                map->all_keys_are_qstrs = 0;
+            }
+            return elem;
+        }
+
+        // grow the map, or clean its index, and try again
+        mp_map_rehash(map);
+    }
+
+    #else
+
+
     // get hash of index, with fast path for common case of qstr
     mp_uint_t hash;
     if (mp_obj_is_qstr(index)) {
@@ -283,6 +611,8 @@ mp_map_elem_t *mp_map_lookup(mp_map_t *map, mp_obj_t index, mp_map_lookup_kind_t
             }
         }
     }
+
+    #endif
 }
 
 /******************************************************************************/
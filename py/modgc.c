@@ -95,6 +95,62 @@ STATIC mp_obj_t gc_threshold(size_t n_args, const mp_obj_t *args) {
 MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(gc_threshold_obj, 0, 1, gc_threshold);
 #endif
 
+#if MICROPY_GC_INCREMENTAL_SWEEP
+// sweep_budget([us]): maximum pause of each slice of a deferred sweep, 0 or
+// negative to sweep the whole heap as part of each collection
+STATIC mp_obj_t gc_sweep_budget(size_t n_args, const mp_obj_t *args) {
+    if (n_args == 0) {
+        return mp_obj_new_int_from_uint(MP_STATE_MEM(gc_sweep_budget_us));
+    }
+    mp_int_t val = mp_obj_get_int(args[0]);
+    if (val < 0) {
+        MP_STATE_MEM(gc_sweep_budget_us) = 0;
+    } else {
+        MP_STATE_MEM(gc_sweep_budget_us) = val;
+    }
+    return mp_const_none;
+}
+MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(gc_sweep_budget_obj, 0, 1, gc_sweep_budget);
+#endif
+
+#if MICROPY_GC_PROFILE
+// profile([reset]): return the collection pause times and allocation sites
+// recorded so far, then clear them if reset is true
+STATIC mp_obj_t gc_profile(size_t n_args, const mp_obj_t *args) {
+    mp_obj_t sites = mp_obj_new_list(0, NULL);
+    for (size_t i = 0; i < MICROPY_GC_PROFILE_SITES; ++i) {
+        // take a copy, the allocations below are recorded too
+        mp_state_mem_site_t site = MP_STATE_MEM(gc_prof_sites)[i];
+        if (site.count == 0) {
+            continue;
+        }
+        mp_obj_t items[5] = {
+            site.source_file == MP_QSTRnull ? mp_const_none : MP_OBJ_NEW_QSTR(site.source_file),
+            site.block_name == MP_QSTRnull ? mp_const_none : MP_OBJ_NEW_QSTR(site.block_name),
+            MP_OBJ_NEW_SMALL_INT(site.line),
+            mp_obj_new_int_from_uint(site.count),
+            mp_obj_new_int_from_uint(site.bytes),
+        };
+        mp_obj_list_append(sites, mp_obj_new_tuple(5, items));
+    }
+    mp_obj_t items[7] = {
+        mp_obj_new_int_from_uint(MP_STATE_MEM(gc_prof_collections)),
+        mp_obj_new_int_from_uint(MP_STATE_MEM(gc_prof_pause_us)[0]),
+        mp_obj_new_int_from_uint(MP_STATE_MEM(gc_prof_pause_max_us)[0]),
+        mp_obj_new_int_from_uint(MP_STATE_MEM(gc_prof_pause_us)[1]),
+        mp_obj_new_int_from_uint(MP_STATE_MEM(gc_prof_pause_max_us)[1]),
+        sites,
+        mp_obj_new_int_from_uint(MP_STATE_MEM(gc_prof_sites_dropped)),
+    };
+    mp_obj_t result = mp_obj_new_tuple(7, items);
+    if (n_args == 1 && mp_obj_is_true(args[0])) {
+        gc_profile_reset();
+    }
+    return result;
+}
+MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(gc_profile_obj, 0, 1, gc_profile);
+#endif
+
 STATIC const mp_rom_map_elem_t mp_module_gc_globals_table[] = {
     { MP_ROM_QSTR(MP_QSTR___name__), MP_ROM_QSTR(MP_QSTR_gc) },
     { MP_ROM_QSTR(MP_QSTR_collect), MP_ROM_PTR(&gc_collect_obj) },
@@ -106,6 +162,12 @@ STATIC const mp_rom_map_elem_t mp_module_gc_globals_table[] = {
     #if MICROPY_GC_ALLOC_THRESHOLD
     { MP_ROM_QSTR(MP_QSTR_threshold), MP_ROM_PTR(&gc_threshold_obj) },
     #endif
+    #if MICROPY_GC_INCREMENTAL_SWEEP
+    { MP_ROM_QSTR(MP_QSTR_sweep_budget), MP_ROM_PTR(&gc_sweep_budget_obj) },
+    #endif
+    #if MICROPY_GC_PROFILE
+    { MP_ROM_QSTR(MP_QSTR_profile), MP_ROM_PTR(&gc_profile_obj) },
+    #endif
 };
 
 STATIC MP_DEFINE_CONST_DICT(mp_module_gc_globals, mp_module_gc_globals_table);
@@ -174,6 +174,16 @@ STATIC void *thread_entry(void *args_in) {
     // The GC starts off unlocked on this thread.
     ts.gc_lock_depth = 0;
 
+    #if MICROPY_PY_SYS_SETTRACE || MICROPY_GC_PROFILE
+    // No bytecode is executing on this thread yet.
+    ts.current_code_state = NULL;
+    #endif
+
+    #if MICROPY_OPT_TYPE_ATTR_CACHE
+    // Start with an empty type attribute cache.
+    memset(ts.type_attr_cache, 0, sizeof(ts.type_attr_cache));
+    #endif
+
     // set locals and globals from the calling context
     mp_locals_set(args->dict_locals);
     mp_globals_set(args->dict_globals);
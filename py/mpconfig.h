@@ -153,6 +153,58 @@
 #define MICROPY_GC_CONSERVATIVE_CLEAR (MICROPY_ENABLE_GC)
 #endif
 
+// Support for a GC heap made up of multiple discontiguous memory areas, which
+// are added after gc_init() with gc_add().
+#ifndef MICROPY_GC_SPLIT_HEAP
+#define MICROPY_GC_SPLIT_HEAP (0)
+#endif
+
+// Number of size classes (in blocks) served from per-class stacks of free
+// runs, which are rebuilt during the sweep phase.  Allocations up to this
+// many blocks then avoid a linear scan of the allocation table.
+#ifndef MICROPY_GC_SIZE_CLASSES
+#define MICROPY_GC_SIZE_CLASSES (0)
+#endif
+
+// Maximum number of free runs recorded for each size class.
+#ifndef MICROPY_GC_SIZE_CLASS_DEPTH
+#define MICROPY_GC_SIZE_CLASS_DEPTH (16)
+#endif
+
+// Allocations of up to this many blocks are bump-allocated from a nursery,
+// which is the longest free run found by the most recent sweep.  Short-lived
+// objects are then packed together and freed together.  Set to 0 to disable.
+#ifndef MICROPY_GC_NURSERY
+#define MICROPY_GC_NURSERY (0)
+#endif
+
+// Support deferring the sweep phase of automatic collections, so that it is
+// done in time-limited slices by subsequent allocations, configurable by
+// gc.sweep_budget().  Requires mp_hal_ticks_us().
+#ifndef MICROPY_GC_INCREMENTAL_SWEEP
+#define MICROPY_GC_INCREMENTAL_SWEEP (0)
+#endif
+
+// Allocations of at least this many blocks are placed at the highest free
+// run of the heap rather than the lowest, keeping large buffers apart from
+// the churn of small objects to limit fragmentation.  Set to 0 to disable.
+#ifndef MICROPY_GC_LARGE_ALLOC_BLOCKS
+#define MICROPY_GC_LARGE_ALLOC_BLOCKS (0)
+#endif
+
+// Instrument the GC to record the allocations made at each bytecode location
+// and the time spent marking and sweeping, readable with gc.profile().
+// Requires mp_hal_ticks_us().
+#ifndef MICROPY_GC_PROFILE
+#define MICROPY_GC_PROFILE (0)
+#endif
+
+// Number of distinct allocation sites recorded by MICROPY_GC_PROFILE, must be
+// a power of 2.
+#ifndef MICROPY_GC_PROFILE_SITES
+#define MICROPY_GC_PROFILE_SITES (64)
+#endif
+
 // Support automatic GC when reaching allocation threshold,
 // configurable by gc.threshold().
 #ifndef MICROPY_GC_ALLOC_THRESHOLD
@@ -252,6 +304,13 @@
 #define MICROPY_QSTR_BYTES_IN_HASH (2)
 #endif
 
+// Whether to look up qstrs using hash tables instead of scanning the pools.
+// The table for the static pool is generated at build time and placed in ROM;
+// the table for the other pools is kept on the heap.
+#ifndef MICROPY_QSTR_HASH_INDEX
+#define MICROPY_QSTR_HASH_INDEX (0)
+#endif
+
 // Avoid using C stack when making Python function calls. C stack still
 // may be used if there's no free heap.
 #ifndef MICROPY_STACKLESS
@@ -283,6 +342,13 @@
 #define MICROPY_PERSISTENT_CODE_LOAD (0)
 #endif
 
+// Whether functions in a .mpy file loaded from the filesystem have their
+// bytecode loaded when they are first called, rather than at import.  Requires
+// the port's file reader to provide mp_reader_new_file_at.
+#ifndef MICROPY_PERSISTENT_CODE_LOAD_LAZY
+#define MICROPY_PERSISTENT_CODE_LOAD_LAZY (0)
+#endif
+
 // Whether to support saving of persistent code
 #ifndef MICROPY_PERSISTENT_CODE_SAVE
 #define MICROPY_PERSISTENT_CODE_SAVE (0)
@@ -411,6 +477,25 @@
 #define MICROPY_COMP_CONST_LITERAL (1)
 #endif
 
+// Whether constant folding also handles str and bytes concatenation, and
+// whether str and bytes values are allowed in id = const(value)
+#ifndef MICROPY_COMP_CONST_STR
+#define MICROPY_COMP_CONST_STR (0)
+#endif
+
+// Whether constant folding also handles floats; eg 2 * 3.5 rewritten as 7.0
+// Can't be used with MICROPY_DYNAMIC_COMPILER because the float format of the
+// target is not known
+#ifndef MICROPY_COMP_CONST_FLOAT
+#define MICROPY_COMP_CONST_FLOAT (0)
+#endif
+
+// Whether to load a tuple of constants as a single constant tuple object
+// Can't be used when saving .mpy files because they can't store tuples
+#ifndef MICROPY_COMP_CONST_TUPLE
+#define MICROPY_COMP_CONST_TUPLE (0)
+#endif
+
 // Whether to enable lookup of constants in modules; eg module.CONST
 #ifndef MICROPY_COMP_MODULE_CONST
 #define MICROPY_COMP_MODULE_CONST (0)
@@ -439,6 +524,24 @@
 #define MICROPY_COMP_RETURN_IF_EXPR (0)
 #endif
 
+// Whether the bytecode emitter drops unreachable code (after a return, raise
+// or unconditional jump) and makes jumps to a jump go directly to its target
+#ifndef MICROPY_COMP_BC_PEEPHOLE
+#define MICROPY_COMP_BC_PEEPHOLE (0)
+#endif
+
+// Whether imported and exec'd code is compiled in batches of top-level
+// statements while it is parsed, so that only the parse tree of one batch is
+// held in memory at a time, instead of that of the whole module
+#ifndef MICROPY_COMP_STREAMING
+#define MICROPY_COMP_STREAMING (0)
+#endif
+
+// Parse node memory, in bytes, above which a batch of statements is compiled
+#ifndef MICROPY_COMP_STREAMING_BATCH
+#define MICROPY_COMP_STREAMING_BATCH (1024)
+#endif
+
 /*****************************************************************************/
 /* Internal debugging stuff                                                  */
 
@@ -490,6 +593,22 @@
 #define MICROPY_OPT_COMPUTED_GOTO (0)
 #endif
 
+// Whether to store the computed goto table as 16-bit offsets instead of
+// pointers, which saves 512 bytes of ROM on 32-bit targets and suits cores
+// such as Cortex-M0+ where flash is tight.  Requires the code of the VM
+// dispatch loop to be smaller than 32KiB.
+#ifndef MICROPY_OPT_COMPUTED_GOTO_SAVE_SPACE
+#define MICROPY_OPT_COMPUTED_GOTO_SAVE_SPACE (0)
+#endif
+
+// Whether the VM fuses common pairs of opcodes at runtime by looking at the
+// next opcode: a comparison of two small ints followed by a conditional jump
+// is executed without creating a bool, and small int add/subtract skip the
+// call to mp_binary_op.  The bytecode format is unchanged.
+#ifndef MICROPY_OPT_VM_SUPERINSTRUCTIONS
+#define MICROPY_OPT_VM_SUPERINSTRUCTIONS (0)
+#endif
+
 // Whether to cache result of map lookups in LOAD_NAME, LOAD_GLOBAL, LOAD_ATTR,
 // STORE_ATTR bytecodes.  Uses 1 byte extra RAM for each of these opcodes and
 // uses a bit of extra code ROM, but greatly improves lookup speed.
@@ -497,12 +616,66 @@
 #define MICROPY_OPT_CACHE_MAP_LOOKUP_IN_BYTECODE (0)
 #endif
 
+// Whether to keep a global cache of the position of qstr keys found in ordered
+// maps, which include the fixed ROM tables of builtin modules and types, so
+// that repeated lookups (eg method calls) don't need a linear search.  Uses
+// MICROPY_OPT_MAP_LOOKUP_CACHE_SIZE bytes of RAM.
+#ifndef MICROPY_OPT_MAP_LOOKUP_CACHE
+#define MICROPY_OPT_MAP_LOOKUP_CACHE (0)
+#endif
+
+// Number of entries in the map lookup cache, must be a power of 2.
+#ifndef MICROPY_OPT_MAP_LOOKUP_CACHE_SIZE
+#define MICROPY_OPT_MAP_LOOKUP_CACHE_SIZE (128)
+#endif
+
+// Whether to cache the result of looking up attributes of instances in their
+// class hierarchy, keyed by (type, attr), so that repeated method calls and
+// class attribute loads skip the walk over the bases.  The cache is
+// invalidated whenever a class is created or has an attribute stored or
+// deleted.  Uses MICROPY_OPT_TYPE_ATTR_CACHE_SIZE entries of 5 words each
+// per thread.
+#ifndef MICROPY_OPT_TYPE_ATTR_CACHE
+#define MICROPY_OPT_TYPE_ATTR_CACHE (0)
+#endif
+
+// Number of entries in the type attribute cache, must be a power of 2.
+#ifndef MICROPY_OPT_TYPE_ATTR_CACHE_SIZE
+#define MICROPY_OPT_TYPE_ATTR_CACHE_SIZE (64)
+#endif
+
+// Whether hash maps (dicts, instance members, module globals) store their
+// entries densely in insertion order with a separate small hash index of 8,
+// 16 or 32-bit slots, instead of as a sparse open-addressed table.  Lookups
+// then need no division, ordered dicts are hashed rather than searched, and
+// iteration follows insertion order.  Fixed (ROM) maps are unaffected.
+#ifndef MICROPY_MAP_COMPACT
+#define MICROPY_MAP_COMPACT (0)
+#endif
+
 // Whether to use fast versions of bitwise operations (and, or, xor) when the
 // arguments are both positive.  Increases Thumb2 code size by about 250 bytes.
 #ifndef MICROPY_OPT_MPZ_BITWISE
 #define MICROPY_OPT_MPZ_BITWISE (0)
 #endif
 
+// Whether large mpz multiplications use Karatsuba's method and squarings use
+// a dedicated routine, and whether int(str) of long strings is converted by
+// divide-and-conquer.  The threshold is the length, in mpz digits, of the
+// shorter operand at and above which Karatsuba is used (must be at least 4).
+#ifndef MICROPY_OPT_MPZ_KARATSUBA
+#define MICROPY_OPT_MPZ_KARATSUBA (0)
+#endif
+#ifndef MICROPY_OPT_MPZ_KARATSUBA_THRESHOLD
+#define MICROPY_OPT_MPZ_KARATSUBA_THRESHOLD (32)
+#endif
+
+// Whether pow(a, e, m) with an odd modulus uses Montgomery multiplication and
+// a sliding window over the exponent, with no memory allocation per step.
+#ifndef MICROPY_OPT_MPZ_POW3_MONTGOMERY
+#define MICROPY_OPT_MPZ_POW3_MONTGOMERY (0)
+#endif
+
 
 // Whether math.factorial is large, fast and recursive (1) or small and slow (0).
 #ifndef MICROPY_OPT_MATH_FACTORIAL
@@ -841,6 +1014,12 @@ typedef double mp_float_t;
 #define MICROPY_VFS_FAT (0)
 #endif
 
+// Support for the readview() method on files of block-device filesystems, which
+// gives zero-copy access to file data stored on memory-mapped block devices
+#ifndef MICROPY_VFS_READVIEW
+#define MICROPY_VFS_READVIEW (0)
+#endif
+
 /*****************************************************************************/
 /* Fine control over Python builtins, classes, modules, etc                  */
 
@@ -1435,6 +1614,11 @@ typedef double mp_float_t;
 #define MICROPY_PY_UBINASCII (0)
 #endif
 
+// Whether to provide the "ubuf" module of bulk buffer operations
+#ifndef MICROPY_PY_UBUF
+#define MICROPY_PY_UBUF (0)
+#endif
+
 // Depends on MICROPY_PY_UZLIB
 #ifndef MICROPY_PY_UBINASCII_CRC32
 #define MICROPY_PY_UBINASCII_CRC32 (0)
@@ -1462,6 +1646,11 @@ typedef double mp_float_t;
 #define MICROPY_PY_MACHINE_I2C (0)
 #endif
 
+// Whether to provide I2C.readfrom_mem_batch() to run a list of memory reads in one call
+#ifndef MICROPY_PY_MACHINE_I2C_MEM_BATCH
+#define MICROPY_PY_MACHINE_I2C_MEM_BATCH (0)
+#endif
+
 #ifndef MICROPY_PY_MACHINE_SPI
 #define MICROPY_PY_MACHINE_SPI (0)
 #endif
@@ -1717,5 +1906,16 @@ typedef double mp_float_t;
 #error "MICROPY_PY_SYS_SETTRACE requires MICROPY_COMP_CONST to be disabled"
 #endif
 #endif
+#if MICROPY_DYNAMIC_COMPILER && (MICROPY_COMP_CONST_FLOAT || MICROPY_COMP_CONST_TUPLE)
+#error "MICROPY_COMP_CONST_FLOAT and MICROPY_COMP_CONST_TUPLE require MICROPY_DYNAMIC_COMPILER to be disabled"
+#endif
+#if MICROPY_COMP_STREAMING && MICROPY_ENABLE_DOC_STRING
+// a batch of statements starting with a string would set the module's __doc__
+#error "MICROPY_COMP_STREAMING requires MICROPY_ENABLE_DOC_STRING to be disabled"
+#endif
+#if MICROPY_COMP_STREAMING && MICROPY_PY_SYS_SETTRACE
+// each batch of statements would be traced as a separate call of <module>
+#error "MICROPY_COMP_STREAMING requires MICROPY_PY_SYS_SETTRACE to be disabled"
+#endif
 
 #endif // MICROPY_INCLUDED_PY_MPCONFIG_H
@@ -48,6 +48,9 @@ typedef struct mp_dynamic_compiler_t {
     bool py_builtins_str_unicode;
     uint8_t native_arch;
     uint8_t nlr_buf_num_regs;
+    bool native_fallback; // compile to bytecode any native function the emitter rejects
+    size_t native_profile_len;
+    const size_t *native_profile_lines; // if non-NULL, the lines of the only functions to compile natively
 } mp_dynamic_compiler_t;
 extern mp_dynamic_compiler_t mp_dynamic_compiler;
 #endif
@@ -62,12 +65,10 @@ typedef struct _mp_sched_item_t {
     mp_obj_t arg;
 } mp_sched_item_t;
 
-// This structure hold information about the memory allocation system.
-typedef struct _mp_state_mem_t {
-    #if MICROPY_MEM_STATS
-    size_t total_bytes_allocated;
-    size_t current_bytes_allocated;
-    size_t peak_bytes_allocated;
+// This structure holds the layout of one contiguous area of the GC heap.
+typedef struct _mp_state_mem_area_t {
+    #if MICROPY_GC_SPLIT_HEAP
+    struct _mp_state_mem_area_t *next;
     #endif
 
     byte *gc_alloc_table_start;
@@ -78,8 +79,57 @@ typedef struct _mp_state_mem_t {
     byte *gc_pool_start;
     byte *gc_pool_end;
 
+    size_t gc_last_free_atb_index;
+
+    #if MICROPY_GC_SIZE_CLASSES
+    // Stacks of the starting blocks of free runs, one stack per size class.
+    // Entry i of class c is a run of at least c + 1 free blocks when it was
+    // recorded; entries are checked before use so may go stale.
+    uint16_t gc_free_run_len[MICROPY_GC_SIZE_CLASSES];
+    size_t gc_free_run[MICROPY_GC_SIZE_CLASSES][MICROPY_GC_SIZE_CLASS_DEPTH];
+    #endif
+
+    #if MICROPY_GC_NURSERY
+    // Small allocations are taken in turn from the blocks in this range.
+    size_t gc_nursery_block;
+    size_t gc_nursery_end;
+    #endif
+
+    #if MICROPY_GC_INCREMENTAL_SWEEP
+    // Blocks from here to the end of the area have not been swept yet.
+    size_t gc_sweep_block;
+    #endif
+} mp_state_mem_area_t;
+
+#if MICROPY_GC_PROFILE
+// Allocations made at one bytecode location, as recorded by the GC profiler.
+typedef struct _mp_state_mem_site_t {
+    const byte *ip; // NULL for allocations made outside of bytecode
+    qstr source_file;
+    qstr block_name;
+    size_t line;
+    size_t count; // 0 if the entry is unused
+    size_t bytes;
+} mp_state_mem_site_t;
+#endif
+
+// This structure hold information about the memory allocation system.
+typedef struct _mp_state_mem_t {
+    #if MICROPY_MEM_STATS
+    size_t total_bytes_allocated;
+    size_t current_bytes_allocated;
+    size_t peak_bytes_allocated;
+    #endif
+
+    // The first (and, without MICROPY_GC_SPLIT_HEAP, only) area of the heap.
+    mp_state_mem_area_t area;
+
     int gc_stack_overflow;
     MICROPY_GC_STACK_ENTRY_TYPE gc_stack[MICROPY_ALLOC_GC_STACK_SIZE];
+    #if MICROPY_GC_SPLIT_HEAP
+    // Area of each block on gc_stack.
+    mp_state_mem_area_t *gc_area_stack[MICROPY_ALLOC_GC_STACK_SIZE];
+    #endif
 
     // This variable controls auto garbage collection.  If set to 0 then the
     // GC won't automatically run when gc_alloc can't find enough blocks.  But
@@ -91,18 +141,44 @@ typedef struct _mp_state_mem_t {
     size_t gc_alloc_threshold;
     #endif
 
-    size_t gc_last_free_atb_index;
-
     #if MICROPY_PY_GC_COLLECT_RETVAL
     size_t gc_collected;
     #endif
 
+    #if MICROPY_GC_INCREMENTAL_SWEEP
+    // Maximum time for each slice of a deferred sweep, 0 to sweep in one go.
+    mp_uint_t gc_sweep_budget_us;
+    uint8_t gc_sweep_pending;
+    uint8_t gc_sweep_deferred;
+    #endif
+
+    #if MICROPY_GC_PROFILE
+    mp_uint_t gc_prof_start_us;
+    size_t gc_prof_collections;
+    // Total and longest time spent in the mark (index 0) and sweep (index 1) phases.
+    mp_uint_t gc_prof_pause_us[2];
+    mp_uint_t gc_prof_pause_max_us[2];
+    size_t gc_prof_sites_dropped;
+    mp_state_mem_site_t gc_prof_sites[MICROPY_GC_PROFILE_SITES];
+    #endif
+
     #if MICROPY_PY_THREAD && !MICROPY_PY_THREAD_GIL
     // This is a global mutex used to make the GC thread-safe.
     mp_thread_mutex_t gc_mutex;
     #endif
 } mp_state_mem_t;
 
+#if MICROPY_OPT_TYPE_ATTR_CACHE
+// The result of looking up attr in the class hierarchy of instances of type.
+typedef struct _mp_type_attr_cache_entry_t {
+    size_t version; // entry is valid if equal to MP_STATE_VM(type_attr_cache_version)
+    const struct _mp_obj_type_t *type;
+    qstr attr;
+    mp_obj_t member;
+    uintptr_t bind; // dest[1] is: 0 for MP_OBJ_NULL, 1 for the instance, 2 for type
+} mp_type_attr_cache_entry_t;
+#endif
+
 // This structure hold runtime and VM information.  It includes a section
 // which contains root pointers that must be scanned by the GC.
 typedef struct _mp_state_vm_t {
@@ -115,6 +191,11 @@ typedef struct _mp_state_vm_t {
 
     qstr_pool_t *last_pool;
 
+    #if MICROPY_QSTR_HASH_INDEX
+    // hash table of the qstrs that are not in the static pool
+    struct _qstr_index_t *qstr_index;
+    #endif
+
     // non-heap memory for creating an exception if we can't allocate RAM
     mp_obj_exception_t mp_emergency_exception_obj;
 
@@ -210,6 +291,22 @@ typedef struct _mp_state_vm_t {
     size_t qstr_last_alloc;
     size_t qstr_last_used;
 
+    #if MICROPY_QSTR_HASH_INDEX
+    size_t qstr_index_used;
+    #endif
+
+    #if MICROPY_OPT_MAP_LOOKUP_CACHE
+    // Likely positions of recently found keys in ordered maps; entries are
+    // only hints and are checked before use, so need no initialisation.
+    uint8_t map_lookup_cache[MICROPY_OPT_MAP_LOOKUP_CACHE_SIZE];
+    #endif
+
+    #if MICROPY_OPT_TYPE_ATTR_CACHE
+    // Incremented whenever the result of a lookup in a class may change,
+    // which invalidates all entries of the per-thread type attribute caches.
+    size_t type_attr_cache_version;
+    #endif
+
     #if MICROPY_PY_THREAD && !MICROPY_PY_THREAD_GIL
     // This is a global mutex used to make qstr interning thread-safe.
     mp_thread_mutex_t qstr_mutex;
@@ -272,8 +369,17 @@ typedef struct _mp_state_thread_t {
     #if MICROPY_PY_SYS_SETTRACE
     mp_obj_t prof_trace_callback;
     bool prof_callback_is_executing;
+    #endif
+    #if MICROPY_PY_SYS_SETTRACE || MICROPY_GC_PROFILE
     struct _mp_code_state_t *current_code_state;
     #endif
+
+    #if MICROPY_OPT_TYPE_ATTR_CACHE
+    // Results of recent attribute lookups in the classes of instances.  An
+    // entry may outlive the class dict entry it was filled from, so the
+    // types and members referenced here are root pointers.
+    mp_type_attr_cache_entry_t type_attr_cache[MICROPY_OPT_TYPE_ATTR_CACHE_SIZE];
+    #endif
 } mp_state_thread_t;
 
 // This structure combines the above 3 structures.
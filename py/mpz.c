@@ -457,6 +457,241 @@ STATIC size_t mpn_mul(mpz_dig_t *idig, mpz_dig_t *jdig, size_t jlen, mpz_dig_t *
     return ilen;
 }
 
+#if MICROPY_OPT_MPZ_KARATSUBA
+
+#if MICROPY_OPT_MPZ_KARATSUBA_THRESHOLD < 4
+#error MICROPY_OPT_MPZ_KARATSUBA_THRESHOLD must be at least 4
+#endif
+
+/* computes i = j * j
+   returns number of digits in i
+   assumes enough memory in i; assumes i is zeroed; assumes normalised j
+   each cross product j[a] * j[b] is computed once and then doubled
+*/
+STATIC size_t mpn_sqr(mpz_dig_t *idig, const mpz_dig_t *jdig, size_t jlen) {
+    // sum of cross products j[a] * j[b] with a < b
+    for (size_t a = 0; a < jlen; ++a) {
+        mpz_dig_t *id = idig + 2 * a + 1;
+        mpz_dbl_dig_t carry = 0;
+        for (size_t b = a + 1; b < jlen; ++b, ++id) {
+            carry += (mpz_dbl_dig_t)*id + (mpz_dbl_dig_t)jdig[a] * (mpz_dbl_dig_t)jdig[b];
+            *id = carry & DIG_MASK;
+            carry >>= DIG_SIZE;
+        }
+        *id = carry;
+    }
+
+    // double it and add the squares j[a] * j[a]
+    mpz_dig_t top = 0;
+    for (size_t a = 0; a < 2 * jlen; ++a) {
+        mpz_dig_t d = idig[a];
+        idig[a] = ((d << 1) | top) & DIG_MASK;
+        top = d >> (DIG_SIZE - 1);
+    }
+    mpz_dbl_dig_t carry = 0;
+    for (size_t a = 0; a < jlen; ++a) {
+        carry += (mpz_dbl_dig_t)idig[2 * a] + (mpz_dbl_dig_t)jdig[a] * (mpz_dbl_dig_t)jdig[a];
+        idig[2 * a] = carry & DIG_MASK;
+        carry >>= DIG_SIZE;
+        carry += idig[2 * a + 1];
+        idig[2 * a + 1] = carry & DIG_MASK;
+        carry >>= DIG_SIZE;
+    }
+
+    return mpn_remove_trailing_zeros(idig, idig + 2 * jlen);
+}
+
+/* computes i = i + j, over all ilen digits of i
+   returns the carry out of the top of i
+   assumes ilen >= jlen; j need not be normalised
+*/
+STATIC mpz_dig_t mpn_add_n(mpz_dig_t *idig, size_t ilen, const mpz_dig_t *jdig, size_t jlen) {
+    mpz_dbl_dig_t carry = 0;
+
+    ilen -= jlen;
+
+    for (; jlen > 0; --jlen, ++idig, ++jdig) {
+        carry += (mpz_dbl_dig_t)*idig + (mpz_dbl_dig_t)*jdig;
+        *idig = carry & DIG_MASK;
+        carry >>= DIG_SIZE;
+    }
+
+    for (; ilen > 0 && carry != 0; --ilen, ++idig) {
+        carry += *idig;
+        *idig = carry & DIG_MASK;
+        carry >>= DIG_SIZE;
+    }
+
+    return carry;
+}
+
+/* computes i = i - j, over all ilen digits of i
+   assumes ilen >= jlen and i >= j; j need not be normalised
+*/
+STATIC void mpn_sub_n(mpz_dig_t *idig, size_t ilen, const mpz_dig_t *jdig, size_t jlen) {
+    mpz_dbl_dig_signed_t borrow = 0;
+
+    ilen -= jlen;
+
+    for (; jlen > 0; --jlen, ++idig, ++jdig) {
+        borrow += (mpz_dbl_dig_t)*idig - (mpz_dbl_dig_t)*jdig;
+        *idig = borrow & DIG_MASK;
+        borrow >>= DIG_SIZE;
+    }
+
+    for (; ilen > 0 && borrow != 0; --ilen, ++idig) {
+        borrow += *idig;
+        *idig = borrow & DIG_MASK;
+        borrow >>= DIG_SIZE;
+    }
+}
+
+// returns the number of digits of scratch memory needed by mpn_mul_karatsuba
+// when the longer operand has jlen digits
+STATIC size_t mpn_mul_karatsuba_scratch(size_t jlen) {
+    size_t n = 0;
+    while (jlen >= MICROPY_OPT_MPZ_KARATSUBA_THRESHOLD) {
+        jlen = (jlen + 1) / 2 + 1;
+        n += 4 * jlen;
+    }
+    return n;
+}
+
+/* computes i = j * k using Karatsuba's method
+   assumes i has jlen + klen digits and is zeroed; assumes jlen >= klen
+   j, k need not be normalised; if j, k point to same memory the squaring is done
+   t is scratch memory of mpn_mul_karatsuba_scratch(jlen) digits
+*/
+STATIC void mpn_mul_karatsuba(mpz_dig_t *idig, mpz_dig_t *jdig, size_t jlen, mpz_dig_t *kdig, size_t klen, mpz_dig_t *t) {
+    bool sqr = jdig == kdig && jlen == klen;
+
+    if (klen < MICROPY_OPT_MPZ_KARATSUBA_THRESHOLD) {
+        if (sqr) {
+            mpn_sqr(idig, jdig, jlen);
+        } else {
+            mpn_mul(idig, jdig, jlen, kdig, klen);
+        }
+        return;
+    }
+
+    size_t m = (jlen + 1) / 2;
+
+    if (klen <= m) {
+        // unbalanced: multiply k by successive klen-digit pieces of j
+        mpz_dig_t *p = t;
+        t += 2 * klen;
+        for (size_t off = 0; off < jlen; off += klen) {
+            size_t n = MIN(klen, jlen - off);
+            memset(p, 0, (n + klen) * sizeof(mpz_dig_t));
+            if (n == klen) {
+                mpn_mul_karatsuba(p, jdig + off, n, kdig, klen, t);
+            } else {
+                mpn_mul_karatsuba(p, kdig, klen, jdig + off, n, t);
+            }
+            mpn_add_n(idig + off, jlen + klen - off, p, n + klen);
+        }
+        return;
+    }
+
+    // j = j1 * B^m + j0 and k = k1 * B^m + k0, where j1 and k1 have h0 >= h1 digits
+    size_t h0 = jlen - m;
+    size_t h1 = klen - m;
+
+    // z0 = j0 * k0 and z2 = j1 * k1 go in the low and high parts of i
+    mpn_mul_karatsuba(idig, jdig, m, kdig, m, t);
+    mpn_mul_karatsuba(idig + 2 * m, jdig + m, h0, kdig + m, h1, t);
+
+    // z1 = (j0 + j1) * (k0 + k1) - z0 - z2
+    mpz_dig_t *sj = t;
+    mpz_dig_t *sk = t + m + 1;
+    mpz_dig_t *z1 = t + 2 * (m + 1);
+    t += 4 * (m + 1);
+    memcpy(sj, jdig, m * sizeof(mpz_dig_t));
+    sj[m] = 0;
+    mpn_add_n(sj, m + 1, jdig + m, h0);
+    if (sqr) {
+        sk = sj;
+    } else {
+        memcpy(sk, kdig, m * sizeof(mpz_dig_t));
+        sk[m] = 0;
+        mpn_add_n(sk, m + 1, kdig + m, h1);
+    }
+    memset(z1, 0, 2 * (m + 1) * sizeof(mpz_dig_t));
+    mpn_mul_karatsuba(z1, sj, m + 1, sk, m + 1, t);
+    mpn_sub_n(z1, 2 * (m + 1), idig, 2 * m);
+    mpn_sub_n(z1, 2 * (m + 1), idig + 2 * m, h0 + h1);
+
+    // i += z1 * B^m; z1 < 2 * B^(m + h0) so it fits in the digits of i above m
+    mpn_add_n(idig + m, m + h0 + h1, z1, MIN(2 * (m + 1), m + h0 + h1));
+}
+
+#endif
+
+#if MICROPY_OPT_MPZ_POW3_MONTGOMERY
+
+/* computes i = j * k / B^n mod m, where B is the digit base (Montgomery multiplication)
+   assumes j, k < m and m odd, all with n digits (j, k need not be normalised)
+   minv = -1/m mod B; t is scratch memory of 2n + 1 digits; kt is scratch memory for
+   mpn_mul_karatsuba if that is used
+   can have i, j, k point to same memory
+*/
+STATIC void mpn_montgomery_mul(mpz_dig_t *idig, mpz_dig_t *jdig, mpz_dig_t *kdig, const mpz_dig_t *mdig, size_t n, mpz_dig_t minv, mpz_dig_t *t, mpz_dig_t *kt) {
+    // t = j * k
+    memset(t, 0, (2 * n + 1) * sizeof(mpz_dig_t));
+    #if MICROPY_OPT_MPZ_KARATSUBA
+    if (n >= MICROPY_OPT_MPZ_KARATSUBA_THRESHOLD) {
+        mpn_mul_karatsuba(t, jdig, n, kdig, n, kt);
+    } else if (jdig == kdig) {
+        mpn_sqr(t, jdig, n);
+    } else
+    #else
+    (void)kt;
+    #endif
+    {
+        mpn_mul(t, jdig, n, kdig, n);
+    }
+
+    // add multiples of m to t to clear its low n digits, then t = t / B^n
+    for (size_t a = 0; a < n; ++a) {
+        mpz_dbl_dig_t q = ((mpz_dbl_dig_t)t[a] * (mpz_dbl_dig_t)minv) & DIG_MASK;
+        mpz_dig_t *td = t + a;
+        mpz_dbl_dig_t carry = 0;
+        for (size_t b = 0; b < n; ++b, ++td) {
+            carry += (mpz_dbl_dig_t)*td + q * (mpz_dbl_dig_t)mdig[b]; // will never overflow so long as DIG_SIZE <= 8*sizeof(mpz_dbl_dig_t)/2
+            *td = carry & DIG_MASK;
+            carry >>= DIG_SIZE;
+        }
+        for (; carry != 0; ++td) {
+            carry += *td;
+            *td = carry & DIG_MASK;
+            carry >>= DIG_SIZE;
+        }
+    }
+    t += n;
+
+    // t < 2m, so subtracting m once (if t >= m) is enough
+    bool ge = t[n] != 0;
+    if (!ge) {
+        size_t a = n;
+        while (a > 0 && t[a - 1] == mdig[a - 1]) {
+            --a;
+        }
+        ge = a == 0 || t[a - 1] > mdig[a - 1];
+    }
+    if (ge) {
+        mpz_dbl_dig_signed_t borrow = 0;
+        for (size_t a = 0; a < n; ++a) {
+            borrow += (mpz_dbl_dig_t)t[a] - (mpz_dbl_dig_t)mdig[a];
+            t[a] = borrow & DIG_MASK;
+            borrow >>= DIG_SIZE;
+        }
+    }
+
+    memcpy(idig, t, n * sizeof(mpz_dig_t));
+}
+
+#endif
+
 /* natural_div - quo * den + new_num = old_num (ie num is replaced with rem)
    assumes den != 0
    assumes num_dig has enough memory to be extended by 1 digit
@@ -812,12 +1047,117 @@ void mpz_set_from_float(mpz_t *z, mp_float_t src) {
 }
 #endif
 
+// returns the value of the digit character c, or 36 if it isn't a digit
+STATIC mp_uint_t mpz_digit_value(mp_uint_t c) {
+    if ('0' <= c && c <= '9') {
+        return c - '0';
+    } else if ('A' <= c && c <= 'Z') {
+        return c - ('A' - 10);
+    } else if ('a' <= c && c <= 'z') {
+        return c - ('a' - 10);
+    } else {
+        return 36;
+    }
+}
+
+// computes z = z * base^n + (the n digits in str), with as many digits as
+// fit in one mpz digit taken per pass over z
+// returns number of bytes from str that were processed, stopping at the first non-digit
+STATIC size_t mpz_add_digits(mpz_t *z, const char *str, size_t len, unsigned int base) {
+    const char *cur = str;
+    const char *top = str + len;
+    mpz_dig_t chunk = 0;
+    mpz_dig_t chunk_base = 1;
+
+    for (; cur < top; ++cur) { // XXX UTF8 next char
+        mp_uint_t v = mpz_digit_value(*cur); // XXX UTF8 get char
+        if (v >= base) {
+            break;
+        }
+        chunk = chunk * base + v;
+        chunk_base *= base;
+        if (chunk_base > DIG_MASK / base) {
+            z->len = mpn_mul_dig_add_dig(z->dig, z->len, chunk_base, chunk);
+            chunk = 0;
+            chunk_base = 1;
+        }
+    }
+    if (chunk_base > 1) {
+        z->len = mpn_mul_dig_add_dig(z->dig, z->len, chunk_base, chunk);
+    }
+
+    return cur - str;
+}
+
+#if MICROPY_OPT_MPZ_KARATSUBA
+
+// sets z to the value of the len digits in str, which must all be valid
+// strings longer than the chunk of level 0 are split so that their low part has
+// the length of chunk level k (pows[k] = base ** that length) and the parts are
+// converted separately and joined with a (Karatsuba) multiplication
+STATIC void mpz_set_from_digits_dc(mpz_t *z, const char *str, size_t len, unsigned int base, const mpz_t *pows, size_t chunk_len, size_t k) {
+    while (k > 0 && (chunk_len << k) >= len) {
+        --k;
+    }
+    if ((chunk_len << k) >= len) {
+        mpz_need_dig(z, len * 8 / DIG_SIZE + 1);
+        z->neg = 0;
+        z->len = 0;
+        mpz_add_digits(z, str, len, base);
+        return;
+    }
+
+    size_t lo_len = chunk_len << k;
+    mpz_t lo;
+    mpz_init_zero(&lo);
+    mpz_set_from_digits_dc(z, str, len - lo_len, base, pows, chunk_len, k);
+    mpz_set_from_digits_dc(&lo, str + len - lo_len, lo_len, base, pows, chunk_len, k);
+    mpz_mul_inpl(z, z, &pows[k]);
+    mpz_add_inpl(z, z, &lo);
+    mpz_deinit(&lo);
+}
+
+#endif
+
 // returns number of bytes from str that were processed
 size_t mpz_set_from_str(mpz_t *z, const char *str, size_t len, bool neg, unsigned int base) {
     assert(base <= 36);
 
-    const char *cur = str;
-    const char *top = str + len;
+    #if MICROPY_OPT_MPZ_KARATSUBA
+    // the divide-and-conquer split happens at multiples of this many characters,
+    // and pays off once the parts are long enough to use Karatsuba
+    size_t chunk_len = 8 * MICROPY_OPT_MPZ_KARATSUBA_THRESHOLD * DIG_SIZE / 6;
+    if (len > 2 * chunk_len) {
+        size_t n = 0;
+        while (n < len && mpz_digit_value(str[n]) < base) {
+            ++n;
+        }
+        if (n > 2 * chunk_len) {
+            // pows[k] = base ** (chunk_len << k), for each level of the split
+            size_t levels = 1;
+            while ((chunk_len << levels) < n) {
+                ++levels;
+            }
+            mpz_t *pows = m_new(mpz_t, levels);
+            mpz_init_from_int(&pows[0], base);
+            mpz_t e;
+            mpz_init_from_int(&e, chunk_len);
+            mpz_pow_inpl(&pows[0], &pows[0], &e);
+            mpz_deinit(&e);
+            for (size_t k = 1; k < levels; ++k) {
+                mpz_init_zero(&pows[k]);
+                mpz_mul_inpl(&pows[k], &pows[k - 1], &pows[k - 1]);
+            }
+            mpz_set_from_digits_dc(z, str, n, base, pows, chunk_len, levels - 1);
+            for (size_t k = 0; k < levels; ++k) {
+                mpz_deinit(&pows[k]);
+            }
+            m_del(mpz_t, pows, levels);
+            z->neg = neg && z->len != 0;
+            return n;
+        }
+    }
+    #endif
 
     mpz_need_dig(z, len * 8 / DIG_SIZE + 1);
 
@@ -828,25 +1168,7 @@ size_t mpz_set_from_str(mpz_t *z, const char *str, size_t len, bool neg, unsigne
     }
 
     z->len = 0;
-    for (; cur < top; ++cur) { // XXX UTF8 next char
-        // mp_uint_t v = char_to_numeric(cur#); // XXX UTF8 get char
-        mp_uint_t v = *cur;
-        if ('0' <= v && v <= '9') {
-            v -= '0';
-        } else if ('A' <= v && v <= 'Z') {
-            v -= 'A' - 10;
-        } else if ('a' <= v && v <= 'z') {
-            v -= 'a' - 10;
-        } else {
-            break;
-        }
-        if (v >= base) {
-            break;
-        }
-        z->len = mpn_mul_dig_add_dig(z->dig, z->len, base, v);
-    }
-
-    return cur - str;
+    return mpz_add_digits(z, str, len, base);
 }
 
 void mpz_set_from_bytes(mpz_t *z, bool big_endian, size_t len, const byte *buf) {
@@ -1306,7 +1628,25 @@ void mpz_mul_inpl(mpz_t *dest, const mpz_t *lhs, const mpz_t *rhs) {
 
     mpz_need_dig(dest, lhs->len + rhs->len); // min mem l+r-1, max mem l+r
     memset(dest->dig, 0, dest->alloc * sizeof(mpz_dig_t));
-    dest->len = mpn_mul(dest->dig, lhs->dig, lhs->len, rhs->dig, rhs->len);
+    #if MICROPY_OPT_MPZ_KARATSUBA
+    if (lhs->len < rhs->len) {
+        const mpz_t *t = lhs;
+        lhs = rhs;
+        rhs = t;
+    }
+    if (rhs->len >= MICROPY_OPT_MPZ_KARATSUBA_THRESHOLD) {
+        size_t tlen = mpn_mul_karatsuba_scratch(lhs->len);
+        mpz_dig_t *t = m_new(mpz_dig_t, tlen);
+        mpn_mul_karatsuba(dest->dig, lhs->dig, lhs->len, rhs->dig, rhs->len, t);
+        m_del(mpz_dig_t, t, tlen);
+        dest->len = mpn_remove_trailing_zeros(dest->dig, dest->dig + lhs->len + rhs->len);
+    } else if (lhs == rhs) {
+        dest->len = mpn_sqr(dest->dig, lhs->dig, lhs->len);
+    } else
+    #endif
+    {
+        dest->len = mpn_mul(dest->dig, lhs->dig, lhs->len, rhs->dig, rhs->len);
+    }
 
     if (lhs->neg == rhs->neg) {
         dest->neg = 0;
@@ -1351,6 +1691,113 @@ void mpz_pow_inpl(mpz_t *dest, const mpz_t *lhs, const mpz_t *rhs) {
     mpz_free(n);
 }
 
+#if MICROPY_OPT_MPZ_POW3_MONTGOMERY
+
+// returns bit number b of z (which must be less than the number of bits in z)
+static inline mpz_dig_t mpz_get_bit(const mpz_t *z, size_t b) {
+    return (z->dig[b / DIG_SIZE] >> (b % DIG_SIZE)) & 1;
+}
+
+/* computes dest = (lhs ** rhs) % mod, with Montgomery multiplication and a sliding
+   window over the bits of rhs; all memory is allocated before the exponentiation
+   assumes mod is odd and positive, and rhs is positive
+   can have dest, lhs, rhs the same; mod can't be the same as dest
+*/
+STATIC void mpz_pow3_montgomery(mpz_t *dest, const mpz_t *lhs, const mpz_t *rhs, const mpz_t *mod) {
+    size_t n = mod->len;
+    mpz_dig_t *mdig = mod->dig;
+
+    // minv = -1/m mod B, by Newton's iteration starting from 1/m = m mod 2^3
+    mpz_dbl_dig_t inv = mdig[0];
+    for (unsigned int bits = 3; bits < DIG_SIZE; bits *= 2) {
+        inv = (inv * (2 - mdig[0] * inv)) & DIG_MASK;
+    }
+    mpz_dig_t minv = (0 - inv) & DIG_MASK;
+
+    // number of bits in rhs, and width of the window, which needs a table of
+    // 2^(k-1) odd powers of lhs
+    size_t ebits = rhs->len * DIG_SIZE;
+    while (!mpz_get_bit(rhs, ebits - 1)) {
+        --ebits;
+    }
+    unsigned int k = ebits > 512 ? 5 : ebits > 128 ? 4 : ebits > 24 ? 3 : 1;
+    size_t ntab = 1 << (k - 1);
+
+    // table, accumulator, product and Karatsuba scratch memory
+    size_t ktlen = 0;
+    #if MICROPY_OPT_MPZ_KARATSUBA
+    ktlen = mpn_mul_karatsuba_scratch(n);
+    #endif
+    size_t slen = (ntab + 1) * n + (2 * n + 1) + ktlen;
+    mpz_dig_t *tab = m_new(mpz_dig_t, slen);
+    mpz_dig_t *acc = tab + ntab * n;
+    mpz_dig_t *t = acc + n;
+    mpz_dig_t *kt = t + 2 * n + 1;
+
+    // tab[0] = lhs * B^n mod m, the Montgomery form of lhs
+    mpz_t quo, rem;
+    mpz_init_zero(&quo);
+    mpz_init_zero(&rem);
+    mpz_divmod_inpl(&quo, &rem, lhs, mod);
+    mpz_shl_inpl(&rem, &rem, n * DIG_SIZE);
+    mpz_divmod_inpl(&quo, &rem, &rem, mod);
+    memset(tab, 0, n * sizeof(mpz_dig_t));
+    memcpy(tab, rem.dig, rem.len * sizeof(mpz_dig_t));
+    mpz_deinit(&quo);
+    mpz_deinit(&rem);
+
+    // tab[a] = lhs ** (2a + 1)
+    if (ntab > 1) {
+        mpn_montgomery_mul(acc, tab, tab, mdig, n, minv, t, kt);
+        for (size_t a = 1; a < ntab; ++a) {
+            mpn_montgomery_mul(tab + a * n, tab + (a - 1) * n, acc, mdig, n, minv, t, kt);
+        }
+    }
+
+    // scan the bits of rhs from the top, squaring for each bit and multiplying
+    // by a table entry for each window of up to k bits that starts and ends with 1
+    bool started = false;
+    for (size_t b = ebits; b > 0;) {
+        if (!mpz_get_bit(rhs, b - 1)) {
+            mpn_montgomery_mul(acc, acc, acc, mdig, n, minv, t, kt);
+            --b;
+            continue;
+        }
+        size_t l = b > k ? b - k : 0;
+        while (!mpz_get_bit(rhs, l)) {
+            ++l;
+        }
+        size_t w = 0;
+        for (size_t c = b; c > l; --c) {
+            w = (w << 1) | mpz_get_bit(rhs, c - 1);
+            if (started) {
+                mpn_montgomery_mul(acc, acc, acc, mdig, n, minv, t, kt);
+            }
+        }
+        if (started) {
+            mpn_montgomery_mul(acc, acc, tab + (w >> 1) * n, mdig, n, minv, t, kt);
+        } else {
+            memcpy(acc, tab + (w >> 1) * n, n * sizeof(mpz_dig_t));
+            started = true;
+        }
+        b = l;
+    }
+
+    // convert out of Montgomery form by multiplying by 1
+    memset(tab, 0, n * sizeof(mpz_dig_t));
+    tab[0] = 1;
+    mpn_montgomery_mul(acc, acc, tab, mdig, n, minv, t, kt);
+
+    mpz_need_dig(dest, n);
+    memcpy(dest->dig, acc, n * sizeof(mpz_dig_t));
+    dest->len = mpn_remove_trailing_zeros(dest->dig, dest->dig + n);
+    dest->neg = 0;
+
+    m_del(mpz_dig_t, tab, slen);
+}
+
+#endif
+
 /* computes dest = (lhs ** rhs) % mod
    can have dest, lhs, rhs the same; mod can't be the same as dest
 */
@@ -1366,6 +1813,13 @@ void mpz_pow3_inpl(mpz_t *dest, const mpz_t *lhs, const mpz_t *rhs, const mpz_t
         return;
     }
 
+    #if MICROPY_OPT_MPZ_POW3_MONTGOMERY
+    if (!mod->neg && (mod->dig[0] & 1) != 0) {
+        mpz_pow3_montgomery(dest, lhs, rhs, mod);
+        return;
+    }
+    #endif
+
     mpz_t *x = mpz_clone(lhs);
     mpz_t *n = mpz_clone(rhs);
     mpz_t quo;
@@ -1679,38 +2133,49 @@ size_t mpz_as_str_inpl(const mpz_t *i, unsigned int base, const char *prefix, ch
     mpz_dig_t *dig = m_new(mpz_dig_t, ilen);
     memcpy(dig, i->dig, ilen * sizeof(mpz_dig_t));
 
+    // each pass over the digits divides by the largest power of base that fits
+    // in one mpz digit, and gives that many characters
+    mpz_dig_t chunk_base = base;
+    unsigned int chunk_len = 1;
+    while (chunk_base <= DIG_MASK / base) {
+        chunk_base *= base;
+        ++chunk_len;
+    }
+
     // convert
     char *last_comma = str;
+    size_t len = ilen;
     bool done;
     do {
-        mpz_dig_t *d = dig + ilen;
+        mpz_dig_t *d = dig + len;
         mpz_dbl_dig_t a = 0;
 
         // compute next remainder
         while (--d >= dig) {
             a = (a << DIG_SIZE) | *d;
-            *d = a / base;
-            a %= base;
+            *d = a / chunk_base;
+            a %= chunk_base;
         }
 
-        // convert to character
-        a += '0';
-        if (a > '9') {
-            a += base_char - '9' - 1;
-        }
-        *s++ = a;
-
         // check if number is zero
-        done = true;
-        for (d = dig; d < dig + ilen; ++d) {
-            if (*d != 0) {
-                done = false;
-                break;
-            }
+        while (len > 0 && dig[len - 1] == 0) {
+            --len;
         }
-        if (comma && (s - last_comma) == 3) {
-            *s++ = comma;
-            last_comma = s;
+        done = len == 0;
+
+        // convert to characters, the most significant chunk without leading zeros
+        mpz_dig_t r = a;
+        for (unsigned int n = 0; n < chunk_len && (n == 0 || !done || r != 0); ++n) {
+            mpz_dig_t c = r % base + '0';
+            r /= base;
+            if (c > '9') {
+                c += base_char - '9' - 1;
+            }
+            if (comma && (s - last_comma) == 3) {
+                *s++ = comma;
+                last_comma = s;
+            }
+            *s++ = c;
         }
     }
     while (!done);
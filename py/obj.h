@@ -409,7 +409,12 @@ typedef struct _mp_map_t {
     size_t all_keys_are_qstrs : 1;
     size_t is_fixed : 1;    // if set, table is fixed/read-only and can't be modified
     size_t is_ordered : 1;  // if set, table is an ordered array, not a hash map
+    #if MICROPY_OPT_TYPE_ATTR_CACHE
+    size_t is_class_locals : 1; // if set, table is the locals of a class and changes invalidate the type attribute cache
+    size_t used : (8 * sizeof(size_t) - 4);
+    #else
     size_t used : (8 * sizeof(size_t) - 3);
+    #endif
     size_t alloc;
     mp_map_elem_t *table;
 } mp_map_t;
@@ -435,6 +440,10 @@ void mp_map_free(mp_map_t *map);
 mp_map_elem_t *mp_map_lookup(mp_map_t *map, mp_obj_t index, mp_map_lookup_kind_t lookup_kind);
 void mp_map_clear(mp_map_t *map);
 void mp_map_dump(mp_map_t *map);
+#if MICROPY_MAP_COMPACT
+size_t mp_map_table_bytes(size_t alloc);
+size_t mp_map_fill(const mp_map_t *map);
+#endif
 
 // Underlying set implementation (not set object)
 
@@ -127,7 +127,11 @@ STATIC mp_obj_t dict_unary_op(mp_unary_op_t op, mp_obj_t self_in) {
             return MP_OBJ_NEW_SMALL_INT(self->map.used);
         #if MICROPY_PY_SYS_GETSIZEOF
         case MP_UNARY_OP_SIZEOF: {
+            #if MICROPY_MAP_COMPACT
+            size_t sz = sizeof(*self) + mp_map_table_bytes(self->map.alloc);
+            #else
             size_t sz = sizeof(*self) + sizeof(*self->map.table) * self->map.alloc;
+            #endif
             return MP_OBJ_NEW_SMALL_INT(sz);
         }
         #endif
@@ -220,10 +224,16 @@ STATIC mp_obj_t dict_subscr(mp_obj_t self_in, mp_obj_t index, mp_obj_t value) {
 /******************************************************************************/
 /* dict methods                                                               */
 
+// Must be called before the dict is modified.
 STATIC void mp_ensure_not_fixed(const mp_obj_dict_t *dict) {
     if (dict->map.is_fixed) {
         mp_raise_TypeError(NULL);
     }
+    #if MICROPY_OPT_TYPE_ATTR_CACHE
+    if (dict->map.is_class_locals) {
+        mp_obj_type_attr_cache_invalidate();
+    }
+    #endif
 }
 
 STATIC mp_obj_t dict_clear(mp_obj_t self_in) {
@@ -247,7 +257,19 @@ mp_obj_t mp_obj_dict_copy(mp_obj_t self_in) {
     other->map.all_keys_are_qstrs = self->map.all_keys_are_qstrs;
     other->map.is_fixed = 0;
     other->map.is_ordered = self->map.is_ordered;
+    #if MICROPY_MAP_COMPACT
+    if (self->map.is_fixed && self->map.is_ordered) {
+        // A fixed table has no index, so build the copy by adding each entry.
+        other->map.used = 0;
+        for (size_t i = 0; i < self->map.used; i++) {
+            mp_map_lookup(&other->map, self->map.table[i].key, MP_MAP_LOOKUP_ADD_IF_NOT_FOUND)->value = self->map.table[i].value;
+        }
+        return other_out;
+    }
+    memcpy(other->map.table, self->map.table, mp_map_table_bytes(self->map.alloc));
+    #else
     memcpy(other->map.table, self->map.table, self->map.alloc * sizeof(mp_map_elem_t));
+    #endif
     return other_out;
 }
 STATIC MP_DEFINE_CONST_FUN_OBJ_1(dict_copy_obj, mp_obj_dict_copy);
@@ -336,6 +358,13 @@ STATIC mp_obj_t dict_popitem(mp_obj_t self_in) {
     if (self->map.used == 0) {
         mp_raise_msg(&mp_type_KeyError, MP_ERROR_TEXT("popitem(): dictionary is empty"));
     }
+    #if MICROPY_MAP_COMPACT
+    // The entries are in insertion order and the last one is never a deleted
+    // one, so remove it.
+    mp_map_elem_t *last = &self->map.table[mp_map_fill(&self->map) - 1];
+    mp_obj_t items[] = {last->key, last->value};
+    mp_map_lookup(&self->map, items[0], MP_MAP_LOOKUP_REMOVE_IF_FOUND)->value = MP_OBJ_NULL;
+    #else
     size_t cur = 0;
     #if MICROPY_PY_COLLECTIONS_ORDEREDDICT
     if (self->map.is_ordered) {
@@ -348,6 +377,7 @@ STATIC mp_obj_t dict_popitem(mp_obj_t self_in) {
     mp_obj_t items[] = {next->key, next->value};
     next->key = MP_OBJ_SENTINEL; // must mark key as sentinel to indicate that it was deleted
     next->value = MP_OBJ_NULL;
+    #endif
     mp_obj_t tuple = mp_obj_new_tuple(2, items);
 
     return tuple;
@@ -32,6 +32,7 @@
 #include "py/objfun.h"
 #include "py/runtime.h"
 #include "py/bc.h"
+#include "py/persistentcode.h"
 #include "py/stackctrl.h"
 
 #if MICROPY_DEBUG_VERBOSE // print debugging info
@@ -156,6 +157,15 @@ qstr mp_obj_code_get_name(const byte *code_info) {
 STATIC const mp_obj_type_t mp_type_fun_native;
 #endif
 
+#if MICROPY_PERSISTENT_CODE_LOAD_LAZY
+void mp_obj_fun_bc_load_lazy(mp_obj_fun_bc_t *self) {
+    // const_table refers to the location of the bytecode in its .mpy file
+    const mp_raw_code_t *rc = mp_raw_code_load_lazy(self->const_table);
+    self->bytecode = rc->fun_data;
+    self->const_table = rc->const_table;
+}
+#endif
+
 qstr mp_obj_fun_get_name(mp_const_obj_t fun_in) {
     const mp_obj_fun_bc_t *fun = MP_OBJ_TO_PTR(fun_in);
     #if MICROPY_EMIT_NATIVE
@@ -165,6 +175,7 @@ qstr mp_obj_fun_get_name(mp_const_obj_t fun_in) {
     }
     #endif
 
+    MP_OBJ_FUN_BC_LOAD((mp_obj_fun_bc_t *)fun);
     const byte *bc = fun->bytecode;
     MP_BC_PRELUDE_SIG_DECODE(bc);
     return mp_obj_code_get_name(bc);
@@ -217,6 +228,7 @@ STATIC void dump_args(const mp_obj_t *a, size_t sz) {
 mp_code_state_t *mp_obj_fun_bc_prepare_codestate(mp_obj_t self_in, size_t n_args, size_t n_kw, const mp_obj_t *args) {
     MP_STACK_CHECK();
     mp_obj_fun_bc_t *self = MP_OBJ_TO_PTR(self_in);
+    MP_OBJ_FUN_BC_LOAD(self);
 
     size_t n_state, state_size;
     DECODE_CODESTATE_SIZE(self->bytecode, n_state, state_size);
@@ -255,6 +267,7 @@ STATIC mp_obj_t fun_bc_call(mp_obj_t self_in, size_t n_args, size_t n_kw, const
     dump_args(args + n_args, n_kw * 2);
 
     mp_obj_fun_bc_t *self = MP_OBJ_TO_PTR(self_in);
+    MP_OBJ_FUN_BC_LOAD(self);
 
     size_t n_state, state_size;
     DECODE_CODESTATE_SIZE(self->bytecode, n_state, state_size);
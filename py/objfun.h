@@ -46,4 +46,17 @@ typedef struct _mp_obj_fun_bc_t {
 
 void mp_obj_fun_bc_attr(mp_obj_t self_in, qstr attr, mp_obj_t *dest);
 
+#if MICROPY_PERSISTENT_CODE_LOAD_LAZY
+// A function from a .mpy file whose bytecode is not loaded yet has bytecode==NULL
+#define MP_OBJ_FUN_BC_LOAD(self) \
+    do { \
+        if ((self)->bytecode == NULL) { \
+            mp_obj_fun_bc_load_lazy(self); \
+        } \
+    } while (0)
+void mp_obj_fun_bc_load_lazy(mp_obj_fun_bc_t *self);
+#else
+#define MP_OBJ_FUN_BC_LOAD(self) (void)0
+#endif
+
 #endif // MICROPY_INCLUDED_PY_OBJFUN_H
@@ -53,6 +53,7 @@ typedef struct _mp_obj_gen_instance_t {
 STATIC mp_obj_t gen_wrap_call(mp_obj_t self_in, size_t n_args, size_t n_kw, const mp_obj_t *args) {
     // A generating function is just a bytecode function with type mp_type_gen_wrap
     mp_obj_fun_bc_t *self_fun = MP_OBJ_TO_PTR(self_in);
+    MP_OBJ_FUN_BC_LOAD(self_fun);
 
     // bytecode prelude: get state size and exception stack size
     const uint8_t *ip = self_fun->bytecode;
@@ -354,6 +354,10 @@ mp_obj_t mp_obj_int_pow3(mp_obj_t base, mp_obj_t exponent,  mp_obj_t modulus) {
         mpz_t *rhs = mp_mpz_for_int(exponent, &r_temp);
         mpz_t *mod = mp_mpz_for_int(modulus,  &m_temp);
 
+        if (mpz_is_zero(mod)) {
+            mp_raise_ValueError(MP_ERROR_TEXT("pow() 3rd argument cannot be 0"));
+        }
+
         mpz_pow3_inpl(&(res_p->mpz), lhs, rhs, mod);
 
         if (lhs == &l_temp) {
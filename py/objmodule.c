@@ -203,6 +203,9 @@ STATIC const mp_rom_map_elem_t mp_builtin_module_table[] = {
     #if MICROPY_PY_UBINASCII
     { MP_ROM_QSTR(MP_QSTR_ubinascii), MP_ROM_PTR(&mp_module_ubinascii) },
     #endif
+    #if MICROPY_PY_UBUF
+    { MP_ROM_QSTR(MP_QSTR_ubuf), MP_ROM_PTR(&mp_module_ubuf) },
+    #endif
     #if MICROPY_PY_URANDOM
     { MP_ROM_QSTR(MP_QSTR_urandom), MP_ROM_PTR(&mp_module_urandom) },
     #endif
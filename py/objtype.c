@@ -46,6 +46,22 @@
 
 STATIC mp_obj_t static_class_method_make_new(const mp_obj_type_t *self_in, size_t n_args, size_t n_kw, const mp_obj_t *args);
 
+#if MICROPY_OPT_TYPE_ATTR_CACHE
+
+#define TYPE_ATTR_CACHE_BIND_NONE (0)
+#define TYPE_ATTR_CACHE_BIND_SELF (1)
+#define TYPE_ATTR_CACHE_BIND_TYPE (2)
+
+#define TYPE_ATTR_CACHE_HASH(type, attr) \
+    ((((uintptr_t)(type) >> 4) ^ (attr)) & (MICROPY_OPT_TYPE_ATTR_CACHE_SIZE - 1))
+
+// Must be called whenever the result of a lookup in a class may change.
+void mp_obj_type_attr_cache_invalidate(void) {
+    ++MP_STATE_VM(type_attr_cache_version);
+}
+
+#endif
+
 /******************************************************************************/
 // instance object
 
@@ -605,10 +621,45 @@ STATIC void mp_obj_instance_load_attr(mp_obj_t self_in, qstr attr, mp_obj_t *des
         .dest = dest,
         .is_type = false,
     };
+    #if MICROPY_OPT_TYPE_ATTR_CACHE
+    mp_type_attr_cache_entry_t *entry = &MP_STATE_THREAD(type_attr_cache)[TYPE_ATTR_CACHE_HASH(self->base.type, attr)];
+    size_t version = MP_STATE_VM(type_attr_cache_version);
+    if (entry->version == version && entry->type == self->base.type && entry->attr == attr) {
+        dest[0] = entry->member;
+        if (entry->bind == TYPE_ATTR_CACHE_BIND_SELF) {
+            dest[1] = self_in;
+        } else if (entry->bind == TYPE_ATTR_CACHE_BIND_TYPE) {
+            dest[1] = MP_OBJ_FROM_PTR(self->base.type);
+        }
+        return;
+    }
+    #endif
     mp_obj_class_lookup(&lookup, self->base.type);
     mp_obj_t member = dest[0];
     if (member != MP_OBJ_NULL) {
         if (!(self->base.type->flags & MP_TYPE_FLAG_HAS_SPECIAL_ACCESSORS)) {
+            #if MICROPY_OPT_TYPE_ATTR_CACHE
+            // Only cache results that depend solely on the class dicts, which
+            // excludes lookups that may go through a native base's attr slot.
+            const mp_obj_type_t *native_base;
+            if (instance_count_native_bases(self->base.type, &native_base) == 0) {
+                uintptr_t bind;
+                if (dest[1] == MP_OBJ_NULL) {
+                    bind = TYPE_ATTR_CACHE_BIND_NONE;
+                } else if (dest[1] == self_in) {
+                    bind = TYPE_ATTR_CACHE_BIND_SELF;
+                } else if (dest[1] == MP_OBJ_FROM_PTR(self->base.type)) {
+                    bind = TYPE_ATTR_CACHE_BIND_TYPE;
+                } else {
+                    return;
+                }
+                entry->version = version;
+                entry->type = self->base.type;
+                entry->attr = attr;
+                entry->member = member;
+                entry->bind = bind;
+            }
+            #endif
             // Class doesn't have any special accessors to check so return straightaway
             return;
         }
@@ -1062,6 +1113,9 @@ STATIC void type_attr(mp_obj_t self_in, qstr attr, mp_obj_t *dest) {
                 // can't apply delete/store to a fixed map
                 return;
             }
+            #if MICROPY_OPT_TYPE_ATTR_CACHE
+            mp_obj_type_attr_cache_invalidate();
+            #endif
             if (dest[1] == MP_OBJ_NULL) {
                 // delete attribute
                 mp_map_elem_t *elem = mp_map_lookup(locals_map, MP_OBJ_NEW_QSTR(attr), MP_MAP_LOOKUP_REMOVE_IF_FOUND);
@@ -1174,6 +1228,14 @@ mp_obj_t mp_obj_new_type(qstr name, mp_obj_t bases_tuple, mp_obj_t locals_dict)
     }
 
     o->locals_dict = MP_OBJ_TO_PTR(locals_dict);
+    #if MICROPY_OPT_TYPE_ATTR_CACHE
+    // The dict may still be reachable from Python, eg via locals() in the
+    // class body, so changes made directly to it must invalidate the cache.
+    // A fixed dict (possibly in ROM) can't be changed.
+    if (!o->locals_dict->map.is_fixed) {
+        o->locals_dict->map.is_class_locals = 1;
+    }
+    #endif
 
     #if ENABLE_SPECIAL_ACCESSORS
     // Check if the class has any special accessor methods
@@ -1206,6 +1268,11 @@ mp_obj_t mp_obj_new_type(qstr name, mp_obj_t bases_tuple, mp_obj_t locals_dict)
         }
     }
 
+    #if MICROPY_OPT_TYPE_ATTR_CACHE
+    // The new type may reuse the memory of a type that has been freed.
+    mp_obj_type_attr_cache_invalidate();
+    #endif
+
     return MP_OBJ_FROM_PTR(o);
 }
 
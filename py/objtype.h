@@ -51,6 +51,11 @@ mp_obj_t mp_obj_instance_call(mp_obj_t self_in, size_t n_args, size_t n_kw, cons
 // this needs to be exposed for the above macros to work correctly
 mp_obj_t mp_obj_instance_make_new(const mp_obj_type_t *self_in, size_t n_args, size_t n_kw, const mp_obj_t *args);
 
+#if MICROPY_OPT_TYPE_ATTR_CACHE
+// this needs to be exposed so modifying a class dict directly invalidates the cache
+void mp_obj_type_attr_cache_invalidate(void);
+#endif
+
 // this needs to be exposed for mp_getiter
 mp_obj_t mp_obj_instance_getiter(mp_obj_t self_in, mp_obj_iter_buf_t *iter_buf);
 
@@ -240,6 +240,12 @@ typedef struct _parser_t {
     #if MICROPY_COMP_CONST
     mp_map_t consts;
     #endif
+
+    #if MICROPY_COMP_STREAMING
+    mp_parse_stmts_fun_t stmts_fun;
+    void *stmts_env;
+    size_t stmts_bytes; // parse node memory used by the pending top-level statements
+    #endif
 } parser_t;
 
 STATIC const uint16_t *get_rule_arg(uint8_t r_id) {
@@ -288,9 +294,26 @@ STATIC void *parser_alloc(parser_t *parser, size_t num_bytes) {
 
     byte *ret = chunk->data + chunk->union_.used;
     chunk->union_.used += num_bytes;
+    #if MICROPY_COMP_STREAMING
+    parser->stmts_bytes += num_bytes;
+    #endif
     return ret;
 }
 
+// truncate the current chunk and link it into the chain of chunks of the tree
+STATIC void parser_finish_chunk(parser_t *parser) {
+    if (parser->cur_chunk != NULL) {
+        (void)m_renew_maybe(byte, parser->cur_chunk,
+            sizeof(mp_parse_chunk_t) + parser->cur_chunk->alloc,
+            sizeof(mp_parse_chunk_t) + parser->cur_chunk->union_.used,
+            false);
+        parser->cur_chunk->alloc = parser->cur_chunk->union_.used;
+        parser->cur_chunk->union_.next = parser->tree.chunk;
+        parser->tree.chunk = parser->cur_chunk;
+        parser->cur_chunk = NULL;
+    }
+}
+
 STATIC void push_rule(parser_t *parser, size_t src_line, uint8_t rule_id, size_t arg_i) {
     if (parser->rule_stack_top >= parser->rule_stack_alloc) {
         rule_stack_t *rs = m_renew(rule_stack_t, parser->rule_stack, parser->rule_stack_alloc, parser->rule_stack_alloc + MICROPY_ALLOC_PARSE_RULE_INC);
@@ -327,18 +350,21 @@ bool mp_parse_node_is_const_true(mp_parse_node_t pn) {
            || (MP_PARSE_NODE_IS_SMALL_INT(pn) && MP_PARSE_NODE_LEAF_SMALL_INT(pn) != 0);
 }
 
+STATIC mp_obj_t get_const_object(mp_parse_node_struct_t *pns) {
+    #if MICROPY_OBJ_REPR == MICROPY_OBJ_REPR_D
+    // nodes are 32-bit pointers, but need to extract 64-bit object
+    return (uint64_t)pns->nodes[0] | ((uint64_t)pns->nodes[1] << 32);
+    #else
+    return (mp_obj_t)pns->nodes[0];
+    #endif
+}
+
 bool mp_parse_node_get_int_maybe(mp_parse_node_t pn, mp_obj_t *o) {
     if (MP_PARSE_NODE_IS_SMALL_INT(pn)) {
         *o = MP_OBJ_NEW_SMALL_INT(MP_PARSE_NODE_LEAF_SMALL_INT(pn));
         return true;
     } else if (MP_PARSE_NODE_IS_STRUCT_KIND(pn, RULE_const_object)) {
-        mp_parse_node_struct_t *pns = (mp_parse_node_struct_t *)pn;
-        #if MICROPY_OBJ_REPR == MICROPY_OBJ_REPR_D
-        // nodes are 32-bit pointers, but need to extract 64-bit object
-        *o = (uint64_t)pns->nodes[0] | ((uint64_t)pns->nodes[1] << 32);
-        #else
-        *o = (mp_obj_t)pns->nodes[0];
-        #endif
+        *o = get_const_object((mp_parse_node_struct_t *)pn);
         return mp_obj_is_int(*o);
     } else {
         return false;
@@ -475,6 +501,32 @@ STATIC mp_parse_node_t mp_parse_node_new_small_int_checked(parser_t *parser, mp_
     return mp_parse_node_new_small_int(val);
 }
 
+#if MICROPY_COMP_CONST || MICROPY_COMP_CONST_FOLDING
+// Make a parse node for a constant value, using a leaf node where possible
+STATIC mp_parse_node_t make_node_const_value(parser_t *parser, size_t src_line, mp_obj_t obj) {
+    if (mp_obj_is_small_int(obj)) {
+        return mp_parse_node_new_small_int_checked(parser, obj);
+    }
+    #if MICROPY_COMP_CONST_STR
+    if (mp_obj_is_str_or_bytes(obj)) {
+        // intern the string if it's short or already interned, like a literal
+        size_t len;
+        const char *str = mp_obj_str_get_data(obj, &len);
+        qstr qst;
+        if (len <= MICROPY_ALLOC_PARSE_INTERN_STRING_LEN) {
+            qst = qstr_from_strn(str, len);
+        } else {
+            qst = qstr_find_strn(str, len);
+        }
+        if (qst != MP_QSTRnull) {
+            return mp_parse_node_new_leaf(mp_obj_is_str(obj) ? MP_PARSE_NODE_STRING : MP_PARSE_NODE_BYTES, qst);
+        }
+    }
+    #endif
+    return make_node_const_object(parser, src_line, obj);
+}
+#endif
+
 STATIC void push_result_token(parser_t *parser, uint8_t rule_id) {
     mp_parse_node_t pn;
     mp_lexer_t *lex = parser->lexer;
@@ -485,11 +537,7 @@ STATIC void push_result_token(parser_t *parser, uint8_t rule_id) {
         mp_map_elem_t *elem;
         if (rule_id == RULE_atom
             && (elem = mp_map_lookup(&parser->consts, MP_OBJ_NEW_QSTR(id), MP_MAP_LOOKUP)) != NULL) {
-            if (mp_obj_is_small_int(elem->value)) {
-                pn = mp_parse_node_new_small_int_checked(parser, elem->value);
-            } else {
-                pn = make_node_const_object(parser, lex->tok_line, elem->value);
-            }
+            pn = make_node_const_value(parser, lex->tok_line, elem->value);
         } else {
             pn = mp_parse_node_new_leaf(MP_PARSE_NODE_ID, id);
         }
@@ -608,8 +656,87 @@ STATIC bool fold_logical_constants(parser_t *parser, uint8_t rule_id, size_t *nu
     return false;
 }
 
+// Get the value of a node that can take part in constant folding: an integer,
+// and if enabled a float, str or bytes
+STATIC bool fold_get_const_maybe(mp_parse_node_t pn, mp_obj_t *o) {
+    if (mp_parse_node_get_int_maybe(pn, o)) {
+        return true;
+    }
+    #if MICROPY_COMP_CONST_STR
+    if (MP_PARSE_NODE_IS_LEAF(pn) && MP_PARSE_NODE_LEAF_KIND(pn) == MP_PARSE_NODE_STRING) {
+        *o = MP_OBJ_NEW_QSTR(MP_PARSE_NODE_LEAF_ARG(pn));
+        return true;
+    }
+    if (MP_PARSE_NODE_IS_LEAF(pn) && MP_PARSE_NODE_LEAF_KIND(pn) == MP_PARSE_NODE_BYTES) {
+        size_t len;
+        const byte *data = qstr_data(MP_PARSE_NODE_LEAF_ARG(pn), &len);
+        *o = mp_obj_new_bytes(data, len);
+        return true;
+    }
+    #endif
+    if (MP_PARSE_NODE_IS_STRUCT_KIND(pn, RULE_const_object)) {
+        *o = get_const_object((mp_parse_node_struct_t *)pn);
+        #if MICROPY_COMP_CONST_FLOAT
+        if (mp_obj_is_float(*o)) {
+            return true;
+        }
+        #endif
+        #if MICROPY_COMP_CONST_STR
+        if (mp_obj_is_str_or_bytes(*o)) {
+            return true;
+        }
+        #endif
+    }
+    return false;
+}
+
+// Compute lhs = lhs <op> rhs, returning false if the operation must be left
+// to the runtime, eg because it would raise an exception
+STATIC bool fold_binary_op(mp_binary_op_t op, mp_obj_t *lhs, mp_obj_t rhs) {
+    if (mp_obj_is_int(*lhs) && mp_obj_is_int(rhs)
+        && op != MP_BINARY_OP_MAT_MULTIPLY && op != MP_BINARY_OP_TRUE_DIVIDE) {
+        int rhs_sign = mp_obj_int_sign(rhs);
+        if (op == MP_BINARY_OP_LSHIFT || op == MP_BINARY_OP_RSHIFT || op == MP_BINARY_OP_POWER) {
+            // << >> and ** can't have negative rhs
+            if (rhs_sign < 0) {
+                return false;
+            }
+        } else if (op == MP_BINARY_OP_FLOOR_DIVIDE || op == MP_BINARY_OP_MODULO) {
+            // % and // can't have zero rhs
+            if (rhs_sign == 0) {
+                return false;
+            }
+        }
+        *lhs = mp_binary_op(op, *lhs, rhs);
+        return true;
+    }
+    #if MICROPY_COMP_CONST_STR
+    if (op == MP_BINARY_OP_ADD && mp_obj_is_str_or_bytes(*lhs)
+        && mp_obj_get_type(*lhs) == mp_obj_get_type(rhs)) {
+        // str + str or bytes + bytes
+        *lhs = mp_binary_op(op, *lhs, rhs);
+        return true;
+    }
+    #endif
+    #if MICROPY_COMP_CONST_FLOAT
+    if (op >= MP_BINARY_OP_ADD && op <= MP_BINARY_OP_POWER && op != MP_BINARY_OP_MAT_MULTIPLY
+        && (mp_obj_is_int(*lhs) || mp_obj_is_float(*lhs))
+        && (mp_obj_is_int(rhs) || mp_obj_is_float(rhs))) {
+        // arithmetic involving a float, or int / int; if it raises (eg division
+        // by zero) then don't fold, so the exception is raised at runtime
+        nlr_buf_t nlr;
+        if (nlr_push(&nlr) == 0) {
+            *lhs = mp_binary_op(op, *lhs, rhs);
+            nlr_pop();
+            return true;
+        }
+    }
+    #endif
+    return false;
+}
+
 STATIC bool fold_constants(parser_t *parser, uint8_t rule_id, size_t num_args) {
-    // this code does folding of arbitrary integer expressions, eg 1 + 2 * 3 + 4
+    // this code does folding of arbitrary constant expressions, eg 1 + 2 * 3 + 4
     // it does not do partial folding, eg 1 + 2 + x -> 3 + x
 
     mp_obj_t arg0;
@@ -619,7 +746,7 @@ STATIC bool fold_constants(parser_t *parser, uint8_t rule_id, size_t num_args) {
         || rule_id == RULE_power) {
         // folding for binary ops: | ^ & **
         mp_parse_node_t pn = peek_result(parser, num_args - 1);
-        if (!mp_parse_node_get_int_maybe(pn, &arg0)) {
+        if (!fold_get_const_maybe(pn, &arg0)) {
             return false;
         }
         mp_binary_op_t op;
@@ -635,58 +762,44 @@ STATIC bool fold_constants(parser_t *parser, uint8_t rule_id, size_t num_args) {
         for (ssize_t i = num_args - 2; i >= 0; --i) {
             pn = peek_result(parser, i);
             mp_obj_t arg1;
-            if (!mp_parse_node_get_int_maybe(pn, &arg1)) {
+            if (!fold_get_const_maybe(pn, &arg1)
+                || !fold_binary_op(op, &arg0, arg1)) {
                 return false;
             }
-            if (op == MP_BINARY_OP_POWER && mp_obj_int_sign(arg1) < 0) {
-                // ** can't have negative rhs
-                return false;
-            }
-            arg0 = mp_binary_op(op, arg0, arg1);
         }
     } else if (rule_id == RULE_shift_expr
                || rule_id == RULE_arith_expr
                || rule_id == RULE_term) {
         // folding for binary ops: << >> + - * @ / % //
         mp_parse_node_t pn = peek_result(parser, num_args - 1);
-        if (!mp_parse_node_get_int_maybe(pn, &arg0)) {
+        if (!fold_get_const_maybe(pn, &arg0)) {
             return false;
         }
         for (ssize_t i = num_args - 2; i >= 1; i -= 2) {
             pn = peek_result(parser, i - 1);
             mp_obj_t arg1;
-            if (!mp_parse_node_get_int_maybe(pn, &arg1)) {
+            if (!fold_get_const_maybe(pn, &arg1)) {
                 return false;
             }
             mp_token_kind_t tok = MP_PARSE_NODE_LEAF_ARG(peek_result(parser, i));
-            if (tok == MP_TOKEN_OP_AT || tok == MP_TOKEN_OP_SLASH) {
-                // Can't fold @ or /
-                return false;
-            }
             mp_binary_op_t op = MP_BINARY_OP_LSHIFT + (tok - MP_TOKEN_OP_DBL_LESS);
-            int rhs_sign = mp_obj_int_sign(arg1);
-            if (op <= MP_BINARY_OP_RSHIFT) {
-                // << and >> can't have negative rhs
-                if (rhs_sign < 0) {
-                    return false;
-                }
-            } else if (op >= MP_BINARY_OP_FLOOR_DIVIDE) {
-                // % and // can't have zero rhs
-                if (rhs_sign == 0) {
-                    return false;
-                }
+            if (!fold_binary_op(op, &arg0, arg1)) {
+                return false;
             }
-            arg0 = mp_binary_op(op, arg0, arg1);
         }
     } else if (rule_id == RULE_factor_2) {
         // folding for unary ops: + - ~
         mp_parse_node_t pn = peek_result(parser, 0);
-        if (!mp_parse_node_get_int_maybe(pn, &arg0)) {
+        if (!fold_get_const_maybe(pn, &arg0) || mp_obj_is_str_or_bytes(arg0)) {
             return false;
         }
         mp_token_kind_t tok = MP_PARSE_NODE_LEAF_ARG(peek_result(parser, 1));
         mp_unary_op_t op;
         if (tok == MP_TOKEN_OP_TILDE) {
+            if (!mp_obj_is_int(arg0)) {
+                // ~ can't be applied to a float
+                return false;
+            }
             op = MP_UNARY_OP_INVERT;
         } else {
             assert(tok == MP_TOKEN_OP_PLUS || tok == MP_TOKEN_OP_MINUS); // should be
@@ -715,12 +828,14 @@ STATIC bool fold_constants(parser_t *parser, uint8_t rule_id, size_t num_args) {
 
                 // get the value
                 mp_parse_node_t pn_value = ((mp_parse_node_struct_t *)((mp_parse_node_struct_t *)pn1)->nodes[1])->nodes[0];
+                // (floats are not allowed because mpy-cross can't fold them)
                 mp_obj_t value;
-                if (!mp_parse_node_get_int_maybe(pn_value, &value)) {
+                if (!fold_get_const_maybe(pn_value, &value) || mp_obj_is_float(value)) {
                     mp_obj_t exc = mp_obj_new_exception_msg(&mp_type_SyntaxError,
                         MP_ERROR_TEXT("constant must be an integer"));
                     mp_obj_exception_add_traceback(exc, parser->lexer->source_name,
                         ((mp_parse_node_struct_t *)pn1)->source_line, MP_QSTRnull);
+                    mp_lexer_free(parser->lexer);
                     nlr_raise(exc);
                 }
 
@@ -784,12 +899,7 @@ STATIC bool fold_constants(parser_t *parser, uint8_t rule_id, size_t num_args) {
     for (size_t i = num_args; i > 0; i--) {
         pop_result(parser);
     }
-    if (mp_obj_is_small_int(arg0)) {
-        push_result_node(parser, mp_parse_node_new_small_int_checked(parser, arg0));
-    } else {
-        // TODO reuse memory for parse node struct?
-        push_result_node(parser, make_node_const_object(parser, 0, arg0));
-    }
+    push_result_node(parser, make_node_const_value(parser, 0, arg0));
 
     return true;
 }
@@ -830,7 +940,36 @@ STATIC void push_result_rule(parser_t *parser, size_t src_line, uint8_t rule_id,
     push_result_node(parser, (mp_parse_node_t)pn);
 }
 
-mp_parse_tree_t mp_parse(mp_lexer_t *lex, mp_parse_input_kind_t input_kind) {
+#if MICROPY_COMP_STREAMING
+// Pass the pending top-level statements, which are the top num_stmts entries on
+// the result stack, to the callback along with the chunks that hold their nodes
+STATIC void parser_flush_stmts(parser_t *parser, size_t src_line, size_t num_stmts) {
+    if (num_stmts > 1) {
+        push_result_rule(parser, src_line, RULE_file_input_2, num_stmts);
+    }
+    parser_finish_chunk(parser);
+    parser->tree.root = pop_result(parser);
+    nlr_buf_t nlr;
+    if (nlr_push(&nlr) == 0) {
+        parser->stmts_fun(parser->stmts_env, &parser->tree);
+        nlr_pop();
+    } else {
+        // the statements failed to compile, so free the parser and the lexer
+        // as parse() would have done, then re-raise the exception
+        #if MICROPY_COMP_CONST
+        mp_map_deinit(&parser->consts);
+        #endif
+        m_del(rule_stack_t, parser->rule_stack, parser->rule_stack_alloc);
+        m_del(mp_parse_node_t, parser->result_stack, parser->result_stack_alloc);
+        mp_lexer_free(parser->lexer);
+        nlr_jump(nlr.ret_val);
+    }
+    parser->tree.chunk = NULL;
+    parser->stmts_bytes = 0;
+}
+#endif
+
+STATIC mp_parse_tree_t parse(mp_lexer_t *lex, mp_parse_input_kind_t input_kind, mp_parse_stmts_fun_t stmts_fun, void *stmts_env) {
 
     // initialise parser and allocate memory for its stacks
 
@@ -853,6 +992,15 @@ mp_parse_tree_t mp_parse(mp_lexer_t *lex, mp_parse_input_kind_t input_kind) {
     mp_map_init(&parser.consts, 0);
     #endif
 
+    #if MICROPY_COMP_STREAMING
+    parser.stmts_fun = stmts_fun;
+    parser.stmts_env = stmts_env;
+    parser.stmts_bytes = 0;
+    #else
+    (void)stmts_fun;
+    (void)stmts_env;
+    #endif
+
     // work out the top-level rule to use, and push it on the stack
     size_t top_level_rule;
     switch (input_kind) {
@@ -1074,6 +1222,15 @@ mp_parse_tree_t mp_parse(mp_lexer_t *lex, mp_parse_input_kind_t input_kind) {
                         }
                     }
                 } else {
+                    #if MICROPY_COMP_STREAMING
+                    if (rule_id == RULE_file_input_2 && i > 0 && parser.stmts_fun != NULL
+                        && parser.stmts_bytes >= MICROPY_COMP_STREAMING_BATCH) {
+                        // enough top-level statements are pending, so compile them now and
+                        // free their parse nodes, then continue with an empty list
+                        parser_flush_stmts(&parser, rule_src_line, i);
+                        i = 0;
+                    }
+                    #endif
                     for (;;) {
                         size_t arg = rule_arg[i & 1 & n];
                         if ((arg & RULE_ARG_KIND_MASK) == RULE_ARG_TOK) {
@@ -1130,15 +1287,7 @@ mp_parse_tree_t mp_parse(mp_lexer_t *lex, mp_parse_input_kind_t input_kind) {
     #endif
 
     // truncate final chunk and link into chain of chunks
-    if (parser.cur_chunk != NULL) {
-        (void)m_renew_maybe(byte, parser.cur_chunk,
-            sizeof(mp_parse_chunk_t) + parser.cur_chunk->alloc,
-            sizeof(mp_parse_chunk_t) + parser.cur_chunk->union_.used,
-            false);
-        parser.cur_chunk->alloc = parser.cur_chunk->union_.used;
-        parser.cur_chunk->union_.next = parser.tree.chunk;
-        parser.tree.chunk = parser.cur_chunk;
-    }
+    parser_finish_chunk(&parser);
 
     if (
         lex->tok_kind != MP_TOKEN_END // check we are at the end of the token stream
@@ -1159,6 +1308,8 @@ mp_parse_tree_t mp_parse(mp_lexer_t *lex, mp_parse_input_kind_t input_kind) {
         // add traceback to give info about file name and location
         // we don't have a 'block' name, so just pass the NULL qstr to indicate this
         mp_obj_exception_add_traceback(exc, lex->source_name, lex->tok_line, MP_QSTRnull);
+        // the caller relies on the lexer being freed, also on error
+        mp_lexer_free(lex);
         nlr_raise(exc);
     }
 
@@ -1176,6 +1327,21 @@ mp_parse_tree_t mp_parse(mp_lexer_t *lex, mp_parse_input_kind_t input_kind) {
     return parser.tree;
 }
 
+mp_parse_tree_t mp_parse(mp_lexer_t *lex, mp_parse_input_kind_t input_kind) {
+    return parse(lex, input_kind, NULL, NULL);
+}
+
+#if MICROPY_COMP_STREAMING
+void mp_parse_stream(mp_lexer_t *lex, mp_parse_stmts_fun_t stmts_fun, void *stmts_env) {
+    mp_parse_tree_t tree = parse(lex, MP_PARSE_FILE_INPUT, stmts_fun, stmts_env);
+    if (tree.root == MP_PARSE_NODE_NULL) {
+        mp_parse_tree_clear(&tree);
+    } else {
+        stmts_fun(stmts_env, &tree);
+    }
+}
+#endif
+
 void mp_parse_tree_clear(mp_parse_tree_t *tree) {
     mp_parse_chunk_t *chunk = tree->chunk;
     while (chunk != NULL) {
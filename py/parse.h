@@ -100,8 +100,16 @@ typedef struct _mp_parse_t {
 } mp_parse_tree_t;
 
 // the parser will raise an exception if an error occurred
-// the parser will free the lexer before it returns
+// the parser will free the lexer before it returns, also when it raises
 mp_parse_tree_t mp_parse(struct _mp_lexer_t *lex, mp_parse_input_kind_t input_kind);
 void mp_parse_tree_clear(mp_parse_tree_t *tree);
 
+// parse file input and pass batches of top-level statements to stmts_fun as soon
+// as they are parsed; stmts_fun must clear the parse tree that it is given, and
+// if it raises then the lexer is freed and the exception is propagated
+typedef void (*mp_parse_stmts_fun_t)(void *env, mp_parse_tree_t *tree);
+#if MICROPY_COMP_STREAMING
+void mp_parse_stream(struct _mp_lexer_t *lex, mp_parse_stmts_fun_t stmts_fun, void *stmts_env);
+#endif
+
 #endif // MICROPY_INCLUDED_PY_PARSE_H
@@ -349,9 +349,166 @@ STATIC void load_bytecode(mp_reader_t *reader, qstr_window_t *qw, byte *ip, byte
     }
 }
 
+#if MICROPY_PERSISTENT_CODE_LOAD_LAZY
+
+// A reader of a .mpy file that keeps track of the position in the file, so that
+// bytecode functions can be skipped at import and loaded when first called
+typedef struct _lazy_reader_t {
+    mp_reader_t reader; // the underlying file reader
+    qstr filename; // absolute path, MP_QSTRnull if functions must be loaded eagerly
+    size_t pos; // number of bytes read from the start of the file
+    uint32_t check; // FNV-1a hash of the bytes read since it was last reset
+} lazy_reader_t;
+
+// Where to find the bytecode of a function that is not loaded yet; the raw
+// code of such a function has fun_data==NULL and const_table pointing to this
+typedef struct _lazy_code_t {
+    mp_raw_code_t *rc;
+    qstr filename;
+    size_t offset; // position of the raw code in the file
+    size_t len; // length of the raw code in the file
+    uint32_t check; // hash of the raw code, to check the file didn't change
+    qstr_window_t qw; // state of the qstr window at the raw code
+} lazy_code_t;
+
+#define LAZY_CHECK_INIT (2166136261u)
+
+STATIC mp_uint_t lazy_reader_readbyte(void *data) {
+    lazy_reader_t *lr = data;
+    ++lr->pos;
+    mp_uint_t b = lr->reader.readbyte(lr->reader.data);
+    lr->check = (lr->check ^ (byte)b) * 16777619u;
+    return b;
+}
+
+STATIC void lazy_reader_close(void *data) {
+    lazy_reader_t *lr = data;
+    lr->reader.close(lr->reader.data);
+}
+
+STATIC lazy_reader_t *lazy_reader_get(mp_reader_t *reader) {
+    if (reader->readbyte != lazy_reader_readbyte) {
+        return NULL;
+    }
+    return reader->data;
+}
+
+STATIC void skip_bytes(mp_reader_t *reader, size_t len) {
+    while (len-- > 0) {
+        reader->readbyte(reader->data);
+    }
+}
+
+// Skip over a bytecode raw code, updating the qstr window as if it were loaded
+// but without allocating anything, and return its scope flags
+STATIC uint skip_bytecode_raw_code(mp_reader_t *reader, qstr_window_t *qw, size_t fun_data_len) {
+    // Read in and decode the prelude header (two var-uints)
+    byte buf[32];
+    size_t buf_len = 0;
+    for (int i = 0; i < 2; ++i) {
+        do {
+            if (buf_len == sizeof(buf)) {
+                mp_raise_ValueError(MP_ERROR_TEXT("incompatible .mpy file"));
+            }
+            buf[buf_len] = read_byte(reader);
+        } while (buf[buf_len++] & 0x80);
+    }
+    const byte *ip = buf;
+    MP_BC_PRELUDE_SIG_DECODE(ip);
+    MP_BC_PRELUDE_SIZE_DECODE(ip);
+    (void)n_state;
+    (void)n_exc_stack;
+    (void)n_def_pos_args;
+
+    // Skip the rest of the prelude, loading its qstrs
+    load_qstr(reader, qw);
+    load_qstr(reader, qw);
+    skip_bytes(reader, n_info - 4 + n_cell);
+
+    // Skip the opcodes, loading their qstrs
+    size_t len = fun_data_len - (ip - buf) - n_info - n_cell;
+    while (len > 0) {
+        byte op = read_byte(reader);
+        size_t sz;
+        uint f = mp_opcode_format(&op, &sz, false);
+        len -= sz;
+        --sz;
+        if (f == MP_BC_FORMAT_QSTR) {
+            load_qstr(reader, qw);
+            sz -= 2;
+        } else if (f == MP_BC_FORMAT_VAR_UINT) {
+            while (read_byte(reader) & 0x80) {
+                --len;
+            }
+            --len;
+        }
+        skip_bytes(reader, sz);
+    }
+
+    // Skip the constant table
+    size_t n_obj = read_uint(reader, NULL);
+    size_t n_raw_code = read_uint(reader, NULL);
+    for (size_t i = 0; i < n_pos_args + n_kwonly_args; ++i) {
+        load_qstr(reader, qw);
+    }
+    for (size_t i = 0; i < n_obj; ++i) {
+        if (read_byte(reader) != 'e') {
+            skip_bytes(reader, read_uint(reader, NULL));
+        }
+    }
+    for (size_t i = 0; i < n_raw_code; ++i) {
+        size_t kind_len = read_uint(reader, NULL);
+        if ((kind_len & 3) + MP_CODE_BYTECODE != MP_CODE_BYTECODE) {
+            mp_raise_ValueError(MP_ERROR_TEXT("incompatible .mpy file"));
+        }
+        skip_bytecode_raw_code(reader, qw, kind_len >> 2);
+    }
+
+    return scope_flags;
+}
+
+#endif
+
+STATIC mp_raw_code_t *load_raw_code_kind(mp_reader_t *reader, qstr_window_t *qw, size_t kind_len);
+
 STATIC mp_raw_code_t *load_raw_code(mp_reader_t *reader, qstr_window_t *qw) {
+    #if MICROPY_PERSISTENT_CODE_LOAD_LAZY
+    lazy_reader_t *lr = lazy_reader_get(reader);
+    size_t offset = 0;
+    if (lr != NULL) {
+        offset = lr->pos;
+        lr->check = LAZY_CHECK_INIT;
+    }
+    #endif
+
     // Load function kind and data length
     size_t kind_len = read_uint(reader, NULL);
+
+    #if MICROPY_PERSISTENT_CODE_LOAD_LAZY
+    // A nested bytecode function that is bigger than the information needed to
+    // find it again is skipped, and loaded from the file when first called
+    if (lr != NULL && lr->filename != MP_QSTRnull
+        && (kind_len & 3) + MP_CODE_BYTECODE == MP_CODE_BYTECODE
+        && (kind_len >> 2) > sizeof(lazy_code_t)) {
+        lazy_code_t *lazy = m_new_obj(lazy_code_t);
+        lazy->filename = lr->filename;
+        lazy->offset = offset;
+        lazy->qw = *qw;
+        mp_raw_code_t *rc = mp_emit_glue_new_raw_code();
+        rc->kind = MP_CODE_BYTECODE;
+        rc->scope_flags = skip_bytecode_raw_code(reader, qw, kind_len >> 2);
+        rc->const_table = (const mp_uint_t *)lazy;
+        lazy->len = lr->pos - offset;
+        lazy->check = lr->check;
+        lazy->rc = rc;
+        return rc;
+    }
+    #endif
+
+    return load_raw_code_kind(reader, qw, kind_len);
+}
+
+STATIC mp_raw_code_t *load_raw_code_kind(mp_reader_t *reader, qstr_window_t *qw, size_t kind_len) {
     int kind = (kind_len & 3) + MP_CODE_BYTECODE;
     size_t fun_data_len = kind_len >> 2;
 
@@ -562,9 +719,17 @@ mp_raw_code_t *mp_raw_code_load(mp_reader_t *reader) {
             mp_raise_ValueError(MP_ERROR_TEXT("incompatible .mpy arch"));
         }
     }
+    #if MICROPY_PERSISTENT_CODE_LOAD_LAZY
+    lazy_reader_t *lr = lazy_reader_get(reader);
+    if (lr != NULL && MPY_FEATURE_DECODE_ARCH(header[2]) != MP_NATIVE_ARCH_NONE) {
+        // native code can't be skipped over, so load everything now
+        lr->filename = MP_QSTRnull;
+    }
+    #endif
     qstr_window_t qw;
     qw.idx = 0;
-    mp_raw_code_t *rc = load_raw_code(reader, &qw);
+    // the outer module code is always loaded, even in lazy mode
+    mp_raw_code_t *rc = load_raw_code_kind(reader, &qw, read_uint(reader, NULL));
     reader->close(reader->data);
     return rc;
 }
@@ -579,10 +744,70 @@ mp_raw_code_t *mp_raw_code_load_mem(const byte *buf, size_t len) {
 
 mp_raw_code_t *mp_raw_code_load_file(const char *filename) {
     mp_reader_t reader;
+    #if MICROPY_PERSISTENT_CODE_LOAD_LAZY
+    lazy_reader_t lr;
+    mp_reader_new_file(&lr.reader, filename);
+    // the functions are loaded from the same file even if the current
+    // directory changes later
+    lr.filename = mp_reader_file_abspath(filename);
+    lr.pos = 0;
+    reader.data = &lr;
+    reader.readbyte = lazy_reader_readbyte;
+    reader.close = lazy_reader_close;
+    #else
     mp_reader_new_file(&reader, filename);
+    #endif
     return mp_raw_code_load(&reader);
 }
 
+#if MICROPY_PERSISTENT_CODE_LOAD_LAZY
+
+// Load the bytecode of a function that was skipped when its .mpy file was
+// imported, and return its (now complete) raw code
+const mp_raw_code_t *mp_raw_code_load_lazy(const void *lazy_in) {
+    const lazy_code_t *lazy = lazy_in;
+    mp_raw_code_t *rc = lazy->rc;
+    if (rc->fun_data == NULL) {
+        // Read the raw code into RAM and check that it is the same as when the
+        // file was imported, so that the file is closed again before anything
+        // is loaded from it
+        byte *buf = m_new(byte, lazy->len);
+        lazy_reader_t lr;
+        mp_reader_new_file_at(&lr.reader, qstr_str(lazy->filename), lazy->offset);
+        lr.pos = lazy->offset;
+        lr.check = LAZY_CHECK_INIT;
+        nlr_buf_t nlr;
+        if (nlr_push(&nlr) == 0) {
+            for (size_t i = 0; i < lazy->len; ++i) {
+                buf[i] = lazy_reader_readbyte(&lr);
+            }
+            nlr_pop();
+        } else {
+            lazy_reader_close(&lr);
+            nlr_jump(nlr.ret_val);
+        }
+        lazy_reader_close(&lr);
+        if (lr.check != lazy->check) {
+            m_del(byte, buf, lazy->len);
+            mp_raise_ValueError(MP_ERROR_TEXT("incompatible .mpy file"));
+        }
+
+        // Load the raw code, whose nested functions are left to be loaded later
+        mp_reader_new_mem(&lr.reader, buf, lazy->len, lazy->len);
+        lr.filename = lazy->filename;
+        lr.pos = lazy->offset;
+        mp_reader_t reader = {&lr, lazy_reader_readbyte, lazy_reader_close};
+        qstr_window_t qw = lazy->qw;
+        mp_raw_code_t *loaded = load_raw_code_kind(&reader, &qw, read_uint(&reader, NULL));
+        reader.close(reader.data);
+        *rc = *loaded;
+        m_del_obj(mp_raw_code_t, loaded);
+    }
+    return rc;
+}
+
+#endif
+
 #endif // MICROPY_HAS_FILE_READER
 
 #endif // MICROPY_PERSISTENT_CODE_LOAD
@@ -106,6 +106,9 @@ enum {
 mp_raw_code_t *mp_raw_code_load(mp_reader_t *reader);
 mp_raw_code_t *mp_raw_code_load_mem(const byte *buf, size_t len);
 mp_raw_code_t *mp_raw_code_load_file(const char *filename);
+#if MICROPY_PERSISTENT_CODE_LOAD_LAZY
+const mp_raw_code_t *mp_raw_code_load_lazy(const void *lazy);
+#endif
 
 void mp_raw_code_save(mp_raw_code_t *rc, mp_print_t *print);
 void mp_raw_code_save_file(mp_raw_code_t *rc, const char *filename);
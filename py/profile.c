@@ -27,6 +27,7 @@
 #include "py/profile.h"
 #include "py/bc0.h"
 #include "py/gc.h"
+#include "py/persistentcode.h"
 
 #if MICROPY_PY_SYS_SETTRACE
 
@@ -181,6 +182,11 @@ const mp_obj_type_t mp_type_settrace_codeobj = {
 };
 
 mp_obj_t mp_obj_new_code(const mp_raw_code_t *rc) {
+    #if MICROPY_PERSISTENT_CODE_LOAD_LAZY
+    if (rc->kind == MP_CODE_BYTECODE && rc->fun_data == NULL) {
+        rc = mp_raw_code_load_lazy(rc->const_table);
+    }
+    #endif
     mp_obj_code_t *o = m_new_obj_maybe(mp_obj_code_t);
     if (o == NULL) {
         return MP_OBJ_NULL;
@@ -183,6 +183,7 @@ PY_EXTMOD_O_BASENAME = \
 	extmod/moduhashlib.o \
 	extmod/moducryptolib.o \
 	extmod/modubinascii.o \
+	extmod/modubuf.o \
 	extmod/virtpin.o \
 	extmod/machine_mem.o \
 	extmod/machine_pinbase.o \
@@ -33,8 +33,8 @@
 #include "py/gc.h"
 #include "py/runtime.h"
 
-// NOTE: we are using linear arrays to store and search for qstr's (unique strings, interned strings)
-// ultimately we will replace this with a static hash table of some kind
+// NOTE: we are using linear arrays to store qstr's (unique strings, interned strings), which are
+// searched linearly unless MICROPY_QSTR_HASH_INDEX enables hash tables over them
 // also probably need to include the length in the string data, to allow null bytes in the string
 
 #if MICROPY_DEBUG_VERBOSE // print debugging info
@@ -86,13 +86,18 @@
 #define MICROPY_ALLOC_QSTR_ENTRIES_INIT (10)
 
 // this must match the equivalent function in makeqstrdata.py
-mp_uint_t qstr_compute_hash(const byte *data, size_t len) {
+STATIC uint32_t qstr_compute_hash_full(const byte *data, size_t len) {
     // djb2 algorithm; see http://www.cse.yorku.ca/~oz/hash.html
-    mp_uint_t hash = 5381;
+    uint32_t hash = 5381;
     for (const byte *top = data + len; data < top; data++) {
         hash = ((hash << 5) + hash) ^ (*data); // hash * 33 ^ data
     }
-    hash &= Q_HASH_MASK;
+    return hash;
+}
+
+// The stored hash of a qstr is the low bits of its full hash.
+STATIC mp_uint_t qstr_hash_from_full(uint32_t full_hash) {
+    mp_uint_t hash = full_hash & Q_HASH_MASK;
     // Make sure that valid hash is never zero, zero means "hash not computed"
     if (hash == 0) {
         hash++;
@@ -100,6 +105,10 @@ mp_uint_t qstr_compute_hash(const byte *data, size_t len) {
     return hash;
 }
 
+mp_uint_t qstr_compute_hash(const byte *data, size_t len) {
+    return qstr_hash_from_full(qstr_compute_hash_full(data, len));
+}
+
 const qstr_pool_t mp_qstr_const_pool = {
     NULL,               // no previous pool
     0,                  // no previous pool
@@ -121,10 +130,25 @@ extern const qstr_pool_t MICROPY_QSTR_EXTRA_POOL;
 #define CONST_POOL mp_qstr_const_pool
 #endif
 
+#if MICROPY_QSTR_HASH_INDEX && !defined(NO_QSTR)
+// Hash table of the static pool, generated by makeqstrdata.py.
+#define QDEF(id, str)
+#define QSTR_HASH_INDEX(len) STATIC const uint16_t mp_qstr_const_index[len]
+#include "genhdr/qstrdefs.generated.h"
+#undef QSTR_HASH_INDEX
+#undef QDEF
+#endif
+
 void qstr_init(void) {
     MP_STATE_VM(last_pool) = (qstr_pool_t *)&CONST_POOL; // we won't modify the const_pool since it has no allocated room left
     MP_STATE_VM(qstr_last_chunk) = NULL;
 
+    #if MICROPY_QSTR_HASH_INDEX
+    // the table for the other pools is created when the first qstr is added
+    MP_STATE_VM(qstr_index) = NULL;
+    MP_STATE_VM(qstr_index_used) = 0;
+    #endif
+
     #if MICROPY_PY_THREAD && !MICROPY_PY_THREAD_GIL
     mp_thread_mutex_init(&MP_STATE_VM(qstr_mutex));
     #endif
@@ -140,6 +164,105 @@ STATIC const byte *find_qstr(qstr q) {
     return pool->qstrs[q - pool->total_prev_len];
 }
 
+#if MICROPY_QSTR_HASH_INDEX
+// Hash table of the qstrs that are not in the static pool.  Lookups don't take
+// qstr_mutex, so the table is published together with its size through the
+// single pointer MP_STATE_VM(qstr_index), and is only written to in place by
+// adding entries.
+typedef struct _qstr_index_t {
+    #if MICROPY_PY_THREAD && !MICROPY_PY_THREAD_GIL
+    // Tables that were replaced are kept reachable, and so are never freed,
+    // because another thread may still be searching them.
+    struct _qstr_index_t *prev;
+    #endif
+    size_t alloc; // number of entries, a power of 2, or 0 if the table is out of date
+    uint16_t table[];
+} qstr_index_t;
+
+// Look up a string in a qstr hash table, which has a power of 2 number of
+// entries and is never full.  Returns MP_QSTRnull if not found.
+STATIC qstr qstr_index_find(const uint16_t *index, size_t alloc, uint32_t full_hash, const char *str, size_t str_len) {
+    mp_uint_t str_hash = qstr_hash_from_full(full_hash);
+    for (size_t i = full_hash & (alloc - 1);; i = (i + 1) & (alloc - 1)) {
+        qstr q = index[i];
+        if (q == MP_QSTRnull) {
+            return MP_QSTRnull;
+        }
+        const byte *qd = q < MP_QSTRnumber_of ? mp_qstr_const_pool.qstrs[q] : find_qstr(q);
+        if (Q_GET_HASH(qd) == str_hash && Q_GET_LENGTH(qd) == str_len && memcmp(Q_GET_DATA(qd), str, str_len) == 0) {
+            return q;
+        }
+    }
+}
+
+STATIC void qstr_index_insert(qstr_index_t *index, qstr q, const byte *qd) {
+    size_t mask = index->alloc - 1;
+    size_t i = qstr_compute_hash_full(Q_GET_DATA(qd), Q_GET_LENGTH(qd)) & mask;
+    while (index->table[i] != MP_QSTRnull) {
+        i = (i + 1) & mask;
+    }
+    index->table[i] = q;
+    MP_STATE_VM(qstr_index_used) += 1;
+}
+
+// Add a newly created qstr to the hash table of the qstrs that are not in the
+// static pool, rebuilding the table when it gets too full.  If the table can't
+// be allocated then lookups fall back to scanning the pools.
+// qstr_mutex must be taken while in this function
+STATIC void qstr_index_add(qstr q, const byte *qd) {
+    qstr_index_t *index = MP_STATE_VM(qstr_index);
+    if (index != NULL && (MP_STATE_VM(qstr_index_used) + 1) * 3 <= index->alloc * 2) {
+        qstr_index_insert(index, q, qd);
+        return;
+    }
+
+    #if MICROPY_PY_THREAD && !MICROPY_PY_THREAD_GIL
+    // stop lookups using the old table, which doesn't have q
+    if (index != NULL) {
+        index->alloc = 0;
+    }
+    #else
+    if (index != NULL) {
+        m_del_var(qstr_index_t, uint16_t, index->alloc, index);
+        MP_STATE_VM(qstr_index) = NULL;
+        index = NULL;
+    }
+    #endif
+    MP_STATE_VM(qstr_index_used) = 0;
+
+    if (q > 0xffff) {
+        // qstr ids no longer fit in the table entries
+        return;
+    }
+
+    // size the new table for a load factor of 1/3
+    size_t n = QSTR_TOTAL() - MP_QSTRnumber_of;
+    size_t alloc = 16;
+    while (alloc < n * 3) {
+        alloc *= 2;
+    }
+    qstr_index_t *new_index = m_new_obj_var_maybe(qstr_index_t, uint16_t, alloc);
+    if (new_index == NULL) {
+        return;
+    }
+    #if MICROPY_PY_THREAD && !MICROPY_PY_THREAD_GIL
+    new_index->prev = index;
+    #endif
+    new_index->alloc = alloc;
+    memset(new_index->table, 0, alloc * sizeof(uint16_t));
+
+    // insert all the qstrs that are not in the static pool, including q
+    for (qstr_pool_t *pool = MP_STATE_VM(last_pool); pool != &mp_qstr_const_pool; pool = pool->prev) {
+        for (size_t i = 0; i < pool->len; ++i) {
+            qstr_index_insert(new_index, pool->total_prev_len + i, pool->qstrs[i]);
+        }
+    }
+
+    // publish the new table once it is complete
+    MP_STATE_VM(qstr_index) = new_index;
+}
+#endif
+
 // qstr_mutex must be taken while in this function
 STATIC qstr qstr_add(const byte *q_ptr) {
     DEBUG_printf("QSTR: add hash=%d len=%d data=%.*s\n", Q_GET_HASH(q_ptr), Q_GET_LENGTH(q_ptr), Q_GET_LENGTH(q_ptr), Q_GET_DATA(q_ptr));
@@ -166,17 +289,42 @@ STATIC qstr qstr_add(const byte *q_ptr) {
 
     // add the new qstr
     MP_STATE_VM(last_pool)->qstrs[MP_STATE_VM(last_pool)->len++] = q_ptr;
+    qstr q = MP_STATE_VM(last_pool)->total_prev_len + MP_STATE_VM(last_pool)->len - 1;
+
+    #if MICROPY_QSTR_HASH_INDEX
+    qstr_index_add(q, q_ptr);
+    #endif
 
     // return id for the newly-added qstr
-    return MP_STATE_VM(last_pool)->total_prev_len + MP_STATE_VM(last_pool)->len - 1;
+    return q;
 }
 
 qstr qstr_find_strn(const char *str, size_t str_len) {
     // work out hash of str
-    mp_uint_t str_hash = qstr_compute_hash((const byte *)str, str_len);
+    uint32_t full_hash = qstr_compute_hash_full((const byte *)str, str_len);
+    mp_uint_t str_hash = qstr_hash_from_full(full_hash);
+
+    #if MICROPY_QSTR_HASH_INDEX
+    // look in the hash table of the static pool, then in that of the other pools
+    qstr found = qstr_index_find(mp_qstr_const_index, MP_ARRAY_SIZE(mp_qstr_const_index), full_hash, str, str_len);
+    if (found != MP_QSTRnull) {
+        return found;
+    }
+    const qstr_index_t *index = MP_STATE_VM(qstr_index);
+    if (index != NULL) {
+        size_t alloc = index->alloc;
+        if (alloc != 0) {
+            return qstr_index_find(index->table, alloc, full_hash, str, str_len);
+        }
+    }
+    // no table for the other pools, so scan them
+    const qstr_pool_t *pool_end = &mp_qstr_const_pool;
+    #else
+    const qstr_pool_t *pool_end = NULL;
+    #endif
 
     // search pools for the data
-    for (qstr_pool_t *pool = MP_STATE_VM(last_pool); pool != NULL; pool = pool->prev) {
+    for (qstr_pool_t *pool = MP_STATE_VM(last_pool); pool != pool_end; pool = pool->prev) {
         for (const byte **q = pool->qstrs, **q_top = pool->qstrs + pool->len; q < q_top; q++) {
             if (Q_GET_HASH(*q) == str_hash && Q_GET_LENGTH(*q) == str_len && memcmp(Q_GET_DATA(*q), str, str_len) == 0) {
                 return pool->total_prev_len + (q - pool->qstrs);
@@ -25,6 +25,7 @@
  */
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <assert.h>
 
 #include "py/runtime.h"
@@ -143,6 +144,30 @@ void mp_reader_new_file(mp_reader_t *reader, const char *filename) {
     }
     mp_reader_new_file_from_fd(reader, fd, true);
 }
+
+void mp_reader_new_file_at(mp_reader_t *reader, const char *filename, size_t offset) {
+    MP_THREAD_GIL_EXIT();
+    int fd = open(filename, O_RDONLY, 0644);
+    if (fd >= 0 && lseek(fd, offset, SEEK_SET) < 0) {
+        close(fd);
+        fd = -1;
+    }
+    MP_THREAD_GIL_ENTER();
+    if (fd < 0) {
+        mp_raise_OSError(errno);
+    }
+    mp_reader_new_file_from_fd(reader, fd, true);
+}
+
+qstr mp_reader_file_abspath(const char *filename) {
+    char *path = realpath(filename, NULL);
+    if (path == NULL) {
+        mp_raise_OSError(errno);
+    }
+    qstr q = qstr_from_str(path);
+    free(path);
+    return q;
+}
 #endif
 
 #endif
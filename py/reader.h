@@ -41,6 +41,8 @@ typedef struct _mp_reader_t {
 
 void mp_reader_new_mem(mp_reader_t *reader, const byte *buf, size_t len, size_t free_len);
 void mp_reader_new_file(mp_reader_t *reader, const char *filename);
+void mp_reader_new_file_at(mp_reader_t *reader, const char *filename, size_t offset);
+qstr mp_reader_file_abspath(const char *filename);
 void mp_reader_new_file_from_fd(mp_reader_t *reader, int fd, bool close_fd);
 
 #endif // MICROPY_INCLUDED_PY_READER_H
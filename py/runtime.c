@@ -129,6 +129,8 @@ void mp_init(void) {
     #if MICROPY_PY_SYS_SETTRACE
     MP_STATE_THREAD(prof_trace_callback) = MP_OBJ_NULL;
     MP_STATE_THREAD(prof_callback_is_executing) = false;
+    #endif
+    #if MICROPY_PY_SYS_SETTRACE || MICROPY_GC_PROFILE
     MP_STATE_THREAD(current_code_state) = NULL;
     #endif
 
@@ -1470,17 +1472,29 @@ mp_obj_t mp_parse_compile_execute(mp_lexer_t *lex, mp_parse_input_kind_t parse_i
 
     nlr_buf_t nlr;
     if (nlr_push(&nlr) == 0) {
-        qstr source_name = lex->source_name;
-        mp_parse_tree_t parse_tree = mp_parse(lex, parse_input_kind);
-        mp_obj_t module_fun = mp_compile(&parse_tree, source_name, parse_input_kind == MP_PARSE_SINGLE_INPUT);
-
         mp_obj_t ret;
-        if (MICROPY_PY_BUILTINS_COMPILE && globals == NULL) {
-            // for compile only, return value is the module function
-            ret = module_fun;
-        } else {
-            // execute module function and get return value
-            ret = mp_call_function_0(module_fun);
+        #if MICROPY_COMP_STREAMING
+        if (parse_input_kind == MP_PARSE_FILE_INPUT && globals != NULL) {
+            // compile the code a batch of statements at a time, then execute the batches in order
+            mp_obj_list_t *funs = MP_OBJ_TO_PTR(mp_compile_stream(lex));
+            for (size_t i = 0; i < funs->len; ++i) {
+                mp_call_function_0(funs->items[i]);
+            }
+            ret = mp_const_none;
+        } else
+        #endif
+        {
+            qstr source_name = lex->source_name;
+            mp_parse_tree_t parse_tree = mp_parse(lex, parse_input_kind);
+            mp_obj_t module_fun = mp_compile(&parse_tree, source_name, parse_input_kind == MP_PARSE_SINGLE_INPUT);
+
+            if (MICROPY_PY_BUILTINS_COMPILE && globals == NULL) {
+                // for compile only, return value is the module function
+                ret = module_fun;
+            } else {
+                // execute module function and get return value
+                ret = mp_call_function_0(module_fun);
+            }
         }
 
         // finish nlr block, restore context and return value
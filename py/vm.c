@@ -35,6 +35,7 @@
 #include "py/bc0.h"
 #include "py/bc.h"
 #include "py/profile.h"
+#include "py/smallint.h"
 
 // *FORMAT-OFF*
 
@@ -172,6 +173,24 @@
     } \
 } while(0)
 
+#elif MICROPY_GC_PROFILE
+
+// Only track the executing code state, so allocations can be attributed to it.
+// The code state to go back to is kept in prev_code_state, a local variable of
+// mp_execute_bytecode, so the layout of mp_code_state_t is not changed.
+#define FRAME_SETUP() do { \
+    MP_STATE_THREAD(current_code_state) = code_state; \
+} while(0)
+
+#define FRAME_ENTER()
+
+#define FRAME_LEAVE() do { \
+    MP_STATE_THREAD(current_code_state) = prev_code_state; \
+} while(0)
+
+#define FRAME_UPDATE()
+#define TRACE_TICK(current_ip, current_sp, is_exception)
+
 #else // MICROPY_PY_SYS_SETTRACE
 #define FRAME_SETUP()
 #define FRAME_ENTER()
@@ -214,11 +233,16 @@ mp_vm_return_kind_t mp_execute_bytecode(mp_code_state_t *code_state, volatile mp
 #endif
 #if MICROPY_OPT_COMPUTED_GOTO
     #include "py/vmentrytable.h"
+    #if MICROPY_OPT_COMPUTED_GOTO_SAVE_SPACE
+    #define ENTRY_GOTO(op) goto *((const char *)&&entry_default + entry_table[op])
+    #else
+    #define ENTRY_GOTO(op) goto *entry_table[op]
+    #endif
     #define DISPATCH() do { \
         TRACE(ip); \
         MARK_EXC_IP_GLOBAL(); \
         TRACE_TICK(ip, sp, false); \
-        goto *entry_table[*ip++]; \
+        ENTRY_GOTO(*ip++); \
     } while (0)
     #define DISPATCH_WITH_PEND_EXC_CHECK() goto pending_exception_check
     #define ENTRY(op) entry_##op
@@ -236,6 +260,10 @@ mp_vm_return_kind_t mp_execute_bytecode(mp_code_state_t *code_state, volatile mp
     // loop and the exception handler, leading to very obscure bugs.
     #define RAISE(o) do { nlr_pop(); nlr.ret_val = MP_OBJ_TO_PTR(o); goto exception_handler; } while (0)
 
+#if MICROPY_GC_PROFILE && !MICROPY_PY_SYS_SETTRACE
+    mp_code_state_t *const prev_code_state = MP_STATE_THREAD(current_code_state);
+#endif
+
 #if MICROPY_STACKLESS
 run_code_state: ;
 #endif
@@ -1325,6 +1353,11 @@ yield:
                     MARK_EXC_IP_SELECTIVE();
                     mp_obj_t rhs = POP();
                     mp_obj_t lhs = TOP();
+                    #if MICROPY_OPT_VM_SUPERINSTRUCTIONS
+                    if (mp_obj_is_small_int(lhs) && mp_obj_is_small_int(rhs)) {
+                        goto binary_op_small_int;
+                    }
+                    #endif
                     SET_TOP(mp_binary_op(ip[-1] - MP_BC_BINARY_OP_MULTI, lhs, rhs));
                     DISPATCH();
                 }
@@ -1348,6 +1381,11 @@ yield:
                     } else if (ip[-1] < MP_BC_BINARY_OP_MULTI + MP_BC_BINARY_OP_MULTI_NUM) {
                         mp_obj_t rhs = POP();
                         mp_obj_t lhs = TOP();
+                        #if MICROPY_OPT_VM_SUPERINSTRUCTIONS
+                        if (mp_obj_is_small_int(lhs) && mp_obj_is_small_int(rhs)) {
+                            goto binary_op_small_int;
+                        }
+                        #endif
                         SET_TOP(mp_binary_op(ip[-1] - MP_BC_BINARY_OP_MULTI, lhs, rhs));
                         DISPATCH();
                     } else
@@ -1361,6 +1399,70 @@ yield:
                     return MP_VM_RETURN_EXCEPTION;
                 }
 
+#if MICROPY_OPT_VM_SUPERINSTRUCTIONS
+                // Binary op on two small ints, the lhs at sp[0] and the rhs at sp[1].
+                // A comparison followed by a conditional jump is fused with the jump,
+                // so no bool is created and the jump opcode is not dispatched.
+binary_op_small_int: {
+                    mp_binary_op_t op = ip[-1] - MP_BC_BINARY_OP_MULTI;
+                    mp_int_t lhs = MP_OBJ_SMALL_INT_VALUE(sp[0]);
+                    mp_int_t rhs = MP_OBJ_SMALL_INT_VALUE(sp[1]);
+                    bool cmp;
+                    switch (op) {
+                        case MP_BINARY_OP_LESS:
+                            cmp = lhs < rhs;
+                            break;
+                        case MP_BINARY_OP_MORE:
+                            cmp = lhs > rhs;
+                            break;
+                        case MP_BINARY_OP_EQUAL:
+                            cmp = lhs == rhs;
+                            break;
+                        case MP_BINARY_OP_LESS_EQUAL:
+                            cmp = lhs <= rhs;
+                            break;
+                        case MP_BINARY_OP_MORE_EQUAL:
+                            cmp = lhs >= rhs;
+                            break;
+                        case MP_BINARY_OP_NOT_EQUAL:
+                            cmp = lhs != rhs;
+                            break;
+                        case MP_BINARY_OP_ADD:
+                        case MP_BINARY_OP_INPLACE_ADD:
+                        case MP_BINARY_OP_SUBTRACT:
+                        case MP_BINARY_OP_INPLACE_SUBTRACT: {
+                            // The result can't overflow an mp_int_t, only a small int.
+                            if (op == MP_BINARY_OP_ADD || op == MP_BINARY_OP_INPLACE_ADD) {
+                                lhs += rhs;
+                            } else {
+                                lhs -= rhs;
+                            }
+                            if (MP_SMALL_INT_FITS(lhs)) {
+                                SET_TOP(MP_OBJ_NEW_SMALL_INT(lhs));
+                                DISPATCH();
+                            }
+                        }
+                        MP_FALLTHROUGH
+                        default:
+                            SET_TOP(mp_binary_op(op, sp[0], sp[1]));
+                            DISPATCH();
+                    }
+                    #if !MICROPY_PY_SYS_SETTRACE
+                    if (*ip == MP_BC_POP_JUMP_IF_TRUE || *ip == MP_BC_POP_JUMP_IF_FALSE) {
+                        bool jump_if = *ip++ == MP_BC_POP_JUMP_IF_TRUE;
+                        DECODE_SLABEL;
+                        sp -= 1;
+                        if (cmp == jump_if) {
+                            ip += slab;
+                        }
+                        DISPATCH_WITH_PEND_EXC_CHECK();
+                    }
+                    #endif
+                    SET_TOP(mp_obj_new_bool(cmp));
+                    DISPATCH();
+                }
+#endif
+
 #if !MICROPY_OPT_COMPUTED_GOTO
                 } // switch
 #endif
@@ -1528,6 +1630,7 @@ unwind_loop:
                 mp_nonlocal_free(code_state, sizeof(mp_code_state_t));
                 #endif
                 code_state = new_code_state;
+                FRAME_SETUP();
                 size_t n_state = code_state->n_state;
                 fastn = &code_state->state[n_state - 1];
                 exc_stack = (mp_exc_stack_t*)(code_state->state + n_state);
@@ -35,91 +35,101 @@
 #pragma GCC diagnostic ignored "-Woverride-init"
 #endif // __GNUC__ >= 5
 
+#if MICROPY_OPT_COMPUTED_GOTO_SAVE_SPACE
+// Store each entry as a 16-bit offset from entry_default, which halves the
+// size of the table on 32-bit targets at the cost of an add per dispatch.
+#define ENTRY_ADDR(label) ((const char *)&&label - (const char *)&&entry_default)
+static const int16_t entry_table[256] = {
+#else
+#define ENTRY_ADDR(label) (&&label)
 static const void *const entry_table[256] = {
-    [0 ... 255] = &&entry_default,
-    [MP_BC_LOAD_CONST_FALSE] = &&entry_MP_BC_LOAD_CONST_FALSE,
-    [MP_BC_LOAD_CONST_NONE] = &&entry_MP_BC_LOAD_CONST_NONE,
-    [MP_BC_LOAD_CONST_TRUE] = &&entry_MP_BC_LOAD_CONST_TRUE,
-    [MP_BC_LOAD_CONST_SMALL_INT] = &&entry_MP_BC_LOAD_CONST_SMALL_INT,
-    [MP_BC_LOAD_CONST_STRING] = &&entry_MP_BC_LOAD_CONST_STRING,
-    [MP_BC_LOAD_CONST_OBJ] = &&entry_MP_BC_LOAD_CONST_OBJ,
-    [MP_BC_LOAD_NULL] = &&entry_MP_BC_LOAD_NULL,
-    [MP_BC_LOAD_FAST_N] = &&entry_MP_BC_LOAD_FAST_N,
-    [MP_BC_LOAD_DEREF] = &&entry_MP_BC_LOAD_DEREF,
-    [MP_BC_LOAD_NAME] = &&entry_MP_BC_LOAD_NAME,
-    [MP_BC_LOAD_GLOBAL] = &&entry_MP_BC_LOAD_GLOBAL,
-    [MP_BC_LOAD_ATTR] = &&entry_MP_BC_LOAD_ATTR,
-    [MP_BC_LOAD_METHOD] = &&entry_MP_BC_LOAD_METHOD,
-    [MP_BC_LOAD_SUPER_METHOD] = &&entry_MP_BC_LOAD_SUPER_METHOD,
-    [MP_BC_LOAD_BUILD_CLASS] = &&entry_MP_BC_LOAD_BUILD_CLASS,
-    [MP_BC_LOAD_SUBSCR] = &&entry_MP_BC_LOAD_SUBSCR,
-    [MP_BC_STORE_FAST_N] = &&entry_MP_BC_STORE_FAST_N,
-    [MP_BC_STORE_DEREF] = &&entry_MP_BC_STORE_DEREF,
-    [MP_BC_STORE_NAME] = &&entry_MP_BC_STORE_NAME,
-    [MP_BC_STORE_GLOBAL] = &&entry_MP_BC_STORE_GLOBAL,
-    [MP_BC_STORE_ATTR] = &&entry_MP_BC_STORE_ATTR,
-    [MP_BC_STORE_SUBSCR] = &&entry_MP_BC_STORE_SUBSCR,
-    [MP_BC_DELETE_FAST] = &&entry_MP_BC_DELETE_FAST,
-    [MP_BC_DELETE_DEREF] = &&entry_MP_BC_DELETE_DEREF,
-    [MP_BC_DELETE_NAME] = &&entry_MP_BC_DELETE_NAME,
-    [MP_BC_DELETE_GLOBAL] = &&entry_MP_BC_DELETE_GLOBAL,
-    [MP_BC_DUP_TOP] = &&entry_MP_BC_DUP_TOP,
-    [MP_BC_DUP_TOP_TWO] = &&entry_MP_BC_DUP_TOP_TWO,
-    [MP_BC_POP_TOP] = &&entry_MP_BC_POP_TOP,
-    [MP_BC_ROT_TWO] = &&entry_MP_BC_ROT_TWO,
-    [MP_BC_ROT_THREE] = &&entry_MP_BC_ROT_THREE,
-    [MP_BC_JUMP] = &&entry_MP_BC_JUMP,
-    [MP_BC_POP_JUMP_IF_TRUE] = &&entry_MP_BC_POP_JUMP_IF_TRUE,
-    [MP_BC_POP_JUMP_IF_FALSE] = &&entry_MP_BC_POP_JUMP_IF_FALSE,
-    [MP_BC_JUMP_IF_TRUE_OR_POP] = &&entry_MP_BC_JUMP_IF_TRUE_OR_POP,
-    [MP_BC_JUMP_IF_FALSE_OR_POP] = &&entry_MP_BC_JUMP_IF_FALSE_OR_POP,
-    [MP_BC_SETUP_WITH] = &&entry_MP_BC_SETUP_WITH,
-    [MP_BC_WITH_CLEANUP] = &&entry_MP_BC_WITH_CLEANUP,
-    [MP_BC_UNWIND_JUMP] = &&entry_MP_BC_UNWIND_JUMP,
-    [MP_BC_SETUP_EXCEPT] = &&entry_MP_BC_SETUP_EXCEPT,
-    [MP_BC_SETUP_FINALLY] = &&entry_MP_BC_SETUP_FINALLY,
-    [MP_BC_END_FINALLY] = &&entry_MP_BC_END_FINALLY,
-    [MP_BC_GET_ITER] = &&entry_MP_BC_GET_ITER,
-    [MP_BC_GET_ITER_STACK] = &&entry_MP_BC_GET_ITER_STACK,
-    [MP_BC_FOR_ITER] = &&entry_MP_BC_FOR_ITER,
-    [MP_BC_POP_EXCEPT_JUMP] = &&entry_MP_BC_POP_EXCEPT_JUMP,
-    [MP_BC_BUILD_TUPLE] = &&entry_MP_BC_BUILD_TUPLE,
-    [MP_BC_BUILD_LIST] = &&entry_MP_BC_BUILD_LIST,
-    [MP_BC_BUILD_MAP] = &&entry_MP_BC_BUILD_MAP,
-    [MP_BC_STORE_MAP] = &&entry_MP_BC_STORE_MAP,
+#endif
+    [0 ... 255] = ENTRY_ADDR(entry_default),
+    [MP_BC_LOAD_CONST_FALSE] = ENTRY_ADDR(entry_MP_BC_LOAD_CONST_FALSE),
+    [MP_BC_LOAD_CONST_NONE] = ENTRY_ADDR(entry_MP_BC_LOAD_CONST_NONE),
+    [MP_BC_LOAD_CONST_TRUE] = ENTRY_ADDR(entry_MP_BC_LOAD_CONST_TRUE),
+    [MP_BC_LOAD_CONST_SMALL_INT] = ENTRY_ADDR(entry_MP_BC_LOAD_CONST_SMALL_INT),
+    [MP_BC_LOAD_CONST_STRING] = ENTRY_ADDR(entry_MP_BC_LOAD_CONST_STRING),
+    [MP_BC_LOAD_CONST_OBJ] = ENTRY_ADDR(entry_MP_BC_LOAD_CONST_OBJ),
+    [MP_BC_LOAD_NULL] = ENTRY_ADDR(entry_MP_BC_LOAD_NULL),
+    [MP_BC_LOAD_FAST_N] = ENTRY_ADDR(entry_MP_BC_LOAD_FAST_N),
+    [MP_BC_LOAD_DEREF] = ENTRY_ADDR(entry_MP_BC_LOAD_DEREF),
+    [MP_BC_LOAD_NAME] = ENTRY_ADDR(entry_MP_BC_LOAD_NAME),
+    [MP_BC_LOAD_GLOBAL] = ENTRY_ADDR(entry_MP_BC_LOAD_GLOBAL),
+    [MP_BC_LOAD_ATTR] = ENTRY_ADDR(entry_MP_BC_LOAD_ATTR),
+    [MP_BC_LOAD_METHOD] = ENTRY_ADDR(entry_MP_BC_LOAD_METHOD),
+    [MP_BC_LOAD_SUPER_METHOD] = ENTRY_ADDR(entry_MP_BC_LOAD_SUPER_METHOD),
+    [MP_BC_LOAD_BUILD_CLASS] = ENTRY_ADDR(entry_MP_BC_LOAD_BUILD_CLASS),
+    [MP_BC_LOAD_SUBSCR] = ENTRY_ADDR(entry_MP_BC_LOAD_SUBSCR),
+    [MP_BC_STORE_FAST_N] = ENTRY_ADDR(entry_MP_BC_STORE_FAST_N),
+    [MP_BC_STORE_DEREF] = ENTRY_ADDR(entry_MP_BC_STORE_DEREF),
+    [MP_BC_STORE_NAME] = ENTRY_ADDR(entry_MP_BC_STORE_NAME),
+    [MP_BC_STORE_GLOBAL] = ENTRY_ADDR(entry_MP_BC_STORE_GLOBAL),
+    [MP_BC_STORE_ATTR] = ENTRY_ADDR(entry_MP_BC_STORE_ATTR),
+    [MP_BC_STORE_SUBSCR] = ENTRY_ADDR(entry_MP_BC_STORE_SUBSCR),
+    [MP_BC_DELETE_FAST] = ENTRY_ADDR(entry_MP_BC_DELETE_FAST),
+    [MP_BC_DELETE_DEREF] = ENTRY_ADDR(entry_MP_BC_DELETE_DEREF),
+    [MP_BC_DELETE_NAME] = ENTRY_ADDR(entry_MP_BC_DELETE_NAME),
+    [MP_BC_DELETE_GLOBAL] = ENTRY_ADDR(entry_MP_BC_DELETE_GLOBAL),
+    [MP_BC_DUP_TOP] = ENTRY_ADDR(entry_MP_BC_DUP_TOP),
+    [MP_BC_DUP_TOP_TWO] = ENTRY_ADDR(entry_MP_BC_DUP_TOP_TWO),
+    [MP_BC_POP_TOP] = ENTRY_ADDR(entry_MP_BC_POP_TOP),
+    [MP_BC_ROT_TWO] = ENTRY_ADDR(entry_MP_BC_ROT_TWO),
+    [MP_BC_ROT_THREE] = ENTRY_ADDR(entry_MP_BC_ROT_THREE),
+    [MP_BC_JUMP] = ENTRY_ADDR(entry_MP_BC_JUMP),
+    [MP_BC_POP_JUMP_IF_TRUE] = ENTRY_ADDR(entry_MP_BC_POP_JUMP_IF_TRUE),
+    [MP_BC_POP_JUMP_IF_FALSE] = ENTRY_ADDR(entry_MP_BC_POP_JUMP_IF_FALSE),
+    [MP_BC_JUMP_IF_TRUE_OR_POP] = ENTRY_ADDR(entry_MP_BC_JUMP_IF_TRUE_OR_POP),
+    [MP_BC_JUMP_IF_FALSE_OR_POP] = ENTRY_ADDR(entry_MP_BC_JUMP_IF_FALSE_OR_POP),
+    [MP_BC_SETUP_WITH] = ENTRY_ADDR(entry_MP_BC_SETUP_WITH),
+    [MP_BC_WITH_CLEANUP] = ENTRY_ADDR(entry_MP_BC_WITH_CLEANUP),
+    [MP_BC_UNWIND_JUMP] = ENTRY_ADDR(entry_MP_BC_UNWIND_JUMP),
+    [MP_BC_SETUP_EXCEPT] = ENTRY_ADDR(entry_MP_BC_SETUP_EXCEPT),
+    [MP_BC_SETUP_FINALLY] = ENTRY_ADDR(entry_MP_BC_SETUP_FINALLY),
+    [MP_BC_END_FINALLY] = ENTRY_ADDR(entry_MP_BC_END_FINALLY),
+    [MP_BC_GET_ITER] = ENTRY_ADDR(entry_MP_BC_GET_ITER),
+    [MP_BC_GET_ITER_STACK] = ENTRY_ADDR(entry_MP_BC_GET_ITER_STACK),
+    [MP_BC_FOR_ITER] = ENTRY_ADDR(entry_MP_BC_FOR_ITER),
+    [MP_BC_POP_EXCEPT_JUMP] = ENTRY_ADDR(entry_MP_BC_POP_EXCEPT_JUMP),
+    [MP_BC_BUILD_TUPLE] = ENTRY_ADDR(entry_MP_BC_BUILD_TUPLE),
+    [MP_BC_BUILD_LIST] = ENTRY_ADDR(entry_MP_BC_BUILD_LIST),
+    [MP_BC_BUILD_MAP] = ENTRY_ADDR(entry_MP_BC_BUILD_MAP),
+    [MP_BC_STORE_MAP] = ENTRY_ADDR(entry_MP_BC_STORE_MAP),
     #if MICROPY_PY_BUILTINS_SET
-    [MP_BC_BUILD_SET] = &&entry_MP_BC_BUILD_SET,
+    [MP_BC_BUILD_SET] = ENTRY_ADDR(entry_MP_BC_BUILD_SET),
     #endif
     #if MICROPY_PY_BUILTINS_SLICE
-    [MP_BC_BUILD_SLICE] = &&entry_MP_BC_BUILD_SLICE,
+    [MP_BC_BUILD_SLICE] = ENTRY_ADDR(entry_MP_BC_BUILD_SLICE),
     #endif
-    [MP_BC_STORE_COMP] = &&entry_MP_BC_STORE_COMP,
-    [MP_BC_UNPACK_SEQUENCE] = &&entry_MP_BC_UNPACK_SEQUENCE,
-    [MP_BC_UNPACK_EX] = &&entry_MP_BC_UNPACK_EX,
-    [MP_BC_MAKE_FUNCTION] = &&entry_MP_BC_MAKE_FUNCTION,
-    [MP_BC_MAKE_FUNCTION_DEFARGS] = &&entry_MP_BC_MAKE_FUNCTION_DEFARGS,
-    [MP_BC_MAKE_CLOSURE] = &&entry_MP_BC_MAKE_CLOSURE,
-    [MP_BC_MAKE_CLOSURE_DEFARGS] = &&entry_MP_BC_MAKE_CLOSURE_DEFARGS,
-    [MP_BC_CALL_FUNCTION] = &&entry_MP_BC_CALL_FUNCTION,
-    [MP_BC_CALL_FUNCTION_VAR_KW] = &&entry_MP_BC_CALL_FUNCTION_VAR_KW,
-    [MP_BC_CALL_METHOD] = &&entry_MP_BC_CALL_METHOD,
-    [MP_BC_CALL_METHOD_VAR_KW] = &&entry_MP_BC_CALL_METHOD_VAR_KW,
-    [MP_BC_RETURN_VALUE] = &&entry_MP_BC_RETURN_VALUE,
-    [MP_BC_RAISE_LAST] = &&entry_MP_BC_RAISE_LAST,
-    [MP_BC_RAISE_OBJ] = &&entry_MP_BC_RAISE_OBJ,
-    [MP_BC_RAISE_FROM] = &&entry_MP_BC_RAISE_FROM,
-    [MP_BC_YIELD_VALUE] = &&entry_MP_BC_YIELD_VALUE,
-    [MP_BC_YIELD_FROM] = &&entry_MP_BC_YIELD_FROM,
-    [MP_BC_IMPORT_NAME] = &&entry_MP_BC_IMPORT_NAME,
-    [MP_BC_IMPORT_FROM] = &&entry_MP_BC_IMPORT_FROM,
-    [MP_BC_IMPORT_STAR] = &&entry_MP_BC_IMPORT_STAR,
-    [MP_BC_LOAD_CONST_SMALL_INT_MULTI ... MP_BC_LOAD_CONST_SMALL_INT_MULTI + MP_BC_LOAD_CONST_SMALL_INT_MULTI_NUM - 1] = &&entry_MP_BC_LOAD_CONST_SMALL_INT_MULTI,
-    [MP_BC_LOAD_FAST_MULTI ... MP_BC_LOAD_FAST_MULTI + MP_BC_LOAD_FAST_MULTI_NUM - 1] = &&entry_MP_BC_LOAD_FAST_MULTI,
-    [MP_BC_STORE_FAST_MULTI ... MP_BC_STORE_FAST_MULTI + MP_BC_STORE_FAST_MULTI_NUM - 1] = &&entry_MP_BC_STORE_FAST_MULTI,
-    [MP_BC_UNARY_OP_MULTI ... MP_BC_UNARY_OP_MULTI + MP_BC_UNARY_OP_MULTI_NUM - 1] = &&entry_MP_BC_UNARY_OP_MULTI,
-    [MP_BC_BINARY_OP_MULTI ... MP_BC_BINARY_OP_MULTI + MP_BC_BINARY_OP_MULTI_NUM - 1] = &&entry_MP_BC_BINARY_OP_MULTI,
+    [MP_BC_STORE_COMP] = ENTRY_ADDR(entry_MP_BC_STORE_COMP),
+    [MP_BC_UNPACK_SEQUENCE] = ENTRY_ADDR(entry_MP_BC_UNPACK_SEQUENCE),
+    [MP_BC_UNPACK_EX] = ENTRY_ADDR(entry_MP_BC_UNPACK_EX),
+    [MP_BC_MAKE_FUNCTION] = ENTRY_ADDR(entry_MP_BC_MAKE_FUNCTION),
+    [MP_BC_MAKE_FUNCTION_DEFARGS] = ENTRY_ADDR(entry_MP_BC_MAKE_FUNCTION_DEFARGS),
+    [MP_BC_MAKE_CLOSURE] = ENTRY_ADDR(entry_MP_BC_MAKE_CLOSURE),
+    [MP_BC_MAKE_CLOSURE_DEFARGS] = ENTRY_ADDR(entry_MP_BC_MAKE_CLOSURE_DEFARGS),
+    [MP_BC_CALL_FUNCTION] = ENTRY_ADDR(entry_MP_BC_CALL_FUNCTION),
+    [MP_BC_CALL_FUNCTION_VAR_KW] = ENTRY_ADDR(entry_MP_BC_CALL_FUNCTION_VAR_KW),
+    [MP_BC_CALL_METHOD] = ENTRY_ADDR(entry_MP_BC_CALL_METHOD),
+    [MP_BC_CALL_METHOD_VAR_KW] = ENTRY_ADDR(entry_MP_BC_CALL_METHOD_VAR_KW),
+    [MP_BC_RETURN_VALUE] = ENTRY_ADDR(entry_MP_BC_RETURN_VALUE),
+    [MP_BC_RAISE_LAST] = ENTRY_ADDR(entry_MP_BC_RAISE_LAST),
+    [MP_BC_RAISE_OBJ] = ENTRY_ADDR(entry_MP_BC_RAISE_OBJ),
+    [MP_BC_RAISE_FROM] = ENTRY_ADDR(entry_MP_BC_RAISE_FROM),
+    [MP_BC_YIELD_VALUE] = ENTRY_ADDR(entry_MP_BC_YIELD_VALUE),
+    [MP_BC_YIELD_FROM] = ENTRY_ADDR(entry_MP_BC_YIELD_FROM),
+    [MP_BC_IMPORT_NAME] = ENTRY_ADDR(entry_MP_BC_IMPORT_NAME),
+    [MP_BC_IMPORT_FROM] = ENTRY_ADDR(entry_MP_BC_IMPORT_FROM),
+    [MP_BC_IMPORT_STAR] = ENTRY_ADDR(entry_MP_BC_IMPORT_STAR),
+    [MP_BC_LOAD_CONST_SMALL_INT_MULTI ... MP_BC_LOAD_CONST_SMALL_INT_MULTI + MP_BC_LOAD_CONST_SMALL_INT_MULTI_NUM - 1] = ENTRY_ADDR(entry_MP_BC_LOAD_CONST_SMALL_INT_MULTI),
+    [MP_BC_LOAD_FAST_MULTI ... MP_BC_LOAD_FAST_MULTI + MP_BC_LOAD_FAST_MULTI_NUM - 1] = ENTRY_ADDR(entry_MP_BC_LOAD_FAST_MULTI),
+    [MP_BC_STORE_FAST_MULTI ... MP_BC_STORE_FAST_MULTI + MP_BC_STORE_FAST_MULTI_NUM - 1] = ENTRY_ADDR(entry_MP_BC_STORE_FAST_MULTI),
+    [MP_BC_UNARY_OP_MULTI ... MP_BC_UNARY_OP_MULTI + MP_BC_UNARY_OP_MULTI_NUM - 1] = ENTRY_ADDR(entry_MP_BC_UNARY_OP_MULTI),
+    [MP_BC_BINARY_OP_MULTI ... MP_BC_BINARY_OP_MULTI + MP_BC_BINARY_OP_MULTI_NUM - 1] = ENTRY_ADDR(entry_MP_BC_BINARY_OP_MULTI),
 };
 
+#undef ENTRY_ADDR
+
 #if __clang__
 #pragma clang diagnostic pop
 #endif // __clang__
@@ -0,0 +1,30 @@
+# test exec of code with many top-level statements, which may be compiled in parts
+
+# functions can use globals that are defined by later statements
+src = []
+for i in range(100):
+    src.append("x%d = %d" % (i, i))
+    src.append("def f%d():\n    return x%d + y" % (i, i))
+src.append("y = 1000")
+src.append("result = [f() for f in (%s)]" % ", ".join("f%d" % i for i in range(100)))
+g = {}
+exec("\n".join(src), g)
+print(sum(g["result"]))
+
+# names declared global in a function refer to the module level
+exec("def set_z():\n    global z\n    z = 1\n" + "a = 1\n" * 200 + "set_z()\n", g)
+print(g["z"])
+
+# with separate locals, all top-level names are stored in the locals
+g = {}
+l = {}
+exec("b = 2\n" + "a = 1\n" * 200 + "c = a + b\n", g, l)
+print(sorted(l), sorted(k for k in g if k != "__builtins__"))
+
+# a syntax error at the end means no part of the code is executed
+g = {}
+try:
+    exec("ran = True\n" + "a = 1\n" * 200 + "1 +\n", g)
+except SyntaxError:
+    print("SyntaxError")
+print("ran" in g)
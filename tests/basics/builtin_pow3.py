@@ -28,3 +28,9 @@ try:
     print(pow(4, 5, "z"))
 except TypeError:
     print("TypeError expected")
+
+# modulus can't be zero
+try:
+    print(pow(4, 5, 0))
+except ValueError:
+    print("ValueError expected")
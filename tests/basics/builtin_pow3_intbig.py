@@ -20,3 +20,12 @@ print(hex(pow(2, x-1, x))) # Should be 1, since x is prime
 print(hex(pow(y, x-1, x))) # Should be 1, since x is prime
 print(hex(pow(y, y-1, x))) # Should be a 'big value'
 print(hex(pow(y, y-1, y))) # Should be a 'big value'
+
+# odd, even and negative moduli, and exponents of different lengths
+m = x * y
+for mod in (m, m + 1, -m, x, -x, (1 << 64) + 1, (1 << 64) + 2):
+    for e in (1, 2, 3, 65537, y, x - 2, x * x):
+        print(mod % 1000, e % 1000, pow(y, e, mod) % 1000003, pow(-y, e, mod) % 1000003)
+
+# modular inverse of y by Fermat's little theorem
+print(pow(y, x - 2, x) * y % x)
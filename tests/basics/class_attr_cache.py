@@ -0,0 +1,74 @@
+# test that repeated lookups of class attributes see changes to the classes
+
+
+class A:
+    x = 1
+
+    def f(self):
+        return "A.f"
+
+    @classmethod
+    def c(cls):
+        return cls.__name__
+
+    @staticmethod
+    def s():
+        return "A.s"
+
+
+class B(A):
+    pass
+
+
+a = A()
+b = B()
+
+
+def lookup():
+    return a.x, a.f(), a.c(), a.s(), b.x, b.f(), b.c(), b.s()
+
+
+# look up each attribute a few times so they are cached
+for i in range(3):
+    print(lookup())
+
+# redefine a method in the base class
+A.f = lambda self: "A.f2"
+print(lookup())
+
+# shadow attributes of the base class in the subclass
+B.x = 2
+B.f = lambda self: "B.f"
+print(lookup())
+
+# remove them again
+del B.x
+del B.f
+print(lookup())
+
+# instance members take precedence over class attributes
+a.x = 3
+print(lookup())
+del a.x
+print(lookup())
+
+# a bound method retrieved from the cache is bound to the right instance
+A.g = lambda self: self
+a2 = A()
+print(a.g() is a, a2.g() is a2, a.g() is a)
+
+# classes with the same attributes don't share results
+for i in range(3):
+    C = type("C", (), {"x": i, "f": lambda self, i=i: i})
+    print(C().x, C().f())
+
+# a property added after the attribute was cached
+class D:
+    def f(self):
+        return 1
+
+
+d = D()
+print(d.f(), d.f())
+D.f = property(lambda self: 2)
+print(d.f, d.f)
@@ -0,0 +1,52 @@
+# test dicts under many insertions and deletions
+
+# repeatedly add and remove keys so deleted slots build up
+d = {}
+for i in range(200):
+    d[i] = i
+    d["s%d" % i] = i
+    if i >= 10:
+        del d[i - 10]
+        del d["s%d" % (i - 10)]
+print(len(d), sorted(k for k in d if isinstance(k, int)))
+print(all(d["s%d" % i] == i for i in range(190, 200)))
+print(190 in d, 189 in d, "s189" in d)
+
+# remove keys in a different order to which they were added
+d = {}
+for i in range(50):
+    d[i] = -i
+for i in range(0, 50, 3):
+    del d[i]
+for i in range(49, 0, -4):
+    d.pop(i, None)
+print(len(d), sorted(d.items()) == sorted((k, -k) for k in d))
+for i in range(50):
+    d[i] = i
+print(len(d), sum(d.values()))
+
+# popitem until empty
+d = {i: str(i) for i in range(20)}
+items = []
+while d:
+    items.append(d.popitem())
+print(sorted(items) == [(i, str(i)) for i in range(20)])
+
+# instance members
+class A:
+    pass
+
+a = A()
+for i in range(30):
+    setattr(a, "x%d" % i, i)
+for i in range(0, 30, 2):
+    delattr(a, "x%d" % i)
+print(sorted(a.__dict__.items()) == sorted(("x%d" % i, i) for i in range(1, 30, 2)))
+
+# copies of a dict with deletions are independent
+d = {i: i for i in range(20)}
+del d[3]
+c = d.copy()
+del c[4]
+c[100] = 100
+print(4 in d, 100 in d, 4 in c, len(d), len(c))
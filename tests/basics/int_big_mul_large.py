@@ -0,0 +1,50 @@
+# test multiplication, squaring and string conversion of large ints, with
+# sizes around and above the point where faster algorithms may be used
+
+# deterministic pseudo-random big ints
+seed = 1
+
+
+def rand(bits):
+    global seed
+    r = 1
+    while bits > 0:
+        seed = (seed * 1103515245 + 12345) & 0x7FFFFFFF
+        r = r << 16 | seed >> 15
+        bits -= 16
+    return r
+
+
+def check(x):
+    # print a short summary of a big value
+    return len(hex(x)), x % 1000000007, x % 998244353
+
+
+for bits in (256, 512, 1000, 1024, 1100, 2048, 3000, 4096, 10000):
+    for bits2 in (bits, bits - 30, bits // 2, bits // 3 + 5, 100):
+        a = rand(bits)
+        b = rand(bits2)
+        print(bits, bits2, check(a * b), check(b * a), check(-a * b))
+        print(a * b == b * a, (a + 1) * b == a * b + b)
+    print(bits, check(a * a), a * a == a * (a + 0), (-a) * (-a) == a * a)
+
+# numbers with runs of zero and all-one digits
+for n in (1024, 2048, 5000):
+    a = (1 << n) - 1
+    b = 1 << (n // 2)
+    print(n, check(a * a), check(a * b), check(a * (a + b)), check((a * b + 1) * a))
+
+# pow and modular pow use repeated squaring
+print(check(7 ** 5000))
+m = (1 << 2048) - 159
+print(pow(rand(2048), (1 << 256) + 1, m) % 1000000007)
+
+# string conversion round trips
+for bits in (1000, 5000, 10000, 13500):
+    a = rand(bits)
+    s = str(a)
+    print(bits, len(s), s[:20], s[-20:], int(s) == a, int("-" + s) == -a)
+    print(int(hex(a), 16) == a, int(oct(a), 8) == a, int(bin(a), 2) == a)
+    print(int(s + "0") == a * 10, int("0" * 100 + s) == a)
+print("{:,}".format(123456789012345678901234567890))
+print("{:,}".format(-1234567890123456789012345678))
@@ -0,0 +1,33 @@
+# test binary ops and comparisons on small ints, including as loop and if
+# conditions, and results that overflow the small int range
+
+# comparisons used as values and as conditions
+for a in (-2, -1, 0, 1, 2):
+    for b in (-1, 0, 1):
+        print(a, b, a < b, a > b, a == b, a <= b, a >= b, a != b)
+        if a < b:
+            print("lt")
+        if not a >= b:
+            print("not ge")
+        if a == b or a > b:
+            print("eq or gt")
+
+# while loops with fused comparisons
+i = 0
+while i < 5:
+    i += 1
+print(i)
+while i != 0:
+    i -= 1
+print(i)
+
+# add and subtract crossing the small int boundary on 32- and 64-bit targets
+for n in (2**29, 2**30, 2**61, 2**62):
+    x = n - 1
+    print(x + 1, x + x, -x - 2, -x - x)
+    y = x
+    y += 1
+    print(y, y - 1 == x, y > x)
+
+# mixing small ints with other types
+print(1 < 1.5, 2 + 0.5, 3 - True, 1 == 1.0)
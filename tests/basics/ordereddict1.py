@@ -44,3 +44,11 @@ try:
     d.popitem()
 except:
     print('empty')
+
+# many deletions keep the remaining elements in order
+d = OrderedDict((i, i * i) for i in range(40))
+for i in range(0, 40, 3):
+    del d[i]
+d[0] = 0
+print(list(d.keys()))
+print(d[38], d[0], 3 in d)
@@ -0,0 +1,33 @@
+# tests str and bytes constant folding in compiler
+
+# str concatenation
+print("a" + "b")
+print("abc" + "" + "def" + "g")
+print("a" + "b" + "c" == "abc")
+
+# a result that is too long to be interned
+print("a very long string " + "that will not be interned " + "by the parser")
+
+# bytes concatenation
+print(b"a" + b"b")
+print(b"abc" + b"" + b"def")
+
+# concatenation mixed with other expressions
+x = "x"
+print("a" + "b" + x)
+print(x + "a" + "b")
+print(("a" + "b") * 2)
+
+# won't fold so an exception can be raised at runtime
+try:
+    "a" + b"b"
+except TypeError:
+    print("TypeError")
+try:
+    "a" + 1
+except TypeError:
+    print("TypeError")
+try:
+    -"a"
+except TypeError:
+    print("TypeError")
@@ -0,0 +1,25 @@
+# tests tuples made only of constants, which the compiler may load as a single object
+
+def f():
+    return (1, "a", b"b", None, True, False, ...)
+
+
+print(f())
+print(f() == f())
+print(())
+print((1,), (1, 2), (-1, 1 + 2, "a" + "b"))
+
+# nested tuples
+print(((1, 2), (3, (4, 5))))
+
+# tuples with items that aren't constants
+x = 2
+print((1, x), (x, 1), (1, (x,)))
+
+# use as a loop iterable and in unpacking
+for i in (1, 2, 3):
+    print(i)
+a, b = (4, 5)
+print(a, b)
+a, *b = (6, 7, 8)
+print(a, b)
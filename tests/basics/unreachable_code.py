@@ -0,0 +1,154 @@
+# tests code that follows a return, raise, break or continue, and jumps to jumps,
+# which the compiler may leave out or simplify
+
+
+def f1(x):
+    if x:
+        return 1
+    else:
+        return 2
+    print("unreachable")
+
+
+print(f1(0), f1(1))
+
+
+def f2(x):
+    while True:
+        if x:
+            return x
+        x += 1
+    return "unreachable"
+
+
+print(f2(0))
+
+
+def f3():
+    raise ValueError
+    print("unreachable")
+
+
+try:
+    f3()
+except ValueError:
+    print("ValueError")
+
+
+# unreachable code containing a loop and a nested function
+def f4():
+    return 4
+    for i in range(2):
+        print(i)
+
+    def g():
+        return 0
+
+    return g
+
+
+print(f4())
+
+
+# return and unwind jumps directly before the handler of a finally block
+def f5(x):
+    try:
+        if x:
+            return "try"
+    finally:
+        print("finally")
+    return "end"
+
+
+print(f5(0), f5(1))
+
+
+def f6():
+    for i in range(3):
+        try:
+            if i == 1:
+                continue
+            if i == 2:
+                break
+        finally:
+            print("finally", i)
+
+
+f6()
+
+
+class CM:
+    def __enter__(self):
+        print("enter")
+
+    def __exit__(self, a, b, c):
+        print("exit")
+
+
+def f7():
+    with CM():
+        return 7
+
+
+print(f7())
+
+
+def f8():
+    try:
+        with CM():
+            raise KeyError
+    except KeyError:
+        print("KeyError")
+        return 8
+    finally:
+        print("finally")
+
+
+print(f8())
+
+
+# nested conditionals and loops, where jumps go to other jumps
+def f9(n):
+    r = []
+    for i in range(n):
+        if i % 2:
+            if i % 3:
+                r.append(i)
+            else:
+                r.append(-i)
+        else:
+            while i > 4:
+                i -= 4
+                if i == 5:
+                    break
+            else:
+                r.append(i * 10)
+    return r
+
+
+print(f9(12))
+
+
+def f10(a, b):
+    while a:
+        if b:
+            a -= 1
+        else:
+            a -= 2
+    return a and b or (not a and 5)
+
+
+print(f10(4, 1), f10(4, 0), f10(0, 1))
+
+
+# generator with return in a finally block
+def f11():
+    try:
+        yield 1
+        return
+        yield 2
+    finally:
+        print("finally")
+
+
+print(list(f11()))
@@ -11,7 +11,7 @@ def f():
 
     # constructing data
     a = 1
-    b = (1, 2)
+    b = (a, 2)
     c = [1, 2]
     d = {1, 2}
     e = {}
@@ -119,11 +119,11 @@ def f():
     #from sys import * # tested at module scope
 
     # raise
-    raise
-    raise 1
+    if a: raise
+    if a: raise 1
 
     # return
-    return
+    if a: return
     return 1
 
 # function with lots of locals
@@ -0,0 +1,170 @@
+# Test I2C.readfrom_mem_batch() using SoftI2C and a simulated memory device
+
+try:
+    try:
+        import umachine as machine
+    except ImportError:
+        import machine
+    machine.SoftI2C.readfrom_mem_batch
+except (ImportError, AttributeError):
+    print("SKIP")
+    raise SystemExit
+
+import array
+
+
+# An I2C memory device with 8-bit register addresses, driven by the SCL and
+# SDA lines of the bus.  Only the master changes SDA while SCL is high, and
+# the device only changes its SDA output while SCL is low.
+class Device:
+    def __init__(self, addr):
+        self.addr = addr
+        self.mem = bytearray(i * 3 & 0xFF for i in range(256))
+        self.scl = 1
+        self.sda_master = 1
+        self.sda_out = 1
+        self.state = "idle"
+
+    def sda(self):
+        return self.sda_master & self.sda_out
+
+    def set_scl(self, v):
+        if v == self.scl:
+            return
+        self.scl = v
+        if v:
+            self.scl_rise()
+        else:
+            self.scl_fall()
+
+    def set_sda(self, v):
+        if v == self.sda_master:
+            return
+        self.sda_master = v
+        if self.scl:
+            if v:
+                # stop condition
+                self.state = "idle"
+            else:
+                # (repeated) start condition
+                self.state = "addr"
+                self.bits = 0
+                self.val = 0
+                self.first = True
+
+    def scl_rise(self):
+        if self.state in ("addr", "write"):
+            self.val = self.val << 1 | self.sda()
+            self.bits += 1
+        elif self.state == "read_ack" and self.sda():
+            # master nack, stop sending
+            self.state = "idle"
+
+    def scl_fall(self):
+        if self.state in ("addr", "write") and self.bits == 8:
+            ack = self.received(self.val)
+            self.sda_out = 0 if ack else 1
+            self.state = "ack" if ack else "idle"
+        elif self.state == "ack":
+            self.sda_out = 1
+            if self.reading:
+                self.send_byte()
+            else:
+                self.state = "write"
+                self.bits = 0
+                self.val = 0
+        elif self.state == "read":
+            if self.bits < 8:
+                self.sda_out = self.byte >> (7 - self.bits) & 1
+                self.bits += 1
+            else:
+                self.sda_out = 1
+                self.state = "read_ack"
+        elif self.state == "read_ack":
+            self.send_byte()
+
+    def received(self, val):
+        if self.state == "addr":
+            if val >> 1 != self.addr:
+                return False
+            self.reading = val & 1
+            return True
+        if self.first:
+            self.ptr = val
+            self.first = False
+        else:
+            self.mem[self.ptr] = val
+            self.ptr = (self.ptr + 1) & 0xFF
+        return True
+
+    def send_byte(self):
+        self.byte = self.mem[self.ptr]
+        self.ptr = (self.ptr + 1) & 0xFF
+        self.sda_out = self.byte >> 7
+        self.bits = 1
+        self.state = "read"
+
+
+class SCL(machine.PinBase):
+    def __init__(self, dev):
+        self.dev = dev
+
+    def value(self, v=None):
+        if v is None:
+            return self.dev.scl
+        self.dev.set_scl(int(v))
+
+
+class SDA(machine.PinBase):
+    def __init__(self, dev):
+        self.dev = dev
+
+    def value(self, v=None):
+        if v is None:
+            return self.dev.sda()
+        self.dev.set_sda(int(v))
+
+
+dev = Device(0x42)
+i2c = machine.SoftI2C(scl=SCL(dev), sda=SDA(dev), freq=400000)
+
+# sanity check of the simulated device
+print(i2c.scan())
+print(i2c.readfrom_mem(0x42, 10, 3))
+
+# ops as a list of tuples
+buf = bytearray(8)
+print(i2c.readfrom_mem_batch([(0x42, 1, 2), (0x42, 100, 1), (0x42, 0xFE, 3)], buf), buf)
+
+# ops as a buffer of 16-bit values
+ops = array.array("H", [0x42, 20, 2, 0x42, 30, 2])
+buf = bytearray(4)
+print(i2c.readfrom_mem_batch(ops, buf), buf)
+
+# results are stored back to back, so a smaller buffer doesn't fit them
+try:
+    i2c.readfrom_mem_batch(ops, bytearray(3))
+except ValueError:
+    print("ValueError")
+
+# an empty batch reads nothing
+print(i2c.readfrom_mem_batch([], bytearray(0)))
+
+# badly formed operations
+for bad in ([(0x42, 1)], [0x42], 1):
+    try:
+        i2c.readfrom_mem_batch(bad, bytearray(4))
+    except (TypeError, ValueError) as er:
+        print(type(er).__name__)
+
+# buf must be writable
+try:
+    i2c.readfrom_mem_batch([(0x42, 1, 1)], b"x")
+except TypeError:
+    print("TypeError")
+
+# a device that doesn't respond
+try:
+    i2c.readfrom_mem_batch([(0x42, 1, 1), (0x43, 1, 1)], bytearray(2))
+except OSError as er:
+    print("OSError")
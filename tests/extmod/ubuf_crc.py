@@ -0,0 +1,22 @@
+# test ubuf crc16 and crc32
+
+try:
+    import ubuf
+except ImportError:
+    print("SKIP")
+    raise SystemExit
+
+# CRC-16/XMODEM, and CRC-16/CCITT-FALSE with an initial value of 0xffff
+print(hex(ubuf.crc16(b"123456789")))
+print(hex(ubuf.crc16(b"123456789", 0xFFFF)))
+print(hex(ubuf.crc16(b"")))
+print(hex(ubuf.crc16(bytes(range(256)))))
+print(hex(ubuf.crc16(b"56789", ubuf.crc16(b"1234"))))
+
+# CRC-32 as used by zlib
+print(hex(ubuf.crc32(b"The quick brown fox jumps over the lazy dog")))
+print(hex(ubuf.crc32(b"")))
+print(hex(ubuf.crc32(b"\xff" * 32)))
+print(hex(ubuf.crc32(bytes(range(256)) * 4)))
+print(hex(ubuf.crc32(b" over the lazy dog", ubuf.crc32(b"The quick brown fox jumps"))))
+print(hex(ubuf.crc32(memoryview(bytearray(range(64)))[5:50])))
@@ -0,0 +1,72 @@
+# test ubuf copy, fill, bitwise and byte-swap operations
+
+try:
+    import ubuf
+except ImportError:
+    print("SKIP")
+    raise SystemExit
+
+# copy, including unaligned lengths and offsets
+for n in (0, 1, 7, 8, 9, 33):
+    src = bytes(range(n))
+    dest = bytearray(n + 2)
+    ubuf.copy(dest, src)
+    print(n, dest)
+dest = bytearray(16)
+ubuf.copy(memoryview(dest)[3:], bytes(range(1, 14)))
+print(dest)
+
+# copy between overlapping buffers
+b = bytearray(range(16))
+ubuf.copy(memoryview(b)[2:], memoryview(b)[:14])
+print(b)
+
+try:
+    ubuf.copy(bytearray(2), b"abc")
+except ValueError:
+    print("ValueError")
+
+# fill
+b = bytearray(11)
+ubuf.fill(b, 0xA5)
+print(b)
+ubuf.fill(memoryview(b)[1:4], 0)
+print(b)
+
+# bitwise operations, in place on the first argument
+for n in (1, 5, 8, 17):
+    a = bytearray(range(0xF0, 0xF0 + n))
+    ubuf.xor(a, bytes(range(n)))
+    print(a)
+    ubuf.and_(a, b"\x3c" * n)
+    print(a)
+    ubuf.or_(a, b"\x81" * n)
+    print(a)
+
+# unaligned operands
+a = bytearray(b"\xff" * 12)
+ubuf.xor(memoryview(a)[1:10], memoryview(bytes(range(12)))[3:12])
+print(a)
+
+try:
+    ubuf.xor(bytearray(4), b"ab")
+except ValueError:
+    print("ValueError")
+
+# byte swaps
+b = bytearray(range(8))
+ubuf.bswap16(b)
+print(b)
+ubuf.bswap32(b)
+print(b)
+for f in (ubuf.bswap16, ubuf.bswap32):
+    try:
+        f(bytearray(3))
+    except ValueError:
+        print("ValueError")
+
+# popcount
+print(ubuf.popcount(b""))
+print(ubuf.popcount(b"\x01\x03\x07"))
+print(ubuf.popcount(bytes(range(256))))
+print(ubuf.popcount(memoryview(b"\xff" * 13)[1:]))
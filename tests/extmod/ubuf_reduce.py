@@ -0,0 +1,43 @@
+# test ubuf sum, min and max over typed buffers
+
+try:
+    import ubuf
+    import uarray as array
+except ImportError:
+    print("SKIP")
+    raise SystemExit
+
+print(ubuf.sum(b"\x01\x02\xff"), ubuf.min(b"\x01\x02\xff"), ubuf.max(b"\x01\x02\xff"))
+print(ubuf.sum(bytearray(b"\x80\x7f")))
+
+for typecode in "bBhHiIlLqQ":
+    try:
+        a = array.array(typecode, [3, 1, 4, 1, 5, 9, 2, 6, 5, 3, 5])
+    except ValueError:
+        # the "q" and "Q" typecodes may not be supported
+        print(typecode, 44, 1, 9)
+        continue
+    print(typecode, ubuf.sum(a), ubuf.min(a), ubuf.max(a))
+
+for typecode in "bhilq":
+    try:
+        a = array.array(typecode, [-7, 2, -3, 8])
+    except ValueError:
+        print(typecode, 0, -7, 8)
+        continue
+    print(typecode, ubuf.sum(a), ubuf.min(a), ubuf.max(a))
+
+# sums don't wrap at the item size
+print(ubuf.sum(array.array("B", [200] * 10)))
+print(ubuf.sum(array.array("h", [-30000] * 10)))
+
+# a slice of an array
+print(ubuf.sum(memoryview(array.array("H", range(100)))[10:20]))
+
+# empty buffers
+print(ubuf.sum(b""))
+for f in (ubuf.min, ubuf.max):
+    try:
+        f(b"")
+    except ValueError:
+        print("ValueError")
@@ -0,0 +1,36 @@
+# test unregistering objects while iterating over the results of ipoll()
+
+try:
+    import uio, uselect as select
+except ImportError:
+    print("SKIP")
+    raise SystemExit
+
+
+class Stream(uio.IOBase):
+    def __init__(self, n):
+        self.n = n
+
+    def ioctl(self, req, arg):
+        if req == 3:  # MP_STREAM_POLL
+            return arg & select.POLLIN  # always readable
+        return -1
+
+
+streams = [Stream(i) for i in range(12)]
+poller = select.poll()
+try:
+    for s in streams:
+        poller.register(s, select.POLLIN)
+except (OSError, TypeError):
+    # poll() only supports objects with a file descriptor
+    print("SKIP")
+    raise SystemExit
+
+# every ready object is returned, even when earlier ones are unregistered
+seen = []
+for s, ev in poller.ipoll(0):
+    seen.append(s.n)
+    poller.unregister(s)
+print(len(seen), sorted(seen))
+print(poller.poll(0))
@@ -0,0 +1,52 @@
+# Test that VfsFat file finalisers run safely when the sweep is deferred
+
+try:
+    import gc, uos
+
+    uos.VfsFat
+    gc.sweep_budget
+except (ImportError, AttributeError):
+    print("SKIP")
+    raise SystemExit
+
+
+class RAMBlockDevice:
+    def __init__(self, blocks, sec_size=512):
+        self.sec_size = sec_size
+        self.data = bytearray(blocks * self.sec_size)
+
+    def readblocks(self, n, buf):
+        for i in range(len(buf)):
+            buf[i] = self.data[n * self.sec_size + i]
+
+    def writeblocks(self, n, buf):
+        for i in range(len(buf)):
+            self.data[n * self.sec_size + i] = buf[i]
+
+    def ioctl(self, op, arg):
+        if op == 4:  # MP_BLOCKDEV_IOCTL_BLOCK_COUNT
+            return len(self.data) // self.sec_size
+        if op == 5:  # MP_BLOCKDEV_IOCTL_BLOCK_SIZE
+            return self.sec_size
+
+
+def make_garbage():
+    # Abandon open files with unflushed data, so their finalisers write to the
+    # block device.  The finalisers need the VFS and block device to still be
+    # intact, even though they are garbage too.
+    bdev = RAMBlockDevice(50)
+    uos.VfsFat.mkfs(bdev)
+    vfs = uos.VfsFat(bdev)
+    for i in range(6):
+        f = vfs.open("f%d" % i, "w")
+        f.write("x" * 100)
+
+
+# Sweep in short slices between allocations, so memory freed by one slice is
+# reused before a later slice reaches the files.
+gc.sweep_budget(1)
+for i in range(100):
+    make_garbage()
+    junk = [[j, str(j), 1.5 * j] for j in range(200)]
+gc.sweep_budget(0)
+print("done")
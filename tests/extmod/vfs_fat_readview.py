@@ -0,0 +1,96 @@
+# Test VfsFat file readview() on a RAM device
+
+try:
+    import uos, uctypes
+
+    uos.VfsFat
+except (ImportError, AttributeError):
+    print("SKIP")
+    raise SystemExit
+
+
+class RAMBlockDevice:
+    SEC_SIZE = 512
+
+    def __init__(self, blocks):
+        self.data = bytearray(blocks * self.SEC_SIZE)
+
+    def readblocks(self, n, buf):
+        for i in range(len(buf)):
+            buf[i] = self.data[n * self.SEC_SIZE + i]
+
+    def writeblocks(self, n, buf):
+        for i in range(len(buf)):
+            self.data[n * self.SEC_SIZE + i] = buf[i]
+
+    def ioctl(self, op, arg):
+        if op == 4:  # block count
+            return len(self.data) // self.SEC_SIZE
+        if op == 5:  # block size
+            return self.SEC_SIZE
+        if op == 7:  # block address, ignored because this device is written in Python
+            return uctypes.addressof(self.data) + arg * self.SEC_SIZE
+
+
+def show(f, *args):
+    try:
+        v = f.readview(*args)
+        print(type(v).__name__, len(v), bytes(v[:4]), f.tell())
+    except OSError as er:
+        print("OSError", f.tell())
+
+
+try:
+    bdev = RAMBlockDevice(80)
+except MemoryError:
+    print("SKIP")
+    raise SystemExit
+
+uos.VfsFat.mkfs(bdev)
+vfs = uos.VfsFat(bdev)
+
+data = bytes(range(256)) * 8
+
+# a contiguous file
+with vfs.open("contig", "wb") as f:
+    f.write(data)
+
+# two files with interleaved clusters
+fa = vfs.open("frag_a", "wb")
+fb = vfs.open("frag_b", "wb")
+for i in range(4):
+    fa.write(data[i * 512 : (i + 1) * 512])
+    fa.flush()
+    fb.write(b"x" * 512)
+    fb.flush()
+fa.close()
+fb.close()
+
+with vfs.open("contig", "rb") as f:
+    if not hasattr(f, "readview"):
+        print("SKIP")
+        raise SystemExit
+
+    v = f.readview(1000, True)
+    print(v == data[:1000])
+    show(f, 1000)
+    show(f)
+    show(f)
+
+with vfs.open("frag_a", "rb") as f:
+    # within a cluster
+    show(f, 100)
+    # crosses into a non-consecutive cluster
+    show(f, 1000)
+    v = f.readview(1000, True)
+    print(type(v).__name__, v == data[:1000], f.tell())
+
+# pending writes are synced before mapping
+with vfs.open("contig", "r+b") as f:
+    f.write(b"abcd")
+    f.seek(0)
+    show(f, 8)
+
+# write-only files cannot be viewed
+with vfs.open("contig", "ab") as f:
+    show(f)
@@ -0,0 +1,94 @@
+# Test VfsLittle file readview() on a RAM device
+
+try:
+    import uos, uctypes
+
+    uos.VfsLfs1
+    uos.VfsLfs2
+    uos.VfsLfs2.open
+except (ImportError, AttributeError):
+    print("SKIP")
+    raise SystemExit
+
+
+class RAMBlockDevice:
+    ERASE_BLOCK_SIZE = 1024
+
+    def __init__(self, blocks):
+        self.data = bytearray(blocks * self.ERASE_BLOCK_SIZE)
+
+    def readblocks(self, block, buf, off):
+        addr = block * self.ERASE_BLOCK_SIZE + off
+        for i in range(len(buf)):
+            buf[i] = self.data[addr + i]
+
+    def writeblocks(self, block, buf, off):
+        addr = block * self.ERASE_BLOCK_SIZE + off
+        for i in range(len(buf)):
+            self.data[addr + i] = buf[i]
+
+    def ioctl(self, op, arg):
+        if op == 4:  # block count
+            return len(self.data) // self.ERASE_BLOCK_SIZE
+        if op == 5:  # block size
+            return self.ERASE_BLOCK_SIZE
+        if op == 6:  # erase block
+            return 0
+        if op == 7:  # block address, ignored because this device is written in Python
+            return uctypes.addressof(self.data) + arg * self.ERASE_BLOCK_SIZE
+
+
+def show(f, *args):
+    try:
+        v = f.readview(*args)
+        print(type(v).__name__, len(v), bytes(v[:4]), f.tell())
+    except OSError as er:
+        print("OSError", f.tell())
+
+
+def test(bdev, vfs_class):
+    vfs_class.mkfs(bdev)
+    vfs = vfs_class(bdev)
+
+    data = bytes(range(256)) * 12
+    with vfs.open("big", "wb") as f:
+        f.write(data)
+    with vfs.open("small", "wb") as f:
+        f.write(b"tiny")
+
+    with vfs.open("big", "rb") as f:
+        if not hasattr(f, "readview"):
+            print("SKIP")
+            raise SystemExit
+
+        print("test", vfs_class)
+
+        # contiguous region within a block
+        v = f.readview(100, True)
+        show(f, 100)
+        print(v == data[:100])
+
+        # region that spans blocks
+        show(f, 2000)
+        show(f, 2000, True)
+
+        # after a seek, and to the end of the file
+        f.seek(len(data) - 10)
+        show(f)
+        show(f)
+
+    # small file may be stored inline in metadata
+    with vfs.open("small", "rb") as f:
+        show(f, -1, True)
+
+    # writes are flushed before mapping
+    with vfs.open("big", "r+b") as f:
+        f.write(b"abcd")
+        f.seek(0)
+        show(f, 8)
+
+
+# the device can't be accessed directly so data is always copied
+bdev = RAMBlockDevice(30)
+test(bdev, uos.VfsLfs1)
+test(bdev, uos.VfsLfs2)
@@ -0,0 +1,32 @@
+# tests float constant folding in compiler
+
+print(1.5 + 2)
+print(2 * 3.5)
+print(1 - 2.5)
+print(-1.5, +1.5, -(-1.5))
+print(1 / 2)
+print(7 // 2.0, 7 % 2.0)
+print(2.0 ** 3)
+print(1 + 2 * 3 / 4)
+
+# won't fold so an exception can be raised at runtime
+try:
+    1 / 0
+except ZeroDivisionError:
+    print("ZeroDivisionError")
+try:
+    1.0 // 0
+except ZeroDivisionError:
+    print("ZeroDivisionError")
+try:
+    1.5 % 0.0
+except ZeroDivisionError:
+    print("ZeroDivisionError")
+try:
+    0.0 ** -1
+except ZeroDivisionError:
+    print("ZeroDivisionError")
+try:
+    ~1.5
+except TypeError:
+    print("TypeError")
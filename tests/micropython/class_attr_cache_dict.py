@@ -0,0 +1,44 @@
+# test that lookups of class attributes see changes made directly to the class
+# dict, which in MicroPython is shared with the class body's locals() and with
+# the dict passed to type()
+
+import gc
+
+
+class A:
+    d = locals()
+
+    def f(self):
+        return 1
+
+
+a = A()
+print(a.f(), a.f())
+A.d["f"] = lambda self: 2
+gc.collect()
+print(a.f())
+del A.d["f"]
+print(hasattr(a, "f"))
+A.d.update({"f": lambda self: 3})
+print(a.f())
+A.d.clear()
+print(hasattr(a, "f"))
+
+# a class created from a dict that is changed afterwards
+d = {"f": lambda self: 4}
+B = type("B", (), d)
+b = B()
+print(b.f(), b.f())
+d["f"] = lambda self: 5
+gc.collect()
+print(b.f())
+d.setdefault("g", lambda self: 6)
+print(b.g())
+d.pop("g")
+print(hasattr(b, "g"))
+d.popitem()
+print(hasattr(b, "f"))
+
+# changes to a dict made with exec
+exec("def f(self):\n    return 7", {}, d)
+print(b.f())
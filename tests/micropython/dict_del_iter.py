@@ -0,0 +1,41 @@
+# test deleting entries of a dict while iterating over it
+# (CPython raises RuntimeError, MicroPython visits each remaining entry once)
+
+try:
+    from ucollections import OrderedDict
+except ImportError:
+    OrderedDict = None
+
+
+def test(d, n):
+    seen = []
+    for k in d:
+        seen.append(k)
+        if k % 2 == 0:
+            del d[k]
+    print(len(seen), sorted(seen) == list(range(n)), len(d), sorted(d))
+
+
+# small dict, and one big enough to be hashed
+for n in (6, 20):
+    test({i: i for i in range(n)}, n)
+
+# delete the last entry
+d = {i: i for i in range(5)}
+for k in d:
+    print(k)
+    if k == 4:
+        del d[k]
+print(d)
+
+# adding after deletions reuses the space of the deleted entries
+d = {i: i for i in range(20)}
+for i in range(100):
+    del d[i]
+    d[i + 20] = i
+print(len(d), sorted(d) == list(range(100, 120)))
+
+if OrderedDict is not None:
+    d = OrderedDict((i, i) for i in range(20))
+    test(d, 20)
+    print(list(d.keys()))
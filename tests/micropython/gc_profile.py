@@ -0,0 +1,35 @@
+# test recording of allocation sites and collection pauses
+
+import gc
+
+try:
+    gc.profile
+except AttributeError:
+    print("SKIP")
+    raise SystemExit
+
+
+def f():
+    l = []
+    for i in range(10):
+        l.append(bytearray(100))
+    return l
+
+
+gc.profile(True)
+f()
+gc.collect()
+collections, mark_us, mark_max_us, sweep_us, sweep_max_us, sites, dropped = gc.profile()
+
+print(collections >= 1)
+print(mark_us >= mark_max_us >= 0, sweep_us >= sweep_max_us >= 0)
+
+# the bytearray allocations are attributed to their source line
+for file, name, line, count, nbytes in sites:
+    if name == "f" and nbytes >= 1000:
+        print(file.endswith("gc_profile.py"), line, count)
+
+# reset clears everything
+gc.profile(True)
+collections, mark_us, mark_max_us, sweep_us, sweep_max_us, sites, dropped = gc.profile()
+print(collections, mark_us, sweep_us, dropped)
@@ -0,0 +1,44 @@
+# test deferred sweeping of the heap in time-limited slices
+
+import gc
+
+try:
+    gc.sweep_budget
+except AttributeError:
+    print("SKIP")
+    raise SystemExit
+
+print(gc.sweep_budget())
+gc.sweep_budget(1)
+print(gc.sweep_budget())
+
+
+# live data that must survive collections while garbage is being created
+live = [[i, str(i), {"k": i}] for i in range(100)]
+
+# create lots of garbage, which runs automatic collections with deferred sweeps
+for n in range(20):
+    garbage = [bytearray(i % 50 + 1) for i in range(100)]
+    live.append([n, str(n) * 3])
+    s = ""
+    for i in range(50):
+        s += str(i)
+
+ok = True
+for i in range(100):
+    if live[i] != [i, str(i), {"k": i}]:
+        ok = False
+for n in range(20):
+    if live[100 + n] != [n, str(n) * 3]:
+        ok = False
+print(ok, len(live))
+
+# an explicit collection still frees memory immediately
+garbage = None
+gc.collect()
+free = gc.mem_free()
+gc.collect()
+print(gc.mem_free() == free)
+
+gc.sweep_budget(-1)
+print(gc.sweep_budget())
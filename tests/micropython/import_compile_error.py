@@ -0,0 +1,74 @@
+# test that a module which fails to compile doesn't leave its file open
+
+try:
+    import uerrno, usys, uio, uos
+
+    uio.IOBase
+    uos.mount
+except (ImportError, AttributeError):
+    print("SKIP")
+    raise SystemExit
+
+
+class UserFile(uio.IOBase):
+    def __init__(self, fs, data):
+        self.fs = fs
+        self.data = memoryview(data)
+        self.pos = 0
+
+    def readinto(self, buf):
+        n = min(len(buf), len(self.data) - self.pos)
+        buf[:n] = self.data[self.pos : self.pos + n]
+        self.pos += n
+        return n
+
+    def ioctl(self, req, arg):
+        if req == 4:  # MP_STREAM_CLOSE
+            self.fs.n_open -= 1
+        return 0
+
+
+class UserFS:
+    def __init__(self, files):
+        self.files = files
+        self.n_open = 0
+
+    def mount(self, readonly, mksfs):
+        pass
+
+    def umount(self):
+        pass
+
+    def stat(self, path):
+        if path in self.files:
+            return (32768, 0, 0, 0, 0, 0, 0, 0, 0, 0)
+        raise OSError(uerrno.ENOENT)
+
+    def open(self, path, mode):
+        self.n_open += 1
+        return UserFile(self, self.files[path])
+
+
+# the error is in the middle of the module, so with streaming compilation it is
+# raised after some statements have already been compiled
+stmts = "".join("x{} = [{}, {}]\n".format(i, i, i * 2) for i in range(200))
+src = stmts + "return\n" + stmts
+err = stmts + "x = (\n"
+
+fs = UserFS({"/mod.py": src.encode(), "/err.py": err.encode()})
+uos.mount(fs, "/userfs")
+usys.path.append("/userfs")
+
+for name in ("mod", "err"):
+    for i in range(20):
+        try:
+            __import__(name)
+        except SyntaxError:
+            pass
+        else:
+            print("no error")
+        usys.modules.pop(name, None)
+    print(name, fs.n_open)
+
+uos.umount("/userfs")
+usys.path.pop()
@@ -0,0 +1,196 @@
+# test lazy loading of functions from a .mpy file
+
+try:
+    import gc, uerrno, usys, uio, uos
+
+    uio.IOBase
+    uos.mount
+except (ImportError, AttributeError):
+    print("SKIP")
+    raise SystemExit
+
+# the .mpy file contains bytecode for this version and these features
+if usys.implementation.mpy & 0x3FF != 0x305:
+    print("SKIP")
+    raise SystemExit
+
+
+class UserFile(uio.IOBase):
+    def __init__(self, fs, data):
+        self.fs = fs
+        self.data = memoryview(data)
+        self.pos = 0
+
+    def readinto(self, buf):
+        n = min(len(buf), len(self.data) - self.pos)
+        buf[:n] = self.data[self.pos : self.pos + n]
+        self.pos += n
+        return n
+
+    def ioctl(self, req, arg):
+        if req == 4:  # MP_STREAM_CLOSE
+            self.fs.n_open -= 1
+        return 0
+
+
+class UserFS:
+    def __init__(self, files):
+        self.files = files
+        self.cwd = "/"
+        self.n_open = 0
+        self.opened = 0
+
+    def mount(self, readonly, mksfs):
+        pass
+
+    def umount(self):
+        pass
+
+    def chdir(self, path):
+        self.cwd = path
+
+    def getcwd(self):
+        return self.cwd
+
+    def abspath(self, path):
+        if not path.startswith("/"):
+            path = self.cwd.rstrip("/") + "/" + path
+        return path
+
+    def stat(self, path):
+        if self.abspath(path) in self.files:
+            return (32768, 0, 0, 0, 0, 0, 0, 0, 0, 0)
+        raise OSError(uerrno.ENOENT)
+
+    def open(self, path, mode):
+        path = self.abspath(path)
+        if path not in self.files:
+            raise OSError(uerrno.ENOENT)
+        self.n_open += 1
+        self.opened += 1
+        return UserFile(self, self.files[path])
+
+
+# Pre-compiled (with -mcache-lookup-bc) version of the following module, with
+# functions big enough that their bytecode is loaded when they are first called:
+#
+# def f(a, b=2, *args, c=3, **kw):
+#     s = "a function that is loaded when first called"
+#     r = [i * a for i in range(b)]
+#     r += [len(s), a + b + c, a * b * c, a - b - c, (a, b, c), -a, -b, -c]
+#     r += [a < b, b < c, a == c, a << b, b << c, a >> c, a | b | c, a & b & c]
+#     return s, a, b, args, c, kw, r
+#
+# def gen(n):
+#     for i in range(n):
+#         yield "a generator that is loaded when first called", i, i * i, -i, (i, n)
+#     yield "the generator finished", n, n * n, -n, (n, n), [n, n, n], {n: n}
+#     yield [n < n, n + n, n << n, n >> n, n | n, n & n, n ^ n, n % 7, n // 7]
+#
+# class C:
+#     def m(self, x):
+#         s = "a method that is loaded when first called"
+#         r = [x + 1, x + 2, x + 3, x << 1, x << 2, x << 3, x >> 1, x >> 2]
+#         return s, x, {x: [x, x * x, x * x * x, -x, (x, x), {x, x + 1}]}, f(x, 3), r
+#
+# def outer(n):
+#     def inner(x):
+#         s = "a closure that is loaded when first called"
+#         r = [x + 1, x + 2, x + 3, x << 1, x << 2, x << 3, x >> 1, x >> 2]
+#         return s, n, x, [n, x, n * x, n + x, n - x, -n, -x], {n: x}, r
+#
+#     return inner
+user_files = {
+    "/lazy.mpy": (
+        b"M\x05\x03\x1f \x81L\x18\x16\x00\x07\x0elazy.py\x8f\x08\x85\x07\x8b\x07\x00\x82*\x01"
+        b",\x00\x83\x10\x02cb3\x00\x16\x02f2\x01\x16\x06genT2\x02\x10\x02C4\x02\x16\x012\x03"
+        b"\x16\nouterQc\x00\x04\x84\x04\x82\x99\xc0\xc0@\x19\x07\x0b #.\x1f,\x1f(\x00\x00#"
+        b"\x03\xc5\xb0 \x04\x01\x12\x00|\x00\xb14\x014\x01\xc6\xb6\x12\x00k\x00\xb54\x01%\x00"
+        b"\xb1\xf2\xb2\xf2%\x00\xb1\xf4\xb2\xf4%\x00\xb1\xf3\xb2\xf3%\x00\xb1\xb2*\x03%\x00"
+        b"\xd1\xb1\xd1\xb2\xd1+\x08\xe5\xc6\xb6%\x00\xb1\xd7\xb1\xb2\xd7%\x00\xb2\xd9%\x00"
+        b"\xb1\xf0\xb1\xb2\xf0%\x00\xb2\xf1%\x00\xb1\xed\xb2\xed%\x00\xb1\xef\xb2\xef+\x08"
+        b"\xe5\xc6\xb5%\x00\xb1\xb3\xb2\xb4\xb6*\x07c\x01\x01\x02a\x02b\x0fs+a function th"
+        b"at is loaded when first calledhJ\x0c\x14<listcomp>\t@\x00+\x00\xb1_K\n\x00\xc2\xb2"
+        b"%\x00\xf4/\x14B\xf3\x7fc\x00\x00\x00\x05\x00\x05\x83$\xd9@\x14\x11\x03\x80\t'::\x00"
+        b"\xb0\x80B\x14\x80W\xc1#\x01\xb1\xb1\xb1\xf4\xb1\xd1\xb1\xb0*\x02*\x05gY\x81\xe5X"
+        b"Z\xd7C\xe6\x7fYY#\x02\xb0\xb0\xb0\xf4\xb0\xd1\xb0\xb0*\x02\xb0\xb0\xb0+\x03,\x01"
+        b"\xb0\xb0b*\x07gY\xb0\xb0\xd7\xb0\xb0\xf2\xb0\xb0\xf0\xb0\xb0\xf1\xb0\xb0\xed\xb0"
+        b"\xb0\xef\xb0\xb0\xee\xb0\x87\xf8\xb0\x87\xf6+\tgYQc\x02\x00\x02ns,a generator th"
+        b"at is loaded when first calleds\x16the generator finishedt\x00\x0e\x13\x05\x8d\x10"
+        b"\x00\x11\x00\x17\x00\x16\x00\x16\x10\x03\x16\x00\x1a2\x00\x16\x02mQc\x00\x01\x82"
+        b"Hr\x12\x01\x05\x80\x11#;\x00#\x02\xc2\xb1\x81\xf2\xb1\x82\xf2\xb1\x83\xf2\xb1\x81"
+        b"\xf0\xb1\x82\xf0\xb1\x83\xf0\xb1\x81\xf1\xb1\x82\xf1+\x08\xc3\xb2\xb1,\x01\xb1\xb1"
+        b"\xb1\xf4\xb1\xb1\xf4\xb1\xf4\xb1\xd1\xb1\xb1*\x02\xb1\xb1\x81\xf2-\x02+\x06\xb1b"
+        b"\x12\x13\x00\xb1\x834\x02\xb3*\x05c\x01\x00\x00\x89\x02xs)a method that is loade"
+        b"d when first calledL\x11\x13\x17\x07\x80\x17e@\x00\x00\xb0 \x01\x01\xc1\xb1c\x00"
+        b"\x01\r\x824j\x12\ninner\x05\x80\x18#;\x00#\x02\xc2\xb1\x81\xf2\xb1\x82\xf2\xb1\x83"
+        b"\xf2\xb1\x81\xf0\xb1\x82\xf0\xb1\x83\xf0\xb1\x81\xf1\xb1\x82\xf1+\x08\xc3\xb2%\x00"
+        b"\xb1%\x00\xb1%\x00\xb1\xf4%\x00\xb1\xf2%\x00\xb1\xf3%\x00\xd1\xb1\xd1+\x07,\x01\xb1"
+        b"%\x00b\xb3*\x06c\x01\x00\x00\x05\ts*a closure that is loaded when first called"
+    )
+}
+
+# create and mount a user filesystem
+fs = UserFS(user_files)
+uos.mount(fs, "/userfs")
+usys.path.append("/userfs")
+
+import lazy
+
+# the file is opened again when a function is first called, unless this port
+# loads everything at import
+opened = fs.opened
+lazy.f(0)
+if fs.opened == opened:
+    print("SKIP")
+    raise SystemExit
+
+print(lazy.f.__name__, lazy.gen.__name__, lazy.C.m.__name__)
+print(lazy.f(1))
+print(lazy.f(1, 2, 3, 4, c=5, d=6))
+print(list(lazy.gen(3)))
+print(lazy.C().m(4))
+print(lazy.outer(5)(6))
+
+# functions keep working when the module is gone
+f = lazy.f
+g = lazy.gen(2)
+del usys.modules["lazy"], lazy
+gc.collect()
+print(f(2))
+print(list(g))
+
+# functions are loaded from the same file after changing the current directory,
+# even when the module was imported by a relative path
+cwd = uos.getcwd()
+uos.chdir("/userfs")
+usys.path.insert(0, "")
+import lazy
+
+usys.path.pop(0)
+uos.chdir(cwd)
+print(lazy.f(3)[1:3])
+
+# a function can't be loaded once its file has gone
+data = user_files.pop("/lazy.mpy")
+try:
+    lazy.gen(2)
+except OSError as er:
+    print("OSError", er.errno == uerrno.ENOENT)
+
+# nor once it has changed in the file, even if its length is the same
+user_files["/lazy.mpy"] = data.replace(b"a generator", b"A generator")
+try:
+    lazy.gen(2)
+except ValueError:
+    print("ValueError")
+
+# functions that are already loaded keep working
+print(lazy.f(4)[1:3])
+
+# no file was left open
+print(fs.n_open)
+
+# unmount and undo path addition
+uos.umount("/userfs")
+usys.path.pop()
@@ -0,0 +1,146 @@
+# test importing a .mpy file with both native and bytecode functions, as made by
+# mpy-cross when some functions can't be compiled natively (x64 only)
+
+try:
+    import usys, uio, uos
+
+    uio.IOBase
+    uos.mount
+except (ImportError, AttributeError):
+    print("SKIP")
+    raise SystemExit
+
+if not (usys.platform == "linux" and usys.maxsize > 2 ** 32):
+    print("SKIP")
+    raise SystemExit
+
+
+class UserFile(uio.IOBase):
+    def __init__(self, data):
+        self.data = memoryview(data)
+        self.pos = 0
+
+    def readinto(self, buf):
+        n = min(len(buf), len(self.data) - self.pos)
+        buf[:n] = self.data[self.pos : self.pos + n]
+        self.pos += n
+        return n
+
+    def ioctl(self, req, arg):
+        return 0
+
+
+class UserFS:
+    def __init__(self, files):
+        self.files = files
+
+    def mount(self, readonly, mksfs):
+        pass
+
+    def umount(self):
+        pass
+
+    def stat(self, path):
+        if path in self.files:
+            return (32768, 0, 0, 0, 0, 0, 0, 0, 0, 0)
+        raise OSError
+
+    def open(self, path, mode):
+        return UserFile(self.files[path])
+
+
+# Version of the following module compiled with:
+#
+#     mpy-cross -march=x64 -mcache-lookup-bc -X emit=native-fallback fallback.py
+#
+# The native emitter doesn't support a bare raise, so reraise() is compiled to
+# bytecode and add() and gen() are compiled to native code.
+#
+# def add(a, b):
+#     return a + b
+#
+#
+# def reraise(a, b):
+#     try:
+#         return add(a, 0) // b
+#     except ZeroDivisionError:
+#         raise
+#
+#
+# def gen(n):
+#     for i in range(n):
+#         yield reraise(i + n, n - i)
+# fmt: off
+user_files = {
+    "/fallback.mpy": (
+        b"M\x05\x0b\x1f \x8a}USATAUAVAWH\x81\xec\x98\x00\x00\x00L\x8bo\x18I\x8bm\x00H\x89|"
+        b"$h\xbfY\x01\x00\x00H\x89|$p\xbf\x01\x00\x00\x00H\x89\xbc$\x80\x00\x00\x00H\x8d|$"
+        b"hH\x8b\x85h\x01\x00\x00\xff\xd0H\x8b|$hH\x8b\x7f\x08H\x8bE(\xff\xd0H\x89D$pH\x85"
+        b"\xc0\x0f\x84-\x00\x00\x00H\x89\xe7H\x8b\x85\x00\x01\x00\x00\xff\xd0\x84\xc0\x0f"
+        b"\x84\x19\x00\x00\x00H\x8b|$pH\x8bE(\xff\xd0H\x8b|$\x08H\x8b\x85\x10\x01\x00\x00"
+        b"\xff\xd0\xbe\x00\x00\x00\x00\xba\x00\x00\x00\x00H\x8bD$hH\x8b@\x18H\x8bx\x08H"
+        b"\x8b\x85\xd0\x00\x00\x00\xff\xd0H\x89\xc6\xbf\xcd\x00\x00\x00H\x8bE`\xff\xd0\xbe"
+        b"\x00\x00\x00\x00\xba\x00\x00\x00\x00H\x8bD$hH\x8b@\x18H\x8bx\x10H\x8b\x85\xd0"
+        b"\x00\x00\x00\xff\xd0H\x89\xc6\xbfW\x01\x00\x00H\x8bE`\xff\xd0\xbe\x00\x00\x00"
+        b"\x00\xba\x00\x00\x00\x00H\x8bD$hH\x8b@\x18H\x8bx\x18H\x8b\x85\xd0\x00\x00\x00"
+        b"\xff\xd0H\x89\xc6\xbfX\x01\x00\x00H\x8bE`\xff\xd0H\x8bE\x00H\x89D$8\xe9\x00\x00"
+        b"\x00\x00H\x8b|$pH\x85\xff\x0f\x84\x0f\x00\x00\x00H\x8bE(\xff\xd0H\x8b\x85\x08"
+        b"\x01\x00\x00\xff\xd0H\x8bD$8H\x81\xech\xff\xff\xffA_A^A]A\\[]\xc3\x00\x08\x07"
+        b"\x00U\x01\x03\x85E\x06add\x86}\x0ereraise\x885\x06gen\x82Y\x00\x07\x16fallback.p"
+        b"y\x00\x03\x83IUSATAUAVAWH\x83\xecHL\x8bo\x18I\x8bm\x10H\x89<$\xbfl\x00\x00\x00H"
+        b"\x89|$\x08\xbf\x04\x00\x00\x00H\x89|$\x18H\x89\xe7H\x8b\x85h\x01\x00\x00\xff\xd0"
+        b"H\x8b\\$@L\x8bd$8L\x89\xe2H\x89\xde\xbf\x1b\x00\x00\x00H\x8b\x85\x90\x00\x00\x00"
+        b"\xff\xd0\xe9\x00\x00\x00\x00H\x83\xec\xb8A_A^A]A\\[]\xc3\x1a\x08\xcd\x00U\x01"
+        b"\x00l\x07\x03\x00\x00\x02a\x02b\x81\x1c>\x12\x0b\x07`@#U\x00H\x0b\x00\x12\t\x00"
+        b"\xb0\x804\x02\xb1\xf6cW\x12\x008\x00\xdfD\x02\x80Yd]Qc\x00\x00\t\t\x8ey\xd7\x01"
+        b"\x00\x00\x00\x00\x00\x00i\x00\x00\x00\x00\x00\x00\x00USATAUAVAWH\x83\xechI\x89"
+        b"\xfdH\x89t$\x08I\x8bE\x00H\x8b@\x18H\x8bh\x08H\x89\xe7H\x8b\x85\x00\x01\x00\x00"
+        b"\xff\xd0\x84\xc0\x0f\x84\x1d\x00\x00\x00H\x8bD$\x08I\x89E(\xb8\x02\x00\x00\x00H"
+        b"\x83\xec\x98A_A^A]A\\[]\xc3I\x8bE\x08\xff\xe0H\x8b|$\x08H\x8b\x85\x10\x01\x00"
+        b"\x00\xff\xd0I\x8bE`I\x89E(\xb8\x01\x00\x00\x00I\x89E0\xe9\xd2\x00\x00\x00I\x8bE0"
+        b"I\x89E0I\x89EX\xbfW\x01\x00\x00H\x8bE8\xff\xd0I\x89E8I\x8bEXI\x89E@I\x8bE`H\x89"
+        b"\xc2I\x8bu@\xbf\x1b\x00\x00\x00H\x8b\x85\x90\x00\x00\x00\xff\xd0I\x89E@I\x8bE`I"
+        b"\x89EHI\x8bEXH\x89\xc2I\x8buH\xbf\x1c\x00\x00\x00H\x8b\x85\x90\x00\x00\x00\xff"
+        b"\xd0I\x89EH\xba@\x00\x00\x00L\x01\xeaI\x8b}8\xbe\x02\x00\x00\x00H\x8b\x85\xd8"
+        b"\x00\x00\x00\xff\xd0I\x89E8\xb88\x00\x00\x00L\x01\xe8I\x89E\x10\xb8\x01\x00\x00"
+        b"\x00H\x89D$8H\x8d\x05\t\x00\x00\x00I\x89E\x08\xe9\x84\x00\x00\x00H\x8b|$\x08H"
+        b"\x8b\x85\x10\x01\x00\x00\xff\xd0\xba\x03\x00\x00\x00I\x8bu0\xbf\x0e\x00\x00\x00H"
+        b"\x8b\x85\x90\x00\x00\x00\xff\xd0I\x89E0I\x8bE0I\x8b}(I\x89E0I\x89}(H\x89\xfaH"
+        b"\x89\xc6\xbf\x00\x00\x00\x00H\x8b\x85\x90\x00\x00\x00\xff\xd0H\x89\xc7H\x8b\x85"
+        b"\x80\x00\x00\x00\xff\xd0\x84\xc0\x0f\x85\xf6\xfe\xff\xffH\x8bE\x00I\x89E(\xb8("
+        b"\x00\x00\x00L\x01\xe8I\x89E\x10\xb8\x00\x00\x00\x00H\x89D$8\xe9\x00\x00\x00\x00H"
+        b"\x8b\x85\x08\x01\x00\x00\xff\xd0H\x8bD$8H\x83\xec\x98A_A^A]A\\[]\xc3\xb9@\x08X"
+        b"\x01U\x01\x01\x84i\t\x83W\x0b\x0b\x00\x00\x02n"
+    )
+}
+# fmt: on
+
+# create and mount a user filesystem
+uos.mount(UserFS(user_files), "/userfs")
+usys.path.append("/userfs")
+
+import fallback
+
+# native and bytecode functions can call each other
+print(fallback.add(1, 2))
+print(fallback.reraise(7, 2))
+print(list(fallback.gen(3)))
+
+
+# native functions don't add an entry to the traceback of an exception
+def show_native(name, *args):
+    try:
+        list(getattr(fallback, name)(*args))
+    except Exception as er:
+        buf = uio.StringIO()
+        usys.print_exception(er, buf)
+        print(type(er).__name__, name, "in " + name + "\n" not in buf.getvalue())
+
+
+show_native("add", 1, None)
+show_native("reraise", 1, 0)
+show_native("gen", None)
+
+# unmount and undo path addition
+uos.umount("/userfs")
+usys.path.pop()
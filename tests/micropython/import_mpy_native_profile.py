@@ -0,0 +1,124 @@
+# test importing a .mpy file where a profile selected the functions that were
+# compiled to native code (x64 only)
+
+try:
+    import usys, uio, uos
+
+    uio.IOBase
+    uos.mount
+except (ImportError, AttributeError):
+    print("SKIP")
+    raise SystemExit
+
+if not (usys.platform == "linux" and usys.maxsize > 2 ** 32):
+    print("SKIP")
+    raise SystemExit
+
+
+class UserFile(uio.IOBase):
+    def __init__(self, data):
+        self.data = memoryview(data)
+        self.pos = 0
+
+    def readinto(self, buf):
+        n = min(len(buf), len(self.data) - self.pos)
+        buf[:n] = self.data[self.pos : self.pos + n]
+        self.pos += n
+        return n
+
+    def ioctl(self, req, arg):
+        return 0
+
+
+class UserFS:
+    def __init__(self, files):
+        self.files = files
+
+    def mount(self, readonly, mksfs):
+        pass
+
+    def umount(self):
+        pass
+
+    def stat(self, path):
+        if path in self.files:
+            return (32768, 0, 0, 0, 0, 0, 0, 0, 0, 0)
+        raise OSError
+
+    def open(self, path, mode):
+        return UserFile(self.files[path])
+
+
+# Version of the following module compiled with:
+#
+#     mpy-cross -march=x64 -mcache-lookup-bc -X native-profile=profile.txt profiled.py
+#
+# where profile.txt was made by tools/mpy-profile.py from a program that called
+# hot() much more often than cold():
+#
+#     # calls self_us line name file
+#     205 42580 1 hot profiled.py
+#     1 1406 1 <module> main.py
+#     1 25 9 <listcomp> profiled.py
+#     1 11 8 cold profiled.py
+#     1 4 1 <module> profiled.py
+#
+# Only hot() is compiled to native code, cold() and the list comprehension in it
+# are compiled to bytecode.
+#
+# def hot(n):
+#     s = 0
+#     for i in range(n):
+#         s += i * i
+#     return s
+#
+#
+# def cold(n):
+#     return [hot(i) for i in range(n)]
+# fmt: off
+user_files = {
+    "/profiled.mpy": (
+        b"M\x05\x0b\x1f T\x00\x0e\x00\x07\x16profiled.py\x85\x07\x002\x00\x16\x06hot2\x01"
+        b"\x16\x08coldQc\x00\x02\x88aUSATAUAVAWH\x83\xechL\x8bo\x18I\x8bm\x08H\x89<$\xbf"
+        b"\x12\x01\x00\x00H\x89|$\x08\xbf\x08\x00\x00\x00H\x89|$\x18H\x89\xe7H\x8b\x85h"
+        b"\x01\x00\x00\xff\xd0H\x8b\\$PL\x8bd$XL\x8bl$`A\xbc\x01\x00\x00\x00L\x89l$(\xb8"
+        b"\x01\x00\x00\x00H\x89D$0\xe9\\\x00\x00\x00H\x8bD$0H\x89\xc3H\x89\xdaH\x89\xdeH"
+        b"\x89D$0L\x89d$8\xbf\x1d\x00\x00\x00H\x8b\x85\x90\x00\x00\x00\xff\xd0H\x89\xc2H"
+        b"\x8bt$8\xbf\x0e\x00\x00\x00H\x8b\x85\x90\x00\x00\x00\xff\xd0I\x89\xc4\xba\x03"
+        b"\x00\x00\x00H\x8bt$0\xbf\x0e\x00\x00\x00H\x8b\x85\x90\x00\x00\x00\xff\xd0H\x89D$"
+        b"0H\x8bD$0H\x8b|$(H\x89D$0H\x89|$(H\x89\xfaH\x89\xc6\xbf\x00\x00\x00\x00H\x8b\x85"
+        b"\x90\x00\x00\x00\xff\xd0H\x89\xc7H\x8b\x85\x80\x00\x00\x00\xff\xd0\x84\xc0\x0f"
+        b"\x85h\xff\xff\xffL\x89\xe0\xe9\x00\x00\x00\x00H\x83\xec\x98A_A^A]A\\[]\xc39\x08V"
+        b"\x01U\x01\x00\x82\x12\x03\x05\x00\x00\x02nT\x19\x0e\x07\x05\x80\x08\x002\x01\x12"
+        b"\x00|\x00\xb04\x014\x01c\x00\x01\x05xA\x0e\x14<listcomp>\x05\x80\x08\x00+\x00"
+        b"\xb0_K\r\x00\xc1\x12\t\x00\xb14\x01/\x14B\xf0\x7fc\x00\x00\x00\x05"
+    )
+}
+# fmt: on
+
+# create and mount a user filesystem
+uos.mount(UserFS(user_files), "/userfs")
+usys.path.append("/userfs")
+
+import profiled
+
+print(profiled.hot(10))
+print(profiled.cold(5))
+
+
+# native functions don't add an entry to the traceback of an exception
+def show_native(name, *args):
+    try:
+        getattr(profiled, name)(*args)
+    except Exception as er:
+        buf = uio.StringIO()
+        usys.print_exception(er, buf)
+        print(type(er).__name__, name, "in " + name + "\n" not in buf.getvalue())
+
+
+show_native("hot", None)
+show_native("cold", None)
+
+# unmount and undo path addition
+uos.umount("/userfs")
+usys.path.pop()
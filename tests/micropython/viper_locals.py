@@ -0,0 +1,84 @@
+# test viper functions where the locals used in loops are held in registers
+
+
+# many locals, with the ones used in the loop declared last
+@micropython.viper
+def f1(n: int) -> int:
+    a = 1
+    b = 2
+    c = 3
+    d = 4
+    e = 5
+    s = 0
+    i = 0
+    while i < n:
+        s += i * i
+        i += 1
+    return a + b + c + d + e + s
+
+
+print(f1(10))
+
+
+# loop over a buffer with the pointer and index held in registers
+@micropython.viper
+def f2(src: ptr8, s: int, i: int) -> int:
+    s = 0
+    for i in range(4):
+        s += src[i]
+    return s
+
+
+print(f2(b"1234", 0, 0))
+
+
+# as above but with a pointer argument that isn't among the first args
+@micropython.viper
+def f3(a: int, b: int, c: int, d: int, src: ptr16, n: int) -> int:
+    s = 0
+    for i in range(n):
+        s += src[i] + src[0]
+    return s + a + b + c + d
+
+
+print(f3(1, 2, 3, 4, b"\x01\x00\x02\x00\x03\x00", 3))
+
+
+# store to a buffer with the index held in a register
+@micropython.viper
+def f4(a: int, b: int, c: int, dest: ptr8, n: int):
+    for i in range(n):
+        dest[i] = dest[n - 1 - i] + a + b + c
+
+
+buf = bytearray(b"\x00\x01\x02\x03")
+f4(1, 2, 3, buf, 4)
+print(buf)
+
+
+# nested loops weigh the innermost locals most
+@micropython.viper
+def f5(n: int) -> int:
+    x = 0
+    y = 0
+    total = 0
+    for x in range(n):
+        w = x * 2
+        for y in range(n):
+            total += w + y
+    return total + x + y
+
+
+print(f5(5))
+
+
+# native function with arguments not held in registers
+@micropython.native
+def f6(a, b, c, d, e):
+    t = 0
+    for i in range(e):
+        t += i + e
+    return a + b + c + d + t
+
+
+print(f6(1, 2, 3, 4, 5))
@@ -0,0 +1,81 @@
+# test viper pointer loads and stores indexed by a loop variable
+
+import array
+
+
+@micropython.viper
+def xor8(dest: ptr8, src: ptr8, n: int, k: int):
+    for i in range(n):
+        dest[i] = src[i] ^ k
+
+
+@micropython.viper
+def xor16(dest: ptr16, src: ptr16, n: int, k: int):
+    for i in range(n):
+        dest[i] = src[i] ^ k
+
+
+@micropython.viper
+def xor32(dest: ptr32, src: ptr32, n: int, k: int):
+    for i in range(n):
+        dest[i] = src[i] ^ k
+
+
+src = bytearray(range(1, 9))
+dest = bytearray(8)
+xor8(dest, src, 8, 0x55)
+print(dest)
+
+src = array.array("H", [1, 2, 0x100, 0xFFFF])
+dest = array.array("H", [0] * 4)
+xor16(dest, src, 4, 0x1234)
+print(dest)
+
+src = array.array("I", [1, 2, 0x10000, 0x7FFFFFFF])
+dest = array.array("I", [0] * 4)
+xor32(dest, src, 4, 0x12345678)
+print([hex(x) for x in dest])
+
+
+# ranges with a start and step, and a checksum accumulated over the loop
+@micropython.viper
+def sum16(src: ptr16, start: int, stop: int) -> int:
+    s = 0
+    for i in range(start, stop):
+        s += src[i] * (i + 1)
+    for i in range(start, stop, 4):
+        s += src[i]
+    for i in range(stop - 1, start - 1, -3):
+        s ^= src[i]
+    return s
+
+
+buf = array.array("H", range(100, 120))
+print(sum16(buf, 0, 20), sum16(buf, 3, 17))
+
+
+# immediate indices, including ones too large for short encodings
+@micropython.viper
+def imm(p8: ptr8, p16: ptr16, p32: ptr32):
+    p8[40] = p8[1] + p8[33]
+    p16[40] = p16[1] + p16[33]
+    p32[40] = p32[1] + p32[33]
+
+
+b8 = bytearray(range(64))
+b16 = array.array("H", range(1000, 1064))
+b32 = array.array("I", range(100000, 100064))
+imm(b8, b16, b32)
+print(b8[40], b16[40], b32[40])
+
+
+# negative immediate index from an offset pointer
+@micropython.viper
+def neg(p: ptr32) -> int:
+    q = ptr32(uint(p) + 16)
+    q[-1] = q[-2] + q[-4]
+    return q[-1]
+
+
+b32 = array.array("I", [5, 6, 7, 8, 9])
+print(neg(b32), list(b32))
@@ -0,0 +1,35 @@
+# test sys.settrace on module-level code long enough to be compiled in pieces
+
+import sys
+
+try:
+    sys.settrace
+except AttributeError:
+    print("SKIP")
+    raise SystemExit
+
+# a module of many top-level statements
+src = "".join("x%d = %d\n" % (i, i) for i in range(200))
+src += "def f():\n    return x199\n"
+src += "y = f()\n"
+
+events = []
+
+
+def trace(frame, event, arg):
+    if frame.f_code.co_name in ("<module>", "f"):
+        events.append((frame.f_code.co_name, event, frame.f_lineno))
+        return trace
+    return None
+
+
+glb = {}
+sys.settrace(trace)
+exec(src, glb)
+sys.settrace(None)
+
+# the module runs as a single frame: one call, consecutive lines, one return
+print(glb["y"])
+print([e[:2] for e in events if e[1] != "line"])
+lines = [e[2] for e in events if e[0] == "<module>" and e[1] == "line"]
+print(len(lines), lines == list(range(1, 201)) + [201, 203])
@@ -0,0 +1,36 @@
+# Bulk buffer operations using the ubuf module (no truth check, CPython doesn't have it).
+
+import ubuf
+import uarray as array
+
+
+def test(n, size):
+    a = bytearray(size)
+    b = bytearray(bytes(range(256)) * (size // 256))
+    h = array.array("h", range(-size // 4, size // 4))
+    acc = 0
+    for _ in range(n):
+        ubuf.copy(a, b)
+        ubuf.xor(a, b)
+        ubuf.or_(a, b)
+        ubuf.bswap32(a)
+        acc += ubuf.popcount(a)
+        acc += ubuf.crc32(a) & 0xFF
+        acc += ubuf.crc16(b) & 0xFF
+        acc += ubuf.sum(h) + ubuf.max(h) - ubuf.min(h)
+    return acc
+
+
+###########################################################################
+# Benchmark interface
+
+bm_params = {
+    (50, 10): (2, 256),
+    (100, 10): (4, 512),
+    (1000, 10): (10, 4096),
+    (5000, 10): (40, 8192),
+}
+
+
+def bm_setup(params):
+    return lambda: test(*params), lambda: (params[0] * params[1] // 256, None)
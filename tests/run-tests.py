@@ -514,6 +514,7 @@ def run_tests(pyb, tests, args, result_dir, num_threads=1):
         skip_tests.add(
             "micropython/opt_level_lineno.py"
         )  # native doesn't have proper traceback info
+        skip_tests.add("micropython/gc_profile.py")  # native code doesn't record allocation sites
         skip_tests.add("micropython/schedule.py")  # native code doesn't check pending events
 
     def run_one_test(test_file):
@@ -0,0 +1,126 @@
+#!/usr/bin/env micropython
+#
+# This file is part of the MicroPython project, http://micropython.org/
+#
+# The MIT License (MIT)
+#
+# Copyright (c) 2026 agent
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+# THE SOFTWARE.
+
+# Record how often each function of a program is called and how much time is
+# spent in it, using sys.settrace.  The resulting profile can be passed to
+# mpy-cross with "-X native-profile=<file>" so that only the hot functions are
+# compiled to native code.
+#
+# This must be run by a MicroPython executable with sys.settrace enabled
+# (MICROPY_PY_SYS_SETTRACE, eg the unix port's dev variant):
+#
+#     micropython mpy-profile.py [-o profile.txt] script.py [args...]
+#
+# Each line of the profile has the following fields, separated by spaces, and
+# the lines are sorted with the most expensive function first:
+#
+#     <calls> <self time in us> <line of def> <function name> <file name>
+#
+# Self time excludes time spent in functions that were called from the given
+# function.  Resuming a generator counts as a call.
+
+import sys
+
+try:
+    from time import ticks_us, ticks_diff
+except ImportError:
+    from time import perf_counter
+
+    def ticks_us():
+        return int(perf_counter() * 1000000)
+
+    def ticks_diff(a, b):
+        return a - b
+
+
+class Profiler:
+    def __init__(self):
+        # maps (file, name, first line of code) to [line of def, calls, self time]
+        self.stats = {}
+        # active frames, each as [frame, stats entry, start time, time in callees]
+        self.stack = []
+
+    def trace(self, frame, event, arg):
+        if event == "call":
+            code = frame.f_code
+            key = (code.co_filename, code.co_name, code.co_firstlineno)
+            st = self.stats.get(key)
+            if st is None:
+                # the first call of a function (even a generator) starts at its def
+                st = self.stats[key] = [frame.f_lineno, 0, 0]
+            st[1] += 1
+            self.stack.append([frame, st, ticks_us(), 0])
+        elif event == "return":
+            t = ticks_us()
+            while self.stack:
+                f, st, t0, t_callees = self.stack.pop()
+                dt = ticks_diff(t, t0)
+                st[2] += dt - t_callees
+                if self.stack:
+                    self.stack[-1][3] += dt
+                if f is frame:
+                    break
+        return self.trace
+
+    def write(self, out):
+        print("# calls self_us line name file", file=out)
+        stats = sorted(self.stats.items(), key=lambda item: -item[1][2])
+        for (filename, name, _), (line, calls, us) in stats:
+            print(calls, us, line, name, filename, file=out)
+
+
+def main():
+    args = sys.argv[1:]
+    output = "profile.txt"
+    if len(args) >= 2 and args[0] == "-o":
+        output = args[1]
+        args = args[2:]
+    if not args or args[0].startswith("-"):
+        print("usage: mpy-profile.py [-o <profile>] <script.py> [args...]")
+        sys.exit(1)
+    script = args[0]
+
+    if not hasattr(sys, "settrace"):
+        print("mpy-profile.py: sys.settrace is not available")
+        sys.exit(1)
+
+    # run the script as the main program, importing from its directory
+    sys.argv[:] = args
+    sys.path[0] = script.rsplit("/", 1)[0] if "/" in script else ""
+    with open(script) as f:
+        code = compile(f.read(), script, "exec")
+
+    prof = Profiler()
+    sys.settrace(prof.trace)
+    try:
+        exec(code, {"__name__": "__main__", "__file__": script})
+    finally:
+        sys.settrace(None)
+        with open(output, "w") as f:
+            prof.write(f)
+
+
+main()